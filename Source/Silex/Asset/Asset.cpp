@@ -2,6 +2,8 @@
 #include "PCH.h"
 
 #include "Asset/Asset.h"
+#include "Core/Metrics.h"
+#include "Core/HitchDetector.h"
 #include "Core/Random.h"
 #include "Editor/EditorSplashImage.h"
 #include "Rendering/MeshFactory.h"
@@ -15,6 +17,22 @@
 
 namespace Silex
 {
+    // アセットマネージャーに追加されたアセット数（ビルトインを含む）
+    static MetricID assetLoadedMetric = Metrics::invalidMetric;
+
+    // ヒッチの記録時のみ、アセット ID から名前を引いて文字列にする
+    static std::string FormatAssetEvent(const char* label, uint64 id)
+    {
+        PoolHashMap<AssetID, Shared<Asset>>& assets = AssetManager::Get()->GetAllAssets();
+
+        auto itr = assets.find(id);
+        if (itr == assets.end())
+            return std::format("{}: ({})", label, id);
+
+        return std::format("{}: {} ({})", label, itr->second->GetName(), id);
+    }
+
+
     void Asset::SetupAssetProperties(const std::string& filePath, AssetType flag)
     {
         SetAssetType(flag);
@@ -76,6 +94,8 @@ namespace Silex
         SL_ASSERT(s_Instance == nullptr)
         s_Instance = Memory::Allocate<AssetManager>();
 
+        assetLoadedMetric = Metrics::RegisterCounter("Asset/Loaded");
+
         // ビルトインデータ(ID: 1 - 5 に割り当て)
         // アセットデータベースには登録されない（メモリオンリーアセット）
         {
@@ -170,12 +190,12 @@ namespace Silex
         return m_Metadata[id];
     }
 
-    std::unordered_map<AssetID, Shared<Asset>>& AssetManager::GetAllAssets()
+    PoolHashMap<AssetID, Shared<Asset>>& AssetManager::GetAllAssets()
     {
         return m_AssetData;
     }
 
-    std::unordered_map<AssetID, AssetMetadata>& AssetManager::GetMetadatas()
+    PoolHashMap<AssetID, AssetMetadata>& AssetManager::GetMetadatas()
     {
         return m_Metadata;
     }
@@ -257,11 +277,17 @@ namespace Silex
     {
         asset->SetAssetID(id);
         m_AssetData[id] = asset;
+
+        Metrics::Increment(assetLoadedMetric);
+        HitchDetector::AddEvent("Asset", id, FormatAssetEvent);
     }
 
     void AssetManager::AddToAsset(Shared<Asset> asset)
     {
         m_AssetData[asset->GetAssetID()] = asset;
+
+        Metrics::Increment(assetLoadedMetric);
+        HitchDetector::AddEvent("Asset", asset->GetAssetID(), FormatAssetEvent);
     }
 
     AssetMetadata AssetManager::AddToMetadata(const std::filesystem::path& directory)
@@ -333,17 +359,26 @@ namespace Silex
         INIT_PROCESS("Load Texture", 20);
 
         // テクスチャ2D: マテリアルから参照されるので、最初に読み込むこと!
-        for (auto& [ud, metadata] : m_Metadata)
+        // デコードはワーカースレッドで並行に行い、GL への転送のみメインスレッドで行う
         {
-            if (metadata.Type == AssetType::Texture2D)
+            PoolVector<AssetID>                 ids;
+            PoolVector<Task<Shared<Texture2D>>> tasks;
+
+            for (auto& [ud, metadata] : m_Metadata)
             {
-                AssetID id       = metadata.ID;
-                std::string path = metadata.FilePath.string();
+                if (metadata.Type == AssetType::Texture2D)
+                {
+                    ids.push_back(metadata.ID);
+                    tasks.push_back(AssetImporter::ImportAsync<Texture2D>(metadata.FilePath.string()));
+                }
+            }
 
-                Shared<Asset> asset = nullptr;
-                asset = LoadAssetFromFile<Texture2D>(path);
+            Task<void> loadTextures = WhenAll(tasks);
+            SyncWait(loadTextures);
 
-                s_Instance->AddToAssetAndID(id, asset);
+            for (uint64 i = 0; i < tasks.size(); i++)
+            {
+                s_Instance->AddToAssetAndID(ids[i], tasks[i].GetResult());
             }
         }
 
@@ -107,13 +107,13 @@ namespace Silex
         AssetMetadata GetMetadata(const std::filesystem::path& directory);
         AssetMetadata GetMetadata(AssetID id);
 
-        std::unordered_map<AssetID, AssetMetadata>& GetMetadatas();
+        PoolHashMap<AssetID, AssetMetadata>& GetMetadatas();
 
         //=================================
         // アセット
         //=================================
         bool IsLoaded(const AssetID id);
-        std::unordered_map<AssetID, Shared<Asset>>& GetAllAssets();
+        PoolHashMap<AssetID, Shared<Asset>>& GetAllAssets();
 
         template<class T>
         Shared<T> GetAssetAs(const AssetID id)
@@ -193,8 +193,8 @@ namespace Silex
 
         uint32 m_BuiltinAssetCount = 0;
 
-        std::unordered_map<AssetID, Shared<Asset>> m_AssetData;
-        std::unordered_map<AssetID, AssetMetadata> m_Metadata;
+        PoolHashMap<AssetID, Shared<Asset>> m_AssetData;
+        PoolHashMap<AssetID, AssetMetadata> m_Metadata;
 
         static inline const char* s_AssetDatabasePath = "Assets/AssetDatabase.yml";
         static inline const char* s_AssetDiectoryPath = "Assets";
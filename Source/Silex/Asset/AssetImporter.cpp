@@ -2,8 +2,10 @@
 #include "PCH.h"
 
 #include "Asset/AssetImporter.h"
+#include "Asset/TextureReader.h"
 #include "Serialize/AssetSerializer.h"
 #include "Rendering/Mesh.h"
+#include "Rendering/Renderer.h"
 #include "Rendering/SkyLight.h"
 #include "Rendering/Texture.h"
 #include "Core/Random.h"
@@ -21,20 +23,57 @@ namespace Silex
         return Shared<Mesh>(m);
     }
 
-    template<>
-    Shared<Texture2D> AssetImporter::Import<Texture2D>(const std::string& filePath)
+    static RHI::TextureDesc GetTexture2DImportDesc()
     {
         RHI::TextureDesc desc = {};
         desc.Filter    = RHI::TextureFilter::Linear;
         desc.Wrap      = RHI::TextureWrap::Repeat;
         desc.GenMipmap = true;
-        Shared<Texture2D> t = Texture2D::Create(desc, filePath);
+
+        return desc;
+    }
+
+    template<>
+    Shared<Texture2D> AssetImporter::Import<Texture2D>(const std::string& filePath)
+    {
+        Shared<Texture2D> t = Texture2D::Create(GetTexture2DImportDesc(), filePath);
 
         t->SetupAssetProperties(filePath, AssetType::Texture2D);
 
         return t;
     }
 
+    template<>
+    Task<Shared<Texture2D>> AssetImporter::ImportAsync<Texture2D>(std::string filePath, CancellationToken token)
+    {
+        // ファイル読み込み・デコード
+        co_await SwitchToWorker();
+
+        TextureReader reader;
+        reader.Read(filePath.c_str());
+
+        if (token.IsCancelled())
+            co_return nullptr;
+
+        // GL テクスチャの生成・転送（デコードしたデータはリーダーと共にフレーム内で保持される）
+        // レンダースレッドの起動中は、メインスレッドからレンダーキューを経由して GL スレッドで行う
+        co_await SwitchToMainThread("Texture2D Upload");
+
+        if (token.IsCancelled())
+            co_return nullptr;
+
+        co_await SwitchToRenderThread("Texture2D Upload");
+
+        Shared<Texture2D> t = Texture2D::Create(GetTexture2DImportDesc(), reader.Data);
+
+        // アセットの設定と結果の受け取りはメインスレッドで行う
+        co_await SwitchToMainThread("Texture2D Upload");
+
+        t->SetupAssetProperties(filePath, AssetType::Texture2D);
+
+        co_return t;
+    }
+
     template<>
     Shared<SkyLight> AssetImporter::Import<SkyLight>(const std::string& filePath)
     {
@@ -2,6 +2,7 @@
 #pragma once
 #include "Core/Core.h"
 #include "Core/SharedPointer.h"
+#include "Core/Coroutine.h"
 
 
 namespace Silex
@@ -12,5 +13,10 @@ namespace Silex
 
         template<class T>
         static Shared<T> Import(const std::string& filePath);
+
+        // 読み込み・デコードをワーカースレッド、GL への転送をメインスレッドで行う
+        // キャンセルされた場合は nullptr を返す
+        template<class T>
+        static Task<Shared<T>> ImportAsync(std::string filePath, CancellationToken token = {});
     };
 }
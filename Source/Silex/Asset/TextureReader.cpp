@@ -8,6 +8,27 @@
 
 namespace Silex
 {
+    // 上下の行を入れ替える
+    static void FlipVertically(byte* pixels, uint64 rowSize, uint32 height)
+    {
+        byte buffer[2048];
+
+        for (uint32 row = 0; row < height / 2; row++)
+        {
+            byte* top    = pixels + row * rowSize;
+            byte* bottom = pixels + (height - row - 1) * rowSize;
+
+            // 行が大きい場合に備えて、固定長のバッファで分割して入れ替える
+            for (uint64 offset = 0; offset < rowSize; offset += sizeof(buffer))
+            {
+                uint64 size = std::min<uint64>(sizeof(buffer), rowSize - offset);
+                std::memcpy(buffer,          top    + offset, size);
+                std::memcpy(top    + offset, bottom + offset, size);
+                std::memcpy(bottom + offset, buffer,          size);
+            }
+        }
+    }
+
     TextureReader::~TextureReader()
     {
         Unload(Data.Pixels);
@@ -15,8 +36,6 @@ namespace Silex
 
     byte* TextureReader::Read(const char* path, bool flipOnRead)
     {
-        stbi_set_flip_vertically_on_load(flipOnRead);
-
         int32 width, height, channels;
         byte* pixels = nullptr;
 
@@ -37,6 +56,14 @@ namespace Silex
 
         if (pixels)
         {
+            // stb_image の上下反転の設定はプロセス全体で共有されるので、ワーカースレッドから
+            // 並行に読み込むと他の読み込みに影響する。設定は使わずに、読み込み後に行を入れ替える
+            if (flipOnRead)
+            {
+                uint64 pixelSize = Data.IsHDR ? sizeof(float) * channels : channels;
+                FlipVertically(pixels, width * pixelSize, height);
+            }
+
             Data.Channels = channels;
             Data.Width    = width;
             Data.Height   = height;
@@ -6,6 +6,7 @@
 #include "Core/Hash.h"
 #include "Core/TypeInfo.h"
 #include "Core/Memory.h"
+#include "Core/MemoryResource.h"
 #include "Core/Delegate.h"
 #include "Core/Logger.h"
 #include "Core/Object.h"
@@ -1,6 +1,7 @@
 
 #pragma once
 #include <cstdint>
+#include <type_traits>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -52,7 +53,7 @@ namespace Silex
         template<class T> struct RemoveCV<volatile T>       { using Type = T; };
         template<class T> struct RemoveCV<const volatile T> { using Type = T; };
 
-        template<class From, class To>      struct Convertible : BoolConstant<__is_convertible_to(From, To)>{};
+        template<class From, class To>      struct Convertible : BoolConstant<std::is_convertible_v<From, To>>{};
         template<class Base, class Derived> struct BaseOf      : BoolConstant<__is_base_of(Base, Derived)>  {};
 
 
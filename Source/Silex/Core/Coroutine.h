@@ -0,0 +1,510 @@
+#pragma once
+#include "Core/CoreType.h"
+#include "Core/Memory.h"
+#include "Core/ThreadPool.h"
+#include "Core/MainThreadQueue.h"
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <span>
+#include <thread>
+
+
+//==================================================================
+// コルーチン
+//------------------------------------------------------------------
+// co_await SwitchToWorker()     : 以降の処理をワーカースレッドで再開する
+// co_await SwitchToMainThread() : 以降の処理をメインスレッド（GL コンテキストのスレッド）で再開する
+// co_await Foo()                : 子タスクを開始し、完了後に結果をムーブして受け取る
+// co_await task                 : 名前付きのタスクを開始し、完了後に結果を参照で受け取る（結果はタスクに残る）
+// co_await WhenAll(tasks)       : 全ての子タスクを並行に開始し、全て完了するまで待つ
+//
+// 例外は使用しない（コルーチン内で例外が発生した場合は終了する）
+//==================================================================
+namespace Silex
+{
+    //=========================================================================
+    // キャンセル
+    //-------------------------------------------------------------------------
+    // CancellationSource::Cancel で要求し、コルーチン側が任意の位置でトークンを確認して中断する
+    // ソースはトークンを渡したタスクが完了するまで破棄しないこと
+    //=========================================================================
+    class CancellationToken
+    {
+    public:
+
+        CancellationToken() = default;
+        explicit CancellationToken(const std::atomic<bool>* flag) : flag(flag) {}
+
+        bool IsCancelled() const
+        {
+            return flag && flag->load(std::memory_order_acquire);
+        }
+
+    private:
+
+        const std::atomic<bool>* flag = nullptr;
+    };
+
+    class CancellationSource
+    {
+    public:
+
+        CancellationSource() = default;
+
+        void              Cancel()            { cancelled.store(true, std::memory_order_release);  }
+        bool              IsCancelled() const { return cancelled.load(std::memory_order_acquire); }
+        CancellationToken GetToken()    const { return CancellationToken(&cancelled);             }
+
+    private:
+
+        std::atomic<bool> cancelled = false;
+
+    private:
+
+        CancellationSource(const CancellationSource&)            = delete;
+        CancellationSource& operator=(const CancellationSource&) = delete;
+    };
+
+
+    template<typename T = void>
+    class Task;
+
+    namespace Internal
+    {
+        //=========================================================================
+        // コルーチンフレームの確保
+        //-------------------------------------------------------------------------
+        // フレームは小さく頻繁に生成・破棄されるので、メモリプール（大きなものは TLSF ヒープ）から確保する
+        //=========================================================================
+        struct CoroutineFrameAllocator
+        {
+            static void* operator new(std::size_t size)
+            {
+                return Memory::AllocateBytes(size);
+            }
+
+            static void operator delete(void* ptr)
+            {
+                Memory::DeallocateBytes(ptr);
+            }
+        };
+
+        //=========================================================================
+        // Task のプロミス
+        //-------------------------------------------------------------------------
+        // 生成時は中断状態で、co_await された時点で開始する（遅延開始）
+        // 完了時は待機しているコルーチンを対称転送で再開する
+        //=========================================================================
+        class TaskPromiseBase : public CoroutineFrameAllocator
+        {
+        public:
+
+            struct FinalAwaiter
+            {
+                bool await_ready() const noexcept { return false; }
+
+                template<typename Promise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+                {
+                    std::coroutine_handle<> continuation = handle.promise().GetContinuation();
+                    return continuation ? continuation : std::noop_coroutine();
+                }
+
+                void await_resume() const noexcept {}
+            };
+
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            FinalAwaiter        final_suspend()   const noexcept { return {}; }
+
+            void unhandled_exception() const noexcept
+            {
+                std::terminate();
+            }
+
+            void SetContinuation(std::coroutine_handle<> handle)
+            {
+                continuation = handle;
+            }
+
+            std::coroutine_handle<> GetContinuation() const
+            {
+                return continuation;
+            }
+
+        private:
+
+            std::coroutine_handle<> continuation;
+        };
+
+        template<typename T>
+        class TaskPromise : public TaskPromiseBase
+        {
+        public:
+
+            Task<T> get_return_object();
+
+            template<typename U>
+            void return_value(U&& value)
+            {
+                result.emplace(Traits::Forward<U>(value));
+            }
+
+            T& GetResult()
+            {
+                return *result;
+            }
+
+        private:
+
+            std::optional<T> result;
+        };
+
+        template<>
+        class TaskPromise<void> : public TaskPromiseBase
+        {
+        public:
+
+            Task<void> get_return_object();
+
+            void return_void() const {}
+            void GetResult()   const {}
+        };
+
+        //=========================================================================
+        // 完了を待たれないコルーチン（開始と同時に実行し、完了時にフレームを破棄する）
+        //=========================================================================
+        struct DetachedTask
+        {
+            struct promise_type : public CoroutineFrameAllocator
+            {
+                DetachedTask       get_return_object()   const noexcept { return {}; }
+                std::suspend_never initial_suspend()     const noexcept { return {}; }
+                std::suspend_never final_suspend()       const noexcept { return {}; }
+                void               return_void()         const noexcept {}
+                void               unhandled_exception() const noexcept { std::terminate(); }
+            };
+        };
+
+        // 子タスクを開始し、完了後に戻る（結果は受け取らず、タスク側に残す）
+        template<typename T>
+        struct TaskStarter
+        {
+            std::coroutine_handle<TaskPromise<T>> handle;
+
+            bool await_ready() const noexcept
+            {
+                return !handle || handle.done();
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+            {
+                handle.promise().SetContinuation(awaiting);
+                return handle;
+            }
+
+            void await_resume() const noexcept {}
+        };
+    }
+
+
+    //=========================================================================
+    // コルーチンタスク
+    //-------------------------------------------------------------------------
+    // co_await で開始し、完了すると結果を返す。ムーブのみ可能で、破棄時にフレームも破棄する
+    // 開始したタスクは、完了するまで破棄しないこと
+    //=========================================================================
+    template<typename T>
+    class Task
+    {
+    public:
+
+        using promise_type = Internal::TaskPromise<T>;
+        using Handle       = std::coroutine_handle<promise_type>;
+
+        Task() = default;
+        explicit Task(Handle handle) : handle(handle) {}
+
+        Task(Task&& other) noexcept
+            : handle(other.handle)
+        {
+            other.handle = nullptr;
+        }
+
+        Task& operator=(Task&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Destroy();
+                handle       = other.handle;
+                other.handle = nullptr;
+            }
+
+            return *this;
+        }
+
+        ~Task()
+        {
+            Destroy();
+        }
+
+        bool IsValid() const { return handle != nullptr;        }
+        bool IsDone()  const { return !handle || handle.done(); }
+
+        // 完了したタスクの結果（WhenAll で待機したタスクなど）
+        decltype(auto) GetResult()
+        {
+            SL_ASSERT(handle && handle.done());
+            return handle.promise().GetResult();
+        }
+
+        // 一時オブジェクト（co_await Foo() / co_await std::move(task)）は、結果をムーブして受け取る
+        auto operator co_await() && noexcept
+        {
+            struct Awaiter : Internal::TaskStarter<T>
+            {
+                T await_resume()
+                {
+                    if constexpr (!Traits::IsSame<T, void>())
+                    {
+                        return Traits::Move(this->handle.promise().GetResult());
+                    }
+                }
+            };
+
+            return Awaiter{ { handle } };
+        }
+
+        // 名前付きのタスク（co_await task）は、結果を参照で受け取る
+        // 完了済みのタスクを再び co_await した場合は、開始せずに結果を返す
+        auto operator co_await() & noexcept
+        {
+            struct Awaiter : Internal::TaskStarter<T>
+            {
+                decltype(auto) await_resume()
+                {
+                    return this->handle.promise().GetResult();
+                }
+            };
+
+            return Awaiter{ { handle } };
+        }
+
+        Handle GetHandle() const { return handle; }
+
+    private:
+
+        void Destroy()
+        {
+            if (handle)
+            {
+                handle.destroy();
+                handle = nullptr;
+            }
+        }
+
+        Handle handle = nullptr;
+
+    private:
+
+        Task(const Task&)            = delete;
+        Task& operator=(const Task&) = delete;
+    };
+
+    namespace Internal
+    {
+        template<typename T>
+        inline Task<T> TaskPromise<T>::get_return_object()
+        {
+            return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+        }
+
+        inline Task<void> TaskPromise<void>::get_return_object()
+        {
+            return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+        }
+    }
+
+
+    //=========================================================================
+    // スレッドの切り替え
+    //=========================================================================
+
+    // ワーカースレッドで再開する
+    inline auto SwitchToWorker()
+    {
+        struct Awaiter
+        {
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<> handle) const
+            {
+                ThreadPool::AddTask([handle]() { handle.resume(); });
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        return Awaiter{};
+    }
+
+    // メインスレッドで再開する（メインスレッドから呼んだ場合はそのまま続行する）
+    inline auto SwitchToMainThread(const char* name = "Coroutine")
+    {
+        struct Awaiter
+        {
+            const char* name;
+
+            bool await_ready() const noexcept
+            {
+                return MainThreadQueue::IsMainThread();
+            }
+
+            void await_suspend(std::coroutine_handle<> handle) const
+            {
+                MainThreadQueue::Post(name, [handle]() { handle.resume(); });
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        return Awaiter{ name };
+    }
+
+
+    //=========================================================================
+    // WhenAll
+    //-------------------------------------------------------------------------
+    // 全てのタスクを開始し、全て完了したら再開する。結果は各タスクの GetResult で受け取る
+    // 子タスクは呼び出しスレッドで開始するので、重い処理の前に SwitchToWorker すること
+    //=========================================================================
+    namespace Internal
+    {
+        struct WhenAllLatch
+        {
+            std::atomic<uint64>     count = 0;
+            std::coroutine_handle<> awaiting;
+
+            // 最後に到着したら true
+            bool Arrive()
+            {
+                return count.fetch_sub(1, std::memory_order_acq_rel) == 1;
+            }
+        };
+
+        template<typename T>
+        DetachedTask WhenAllWaiter(Task<T>& task, WhenAllLatch& latch)
+        {
+            co_await TaskStarter<T>{ task.GetHandle() };
+
+            if (latch.Arrive())
+            {
+                latch.awaiting.resume();
+            }
+        }
+
+        template<typename T>
+        struct WhenAllAwaiter
+        {
+            std::span<Task<T>> tasks;
+            WhenAllLatch       latch;
+
+            bool await_ready() const noexcept
+            {
+                return tasks.empty();
+            }
+
+            bool await_suspend(std::coroutine_handle<> awaiting)
+            {
+                // 待機側の到着分を 1つ多く数えておき、全ての子タスクの開始前に再開されないようにする
+                latch.awaiting = awaiting;
+                latch.count.store(tasks.size() + 1, std::memory_order_relaxed);
+
+                for (Task<T>& task : tasks)
+                {
+                    WhenAllWaiter(task, latch);
+                }
+
+                return !latch.Arrive();
+            }
+
+            void await_resume() const noexcept {}
+        };
+    }
+
+    template<typename T>
+    Task<void> WhenAll(std::span<Task<T>> tasks)
+    {
+        co_await Internal::WhenAllAwaiter<T>{ tasks, {} };
+    }
+
+    template<typename T, typename Allocator>
+    Task<void> WhenAll(std::vector<Task<T>, Allocator>& tasks)
+    {
+        return WhenAll(std::span<Task<T>>(tasks));
+    }
+
+
+    //=========================================================================
+    // 同期待機
+    //-------------------------------------------------------------------------
+    // コルーチン外からタスクを開始し、完了までブロックする（初期化処理など）
+    // 待機中はスレッドプールのタスクを実行し、メインスレッドから呼んだ場合はメインスレッドキューも実行する
+    // （ワーカーが全て塞がっていても、SwitchToWorker の継続が進むようにするため）
+    // ワーカースレッドからは呼ばないこと（待機中のワーカーがタスクを処理できなくなる）
+    //=========================================================================
+    namespace Internal
+    {
+        template<typename T>
+        DetachedTask SyncWaitRunner(Task<T>& task, std::atomic<bool>& done)
+        {
+            co_await TaskStarter<T>{ task.GetHandle() };
+            done.store(true, std::memory_order_release);
+        }
+    }
+
+    template<typename T>
+    decltype(auto) SyncWait(Task<T>& task)
+    {
+        SL_ASSERT(!ThreadPool::IsWorkerThread());
+
+        std::atomic<bool> done = false;
+        Internal::SyncWaitRunner(task, done);
+
+        bool isMainThread = MainThreadQueue::IsMainThread();
+        while (!done.load(std::memory_order_acquire))
+        {
+            if (isMainThread && MainThreadQueue::GetPendingCount() != 0)
+            {
+                MainThreadQueue::Flush();
+            }
+            else if (!ThreadPool::RunPendingTask())
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        return task.GetResult();
+    }
+
+
+    //=========================================================================
+    // 完了を待たずに実行する（タスクは完了時に破棄される）
+    //=========================================================================
+    namespace Internal
+    {
+        template<typename T>
+        DetachedTask DetachedRunner(Task<T> task)
+        {
+            co_await Traits::Move(task);
+        }
+    }
+
+    template<typename T>
+    void StartDetached(Task<T>&& task)
+    {
+        Internal::DetachedRunner(Traits::Move(task));
+    }
+}
@@ -3,6 +3,10 @@
 
 #include "Core/Engine.h"
 #include "Core/ThreadPool.h"
+#include "Core/MainThreadQueue.h"
+#include "Core/FrameStatistics.h"
+#include "Core/Metrics.h"
+#include "Core/HitchDetector.h"
 #include "Asset/Asset.h"
 #include "Rendering/Renderer.h"
 #include "Rendering/OpenGL/GLEditorUI.h"
@@ -14,8 +18,110 @@ namespace Silex
     static Engine* engine = nullptr;
     static Window* window = nullptr;
 
+    //=========================================
+    // コマンドライン引数
+    //-----------------------------------------
+    // -profile-capture    <フレーム数> : 起動直後からプロファイルをキャプチャし、書き出した後に終了する
+    // -profile-output     <ファイル>   : キャプチャの書き出し先（既定: ProfileCapture.json）
+    // -run-frames         <フレーム数> : 指定フレーム数を実行した後に終了する
+    // -frame-stats-output <ファイル>   : 終了時にフレーム時間の統計を JSON で書き出す
+    // -metrics-output     <ファイル>   : 終了時にメトリクスの履歴を CSV で書き出す
+    // -hitch-budget       <ms>         : ヒッチとして記録するフレームの処理時間（既定: 33.3）
+    // -hitch-log          <ファイル>   : 終了時にヒッチの記録を書き出す
+    //=========================================
+    struct LaunchOption
+    {
+        uint32      profileCaptureFrames = 0;
+        std::string profileOutputPath    = "ProfileCapture.json";
+        uint32      runFrames            = 0;
+        std::string frameStatsOutputPath;
+        std::string metricsOutputPath;
+        float       hitchBudget          = 0.0f;
+        std::string hitchLogPath;
+    };
+
+    static LaunchOption launchOption;
+
+    // 空白で区切る（"" で囲んだ部分は区切らない）
+    static std::vector<std::string> SplitCommandLine(const char* commandLine)
+    {
+        std::vector<std::string> args;
+        std::string current;
+        bool        quoted = false;
+
+        for (const char* c = commandLine; c && *c; c++)
+        {
+            if (*c == '"')
+            {
+                quoted = !quoted;
+            }
+            else if (!quoted && (*c == ' ' || *c == '\t'))
+            {
+                if (!current.empty())
+                {
+                    args.push_back(current);
+                    current.clear();
+                }
+            }
+            else
+            {
+                current.push_back(*c);
+            }
+        }
 
-    bool LaunchEngine()
+        if (!current.empty())
+        {
+            args.push_back(current);
+        }
+
+        return args;
+    }
+
+    static void ParseCommandLine(const char* commandLine)
+    {
+        std::vector<std::string> args = SplitCommandLine(commandLine);
+
+        for (uint64 i = 0; i < args.size(); i++)
+        {
+            bool hasValue = i + 1 < args.size();
+
+            if (args[i] == "-profile-capture" && hasValue)
+            {
+                launchOption.profileCaptureFrames = (uint32)std::strtoul(args[++i].c_str(), nullptr, 10);
+            }
+            else if (args[i] == "-profile-output" && hasValue)
+            {
+                launchOption.profileOutputPath = args[++i];
+            }
+            else if (args[i] == "-run-frames" && hasValue)
+            {
+                launchOption.runFrames = (uint32)std::strtoul(args[++i].c_str(), nullptr, 10);
+            }
+            else if (args[i] == "-frame-stats-output" && hasValue)
+            {
+                launchOption.frameStatsOutputPath = args[++i];
+            }
+            else if (args[i] == "-metrics-output" && hasValue)
+            {
+                launchOption.metricsOutputPath = args[++i];
+            }
+            else if (args[i] == "-hitch-budget" && hasValue)
+            {
+                launchOption.hitchBudget = std::strtof(args[++i].c_str(), nullptr);
+            }
+            else if (args[i] == "-hitch-log" && hasValue)
+            {
+                launchOption.hitchLogPath = args[++i];
+            }
+            else
+            {
+                SL_LOG_WARN("不明なコマンドライン引数: {}", args[i]);
+            }
+        }
+    }
+
+
+    bool LaunchEngine(const char* commandLine)
     {
         // OS初期化
         OS::Get()->Initialize();
@@ -26,11 +132,17 @@ namespace Silex
         // コア機能初期化
         Logger::Initialize();
         Memory::Initialize();
+        Profiler::Initialize();
+        FrameStatistics::Initialize();
+        Metrics::Initialize();
+        HitchDetector::Initialize();
         Input::Initialize();
         ThreadPool::Initialize();
 
         SL_LOG_INFO("***** Launch Engine *****");
 
+        ParseCommandLine(commandLine);
+
         // エンジン初期化
         engine = Memory::Allocate<Engine>();
         if (!engine->Initialize())
@@ -57,6 +169,10 @@ namespace Silex
 
         ThreadPool::Finalize();
         Input::Finalize();
+        HitchDetector::Finalize();
+        Metrics::Finalize();
+        FrameStatistics::Finalize();
+        Profiler::Finalize();
         Memory::Finalize();
         Logger::Finalize();
 
@@ -89,6 +205,9 @@ namespace Silex
         window->BindMouseMoveEvent(this,    &Engine::OnMouseMove);
         window->BindMouseScrollEvent(this,  &Engine::OnMouseScroll);
 
+        // メインスレッドキュー
+        MainThreadQueue::Initialize();
+
         // レンダラー
         Renderer::Get()->Init();
 
@@ -106,6 +225,25 @@ namespace Silex
         // ウィンドウ表示
         window->Show();
 
+#if SL_ENABLE_RENDER_THREAD
+        // GL 関連の初期化が完了したので、コンテキストをレンダースレッドに移す
+        Renderer::Get()->StartRenderThread();
+#endif
+
+        // コマンドラインからのキャプチャは、書き出し後に終了する（自動計測用）
+        if (launchOption.profileCaptureFrames != 0)
+        {
+            closeAfterCapture = Profiler::StartCapture(launchOption.profileCaptureFrames, launchOption.profileOutputPath);
+        }
+
+        if (launchOption.hitchBudget > 0.0f)
+        {
+            HitchDetector::SetBudget(launchOption.hitchBudget);
+        }
+
+        // 初期化にかかった時間を、最初のフレーム時間に含めない
+        lastFrameTime = OS::Get()->GetTickNanoseconds();
+
         return true;
     }
 
@@ -113,6 +251,9 @@ namespace Silex
     {
         CalcurateFrameTime();
 
+        // ワーカースレッドから追加された GL 処理（テクスチャ転送など）を予算の範囲で実行
+        MainThreadQueue::Execute(MainThreadQueue::GetTimeBudget());
+
         if (!minimized)
         {
             Renderer::Get()->BeginFrame();
@@ -127,7 +268,37 @@ namespace Silex
             Input::Flush();
         }
 
-        PerformanceProfiler::Get().GetFrameData(&performanceData, true);
+        // このフレームの処理時間（前フレームとの間隔ではなく、スコープツリーと対応する今回の処理時間）
+        float frameTime = (OS::Get()->GetTickNanoseconds() - lastFrameTime) / 1'000'000.0f;
+
+        // メトリクスのスナップショット（キャプチャ中はカウンタートラックにも記録される）
+        Metrics::NextFrame();
+
+        // 全スレッドの計測結果をフレーム単位で集計
+        Profiler::NextFrame();
+        FrameStatistics::NextFrame(frameTime);
+
+        if (closeAfterCapture && !Profiler::IsCapturing())
+        {
+            isRunning = false;
+        }
+
+        if (launchOption.runFrames != 0 && FrameStatistics::GetFrameCount() >= launchOption.runFrames)
+        {
+            isRunning = false;
+        }
+
+        // 使用されていないメモリプールのスラブを OS に返却
+        PoolAllocator::Trim();
+
+        // フレームアリーナを次のフレームへ
+        FrameArena::NextFrame();
+
+        // フレーム毎の確保量を集計
+        MemoryTracker::NextFrame();
+
+        // 集計が済んだので、予算を超えていればこのフレームを記録する
+        HitchDetector::NextFrame(frameTime);
 
         // メインループ抜け出し確認
         return isRunning;
@@ -135,6 +306,28 @@ namespace Silex
 
     void Engine::Finalize()
     {
+        if (!launchOption.frameStatsOutputPath.empty())
+        {
+            FrameStatistics::WriteJson(launchOption.frameStatsOutputPath);
+        }
+
+        if (!launchOption.metricsOutputPath.empty())
+        {
+            Metrics::WriteCsv(launchOption.metricsOutputPath);
+        }
+
+        if (!launchOption.hitchLogPath.empty())
+        {
+            HitchDetector::WriteLog(launchOption.hitchLogPath);
+        }
+
+        // 終了処理は GL リソースを破棄するので、コンテキストをメインスレッドに戻す
+        Renderer::Get()->StopRenderThread();
+
+        // 実行中のタスクが追加する後続処理も含めて、メインスレッドキューを空にする
+        ThreadPool::WaitAll();
+        MainThreadQueue::Finalize();
+
         if (editor)
         {
             editor->Shutdown();
@@ -192,8 +385,8 @@ namespace Silex
 
     void Engine::CalcurateFrameTime()
     {
-        uint64 time = OS::Get()->GetTickSeconds();
-        deltaTime     = (double)(time - lastFrameTime) / 1'000'000;
+        uint64 time = OS::Get()->GetTickNanoseconds();
+        deltaTime     = (double)(time - lastFrameTime) / 1'000'000'000;
         lastFrameTime = time;
 
         static float  secondLeft = 0.0f;
@@ -3,7 +3,7 @@
 #include "Core/OS.h"
 #include "Core/Event.h"
 #include "Core/Window.h"
-#include "Core/Timer.h"
+#include "Core/Profiler.h"
 #include "Editor/Editor.h"
 #include "Editor/EditorUI.h"
 
@@ -32,11 +32,6 @@ namespace Silex
         float   GetDeltaTime() const { return deltaTime; }
         uint32  GetFrameRate() const { return frameRate; }
 
-        const std::unordered_map<const char*, float>& GetPerformanceData() const
-        {
-            return performanceData;
-        }
-
     private:
 
         void OnWindowResize(WindowResizeEvent& e);
@@ -51,13 +46,12 @@ namespace Silex
         Editor*   editor   = nullptr;
         EditorUI* editorUI = nullptr;
 
-        bool isRunning = true;
-        bool minimized = false;
+        bool isRunning         = true;
+        bool minimized         = false;
+        bool closeAfterCapture = false;
 
         uint64 lastFrameTime = 0;
         uint32 frameRate     = 0;
         float  deltaTime     = 0.0f;
-
-        std::unordered_map<const char*, float> performanceData;
     };
 }
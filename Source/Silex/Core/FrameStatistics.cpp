@@ -0,0 +1,257 @@
+
+#include "PCH.h"
+
+#include "Core/FrameStatistics.h"
+#include "Core/Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace Silex
+{
+    //============================================================================
+    // リングバッファ
+    //----------------------------------------------------------------------------
+    // 満杯になると古い値から上書きする
+    //============================================================================
+    struct TimeSeries
+    {
+        uint64           path  = 0;
+        const char*      name  = nullptr;
+        uint32           depth = 0;
+        uint32           head  = 0; // 次に書き込む位置
+        uint32           count = 0;
+        FrameTimeSummary summary;
+
+        float values[FrameStatistics::windowSize];
+
+        void Add(float value)
+        {
+            values[head] = value;
+            head  = (head + 1) % FrameStatistics::windowSize;
+            count = std::min(count + 1, FrameStatistics::windowSize);
+
+            // 最大値は即時に反映する（ヒッチを次の再計算まで見逃さないように）
+            summary.max = std::max(summary.max, value);
+        }
+
+        // 古い順に列挙する
+        template<typename Function>
+        void ForEach(Function&& function) const
+        {
+            uint32 begin = (head + FrameStatistics::windowSize - count) % FrameStatistics::windowSize;
+            for (uint32 i = 0; i < count; i++)
+            {
+                function(values[(begin + i) % FrameStatistics::windowSize]);
+            }
+        }
+    };
+
+    // メモリシステムより先に破棄されないように、Initialize で確保し Finalize で解放する
+    struct FrameStatisticsData
+    {
+        TimeSeries                  frameTimes;
+        TimeSeries                  scopes[FrameStatistics::maxScopes];
+        uint32                      numScopes = 0;
+        PoolHashMap<uint64, uint32> scopeIndices;
+
+        uint64                                          frameCount = 0;
+        PoolVector<float>                               sorted;
+        PoolVector<ScopeTimeSummary>                    scopeSummaries;
+        std::array<uint32, FrameStatistics::numBuckets> histogram = {};
+    };
+
+    static FrameStatisticsData* data = nullptr;
+
+    static const std::array<float, FrameStatistics::numBuckets> histogramEdges =
+    {
+        0.0f, 4.0f, 8.0f, 12.0f, 16.7f, 20.0f, 25.0f, 33.3f, 50.0f, 100.0f
+    };
+
+
+    // 最近傍順位法（ソート済み配列の ceil(p * n) 番目）
+    static float Percentile(const PoolVector<float>& sorted, double percentile)
+    {
+        uint64 rank = (uint64)std::ceil(percentile * sorted.size());
+        return sorted[std::clamp<uint64>(rank, 1, sorted.size()) - 1];
+    }
+
+    static void Summarize(TimeSeries& series, PoolVector<float>& sorted)
+    {
+        FrameTimeSummary& summary = series.summary;
+        summary = {};
+
+        if (series.count == 0)
+            return;
+
+        sorted.clear();
+        series.ForEach([&](float value) { sorted.push_back(value); });
+        std::sort(sorted.begin(), sorted.end());
+
+        double total = 0.0;
+        for (float value : sorted)
+        {
+            total += value;
+        }
+
+        summary.count = series.count;
+        summary.mean  = (float)(total / sorted.size());
+        summary.p50   = Percentile(sorted, 0.50);
+        summary.p90   = Percentile(sorted, 0.90);
+        summary.p99   = Percentile(sorted, 0.99);
+        summary.p999  = Percentile(sorted, 0.999);
+        summary.max   = sorted.back();
+    }
+
+    static void UpdateSummaries()
+    {
+        Summarize(data->frameTimes, data->sorted);
+
+        data->histogram = {};
+        data->frameTimes.ForEach([](float value)
+        {
+            // value 以下の境界のうち最大のもの
+            auto it = std::upper_bound(histogramEdges.begin(), histogramEdges.end(), value);
+            uint64 bucket = std::max<int64>(it - histogramEdges.begin() - 1, 0);
+            data->histogram[bucket]++;
+        });
+
+        data->scopeSummaries.resize(data->numScopes);
+        for (uint32 i = 0; i < data->numScopes; i++)
+        {
+            TimeSeries& series = data->scopes[i];
+            Summarize(series, data->sorted);
+
+            ScopeTimeSummary& scope = data->scopeSummaries[i];
+            scope.name    = series.name;
+            scope.depth   = series.depth;
+            scope.summary = series.summary;
+        }
+    }
+
+
+    void FrameStatistics::Initialize()
+    {
+        data = Memory::Allocate<FrameStatisticsData>();
+        data->sorted.reserve(windowSize);
+    }
+
+    void FrameStatistics::Finalize()
+    {
+        Memory::Deallocate(data);
+        data = nullptr;
+    }
+
+    void FrameStatistics::NextFrame(float frameTimeMilliseconds)
+    {
+        data->frameTimes.Add(frameTimeMilliseconds);
+        data->frameCount++;
+
+        // プロファイラーのスコープ（上限を超えた新しいスコープは記録しない）
+        for (const ProfileNode& node : Profiler::GetFrameNodes())
+        {
+            auto it = data->scopeIndices.find(node.path);
+            if (it == data->scopeIndices.end())
+            {
+                if (data->numScopes == maxScopes)
+                    continue;
+
+                TimeSeries& series = data->scopes[data->numScopes];
+                series.path  = node.path;
+                series.name  = node.name;
+                series.depth = node.depth;
+
+                it = data->scopeIndices.emplace(node.path, data->numScopes++).first;
+            }
+
+            data->scopes[it->second].Add(node.totalTime);
+        }
+
+        if (data->frameCount % summaryInterval == 0)
+        {
+            UpdateSummaries();
+        }
+    }
+
+    uint64 FrameStatistics::GetFrameCount()
+    {
+        return data->frameCount;
+    }
+
+    const FrameTimeSummary& FrameStatistics::GetFrameTimeSummary()
+    {
+        return data->frameTimes.summary;
+    }
+
+    const PoolVector<ScopeTimeSummary>& FrameStatistics::GetScopeSummaries()
+    {
+        return data->scopeSummaries;
+    }
+
+    const std::array<uint32, FrameStatistics::numBuckets>& FrameStatistics::GetHistogram()
+    {
+        return data->histogram;
+    }
+
+    const std::array<float, FrameStatistics::numBuckets>& FrameStatistics::GetHistogramEdges()
+    {
+        return histogramEdges;
+    }
+
+    uint32 FrameStatistics::CopyFrameTimes(float* outTimes, uint32 maxCount)
+    {
+        // 新しい maxCount 個を古い順に
+        const TimeSeries& series = data->frameTimes;
+        uint32 count = std::min(series.count, maxCount);
+        uint32 begin = (series.head + windowSize - count) % windowSize;
+
+        for (uint32 i = 0; i < count; i++)
+        {
+            outTimes[i] = series.values[(begin + i) % windowSize];
+        }
+
+        return count;
+    }
+
+    static std::string FormatSummary(const FrameTimeSummary& summary)
+    {
+        return std::format("\"count\":{},\"mean\":{:.4f},\"p50\":{:.4f},\"p90\":{:.4f},\"p99\":{:.4f},\"p999\":{:.4f},\"max\":{:.4f}",
+            summary.count, summary.mean, summary.p50, summary.p90, summary.p99, summary.p999, summary.max);
+    }
+
+    bool FrameStatistics::WriteJson(const std::string& filePath)
+    {
+        // 途中のフレームまでの値も含めるように、書き出し前に再計算する
+        UpdateSummaries();
+
+        std::ofstream fout(filePath);
+        if (!fout)
+        {
+            SL_LOG_ERROR("フレーム統計を書き出せません: {}", filePath);
+            return false;
+        }
+
+        fout << "{\n";
+        fout << std::format("  \"frames\": {},\n", data->frameCount);
+        fout << std::format("  \"frameTime\": {{{}}},\n", FormatSummary(data->frameTimes.summary));
+
+        fout << "  \"histogram\": [";
+        for (uint32 i = 0; i < numBuckets; i++)
+        {
+            fout << std::format("{}{{\"min\":{:.1f},\"count\":{}}}", i ? "," : "", histogramEdges[i], data->histogram[i]);
+        }
+        fout << "],\n";
+
+        fout << "  \"scopes\": [";
+        for (uint32 i = 0; i < data->scopeSummaries.size(); i++)
+        {
+            const ScopeTimeSummary& scope = data->scopeSummaries[i];
+            fout << std::format("{}\n    {{\"name\":\"{}\",\"depth\":{},{}}}", i ? "," : "", EscapeJson(scope.name), scope.depth, FormatSummary(scope.summary));
+        }
+        fout << "\n  ]\n}\n";
+
+        SL_LOG_INFO("フレーム統計を書き出しました: {}", filePath);
+        return true;
+    }
+}
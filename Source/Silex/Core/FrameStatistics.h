@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Core/CoreType.h"
+#include "Core/MemoryResource.h"
+
+#include <array>
+#include <string>
+
+
+namespace Silex
+{
+    // 直近のフレーム（ウィンドウ内）の統計値（ms）
+    struct FrameTimeSummary
+    {
+        uint32 count = 0;
+        float  mean  = 0.0f;
+        float  p50   = 0.0f;
+        float  p90   = 0.0f;
+        float  p99   = 0.0f;
+        float  p999  = 0.0f;
+        float  max   = 0.0f;
+    };
+
+    // プロファイラーのスコープ毎の統計値
+    struct ScopeTimeSummary
+    {
+        const char*      name  = nullptr;
+        uint32           depth = 0;
+        FrameTimeSummary summary;
+    };
+
+
+    //=========================================================================
+    // フレーム時間の統計
+    //-------------------------------------------------------------------------
+    // 直近 windowSize フレームのフレーム時間と、プロファイラーのスコープ毎の CPU 時間を
+    // 固定長のリングバッファに保持し、パーセンタイル・最大値・ヒストグラムを求める
+    //
+    // パーセンタイルはソートが必要なので、毎フレームではなく summaryInterval フレーム毎に再計算する
+    // （ヒッチの最大値は、記録時に即時反映する）
+    //=========================================================================
+    class FrameStatistics
+    {
+    public:
+
+        static constexpr uint32 windowSize      = 4096;
+        static constexpr uint32 maxScopes       = 64;
+        static constexpr uint32 summaryInterval = 30;
+        static constexpr uint32 numBuckets      = 10;
+
+        static void Initialize();
+        static void Finalize();
+
+        // フレーム時間と、直前に集計されたプロファイラーのスコープ時間を記録する（メインスレッドのみ）
+        static void NextFrame(float frameTimeMilliseconds);
+
+        static uint64                              GetFrameCount();
+        static const FrameTimeSummary&             GetFrameTimeSummary();
+        static const PoolVector<ScopeTimeSummary>& GetScopeSummaries();
+
+        // ヒストグラム（ウィンドウ内のフレーム数。バケット i は [edges[i], edges[i + 1]) ms、最後のバケットは上限なし）
+        static const std::array<uint32, numBuckets>& GetHistogram();
+        static const std::array<float,  numBuckets>& GetHistogramEdges();
+
+        // ウィンドウ内のフレーム時間を古い順にコピーし、コピーした数を返す
+        static uint32 CopyFrameTimes(float* outTimes, uint32 maxCount);
+
+        // 統計値を JSON で書き出す（ビルド間の比較用）
+        static bool WriteJson(const std::string& filePath);
+    };
+}
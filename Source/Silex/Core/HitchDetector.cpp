@@ -0,0 +1,221 @@
+
+#include "PCH.h"
+
+#include "Core/HitchDetector.h"
+#include "Core/Metrics.h"
+
+
+namespace Silex
+{
+    // メモリシステムより先に破棄されないように、Initialize で確保し Finalize で解放する
+    struct HitchDetectorData
+    {
+        PoolVector<HitchRecord> records;        // maxRecords 個のリングバッファ
+        uint32                  head       = 0; // 次に書き込む位置
+        uint32                  count      = 0;
+        uint64                  frameCount = 0;
+        uint64                  totalCount = 0; // 上書きされた記録も含めた検出数
+    };
+
+    // 記録待ちの出来事（任意のスレッドから追加されるので、確保せずに静的な配列に置く）
+    struct PendingEvent
+    {
+        enum State : uint32
+        {
+            Free,
+            Writing,
+            Ready,
+        };
+
+        const char*         label     = nullptr;
+        uint64              value     = 0;
+        HitchEventFormatter formatter = nullptr;
+        std::atomic<uint32> state     = Free;
+    };
+
+    static HitchDetectorData*  data   = nullptr;
+    static std::atomic<float>  budget = 33.3f;
+
+    static PendingEvent        pendingEvents[HitchDetector::maxEventsPerFrame];
+    static std::atomic<uint32> numPendingEvents = 0;
+
+
+    static std::string FormatEvent(const char* label, uint64 value)
+    {
+        return std::format("{} {}", label, value);
+    }
+
+
+    void HitchDetector::Initialize()
+    {
+        data = Memory::Allocate<HitchDetectorData>();
+        data->records.resize(maxRecords);
+    }
+
+    void HitchDetector::Finalize()
+    {
+        Memory::Deallocate(data);
+        data = nullptr;
+    }
+
+    void HitchDetector::SetBudget(float milliseconds)
+    {
+        budget.store(milliseconds, std::memory_order_relaxed);
+    }
+
+    float HitchDetector::GetBudget()
+    {
+        return budget.load(std::memory_order_relaxed);
+    }
+
+    void HitchDetector::AddEvent(const char* label, uint64 value, HitchEventFormatter formatter)
+    {
+        uint32 index = numPendingEvents.fetch_add(1, std::memory_order_relaxed);
+        if (index >= maxEventsPerFrame)
+            return;
+
+        // フレームをまたいで書き込み中のスロットと重なった場合は捨てる
+        PendingEvent& event    = pendingEvents[index];
+        uint32        expected = PendingEvent::Free;
+        if (!event.state.compare_exchange_strong(expected, PendingEvent::Writing, std::memory_order_acquire))
+            return;
+
+        event.label     = label;
+        event.value     = value;
+        event.formatter = formatter;
+        event.state.store(PendingEvent::Ready, std::memory_order_release);
+    }
+
+    bool HitchDetector::NextFrame(float frameTimeMilliseconds)
+    {
+        uint64 frame = data->frameCount++;
+        float  limit = GetBudget();
+
+        // ヒッチでなくてもスロットは毎フレーム空ける（書き込み中のものは次のフレームの出来事になる）
+        PendingEvent events[maxEventsPerFrame];
+        uint32       numEvents = 0;
+
+        numPendingEvents.store(0, std::memory_order_relaxed);
+        for (PendingEvent& event : pendingEvents)
+        {
+            if (event.state.load(std::memory_order_acquire) == PendingEvent::Ready)
+            {
+                events[numEvents].label     = event.label;
+                events[numEvents].value     = event.value;
+                events[numEvents].formatter = event.formatter;
+                numEvents++;
+
+                event.state.store(PendingEvent::Free, std::memory_order_release);
+            }
+        }
+
+        if (frameTimeMilliseconds <= limit)
+            return false;
+
+        // 古い記録を上書きする（コンテナは再利用する）
+        HitchRecord& record = data->records[data->head];
+        record.frame     = frame;
+        record.frameTime = frameTimeMilliseconds;
+        record.budget    = limit;
+
+        const PoolVector<ProfileNode>& nodes = Profiler::GetFrameNodes();
+        record.scopes.assign(nodes.begin(), nodes.end());
+
+        std::vector<AllocationSiteStats> allocations = MemoryTracker::GetFrameTopAllocators(maxAllocations);
+        record.allocations.assign(allocations.begin(), allocations.end());
+
+        record.metrics.clear();
+        for (MetricID id = 1; id <= Metrics::GetMetricCount(); id++)
+        {
+            if (int64 value = Metrics::GetValue(id))
+            {
+                record.metrics.push_back({ Metrics::GetName(id), value });
+            }
+        }
+
+        record.events.clear();
+        for (uint32 i = 0; i < numEvents; i++)
+        {
+            HitchEventFormatter formatter = events[i].formatter ? events[i].formatter : FormatEvent;
+            record.events.push_back(formatter(events[i].label, events[i].value));
+        }
+
+        data->head  = (data->head + 1) % maxRecords;
+        data->count = std::min(data->count + 1, maxRecords);
+        data->totalCount++;
+
+        SL_LOG_WARN("ヒッチ: フレーム {} が {:.2f} ms（予算 {:.2f} ms）", frame, frameTimeMilliseconds, limit);
+        return true;
+    }
+
+    uint32 HitchDetector::GetRecordCount()
+    {
+        return data->count;
+    }
+
+    const HitchRecord& HitchDetector::GetRecord(uint32 index)
+    {
+        SL_ASSERT(index < data->count);
+
+        uint32 begin = (data->head + maxRecords - data->count) % maxRecords;
+        return data->records[(begin + index) % maxRecords];
+    }
+
+    uint64 HitchDetector::GetTotalHitchCount()
+    {
+        return data->totalCount;
+    }
+
+    void HitchDetector::Clear()
+    {
+        data->head  = 0;
+        data->count = 0;
+    }
+
+    bool HitchDetector::WriteLog(const std::string& filePath)
+    {
+        std::ofstream fout(filePath);
+        if (!fout)
+        {
+            SL_LOG_ERROR("ヒッチの記録を書き出せません: {}", filePath);
+            return false;
+        }
+
+        fout << std::format("hitches: {} (recorded: {})\n", data->totalCount, data->count);
+
+        for (uint32 i = 0; i < data->count; i++)
+        {
+            const HitchRecord& record = GetRecord(i);
+
+            fout << std::format("\n=== frame {}: {:.3f} ms (budget {:.3f} ms)\n", record.frame, record.frameTime, record.budget);
+
+            fout << "--- scopes (calls / total / max ms)\n";
+            for (const ProfileNode& node : record.scopes)
+            {
+                uint32 indent = std::min(node.depth * 2, 32u);
+                fout << std::format("{:{}}{:<{}} {:>6} {:>10.3f} {:>10.3f}\n", "", indent, node.name, 40 - indent, node.numCalls, node.totalTime, node.maxTime);
+            }
+
+            fout << "--- allocations (bytes / count, estimated)\n";
+            for (const AllocationSiteStats& site : record.allocations)
+            {
+                fout << std::format("{:>12} {:>8} 0x{:016x} {}\n", site.bytes, site.count, (uint64)site.callSite, GetReadableTypeName(site.typeName));
+            }
+
+            fout << "--- metrics\n";
+            for (const HitchMetric& metric : record.metrics)
+            {
+                fout << std::format("{:<40} {}\n", metric.name, metric.value);
+            }
+
+            fout << "--- events\n";
+            for (const std::string& event : record.events)
+            {
+                fout << event << "\n";
+            }
+        }
+
+        SL_LOG_INFO("ヒッチの記録を書き出しました: {}", filePath);
+        return true;
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Core/CoreType.h"
+#include "Core/MemoryResource.h"
+#include "Core/MemoryTracker.h"
+#include "Core/Profiler.h"
+
+#include <string>
+
+
+namespace Silex
+{
+    // 出来事を文字列にする関数（ヒッチを記録する時にのみ、メインスレッドから呼ばれる）
+    using HitchEventFormatter = std::string(*)(const char* label, uint64 value);
+
+    // ヒッチ時のメトリクスの値（0 以外のもののみ）
+    struct HitchMetric
+    {
+        const char* name  = nullptr;
+        int64       value = 0;
+    };
+
+    // 予算を超えたフレームの記録
+    struct HitchRecord
+    {
+        uint64 frame     = 0;
+        float  frameTime = 0.0f; // ms
+        float  budget    = 0.0f; // ms
+
+        PoolVector<ProfileNode>         scopes;      // Profiler::GetFrameNodes のコピー
+        PoolVector<AllocationSiteStats> allocations; // フレーム内の確保量上位（サンプリングからの推定値）
+        PoolVector<HitchMetric>         metrics;     // 描画・転送・アセット読み込み数など
+        PoolVector<std::string>         events;      // AddEvent で追加された出来事（読み込んだアセット名など）
+    };
+
+
+    //=========================================================================
+    // ヒッチ検出
+    //-------------------------------------------------------------------------
+    // フレーム毎に処理時間を予算と比較し、超えたフレームのスコープツリー・確保量上位・
+    // メトリクス・出来事を、直近 maxRecords 件のメモリ上のログに残す
+    // 常時トレースを取らずに、まれに発生する遅いフレームを後から調べるためのもの
+    //
+    // 記録はフレームの集計（Profiler / Metrics / MemoryTracker の NextFrame）が済んだ後に行う
+    //=========================================================================
+    class HitchDetector
+    {
+    public:
+
+        static constexpr uint32 maxRecords        = 32;
+        static constexpr uint32 maxAllocations    = 8;
+        static constexpr uint32 maxEventsPerFrame = 32;
+
+        static void Initialize();
+        static void Finalize();
+
+        // 予算（ms）既定は 33.3 ms（60 fps で 2フレーム分）
+        static void  SetBudget(float milliseconds);
+        static float GetBudget();
+
+        // フレームの出来事を記録する（任意のスレッドから呼び出せる。ヒッチにならなかったフレームの分は捨てる）
+        // 確保もロックもしないので、label は文字列リテラルを渡すこと。文字列化はヒッチを記録する時まで遅らせる
+        // formatter を省略した場合は "label value" の形式になる
+        static void AddEvent(const char* label, uint64 value = 0, HitchEventFormatter formatter = nullptr);
+
+        // フレームの処理時間を判定し、予算を超えていれば記録する（メインスレッドからフレーム毎に 1回呼び出す）
+        static bool NextFrame(float frameTimeMilliseconds);
+
+        // 記録（古い順）
+        static uint32             GetRecordCount();
+        static const HitchRecord& GetRecord(uint32 index);
+        static uint64             GetTotalHitchCount();
+        static void               Clear();
+
+        // 記録をテキストで書き出す
+        static bool WriteLog(const std::string& filePath);
+    };
+}
@@ -0,0 +1,265 @@
+#pragma once
+
+#include "Core/Macros.h"
+#include "Core/CoreType.h"
+#include <array>
+#include <atomic>
+#include <memory>
+
+
+namespace Silex
+{
+    //============================================================================
+    // 有界 SPSC キュー（リングバッファ）
+    //----------------------------------------------------------------------------
+    // 追加は 1つのスレッド（プロデューサー）、取り出しは 1つのスレッド（コンシューマー）のみが行う
+    // 書き込み位置と読み込み位置は別のキャッシュラインに置き、それぞれ相手の位置のキャッシュを持つ
+    // （満杯・空に見えた時だけ相手の位置を読み直すので、通常はキャッシュラインを取り合わない）
+    //============================================================================
+    template<typename T, uint64 Capacity>
+    class SPSCQueue
+    {
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "容量は 2のべき乗である必要があります");
+
+    public:
+
+        SPSCQueue() = default;
+
+        ~SPSCQueue()
+        {
+            uint64 tail = producer.tail.load(std::memory_order_relaxed);
+            for (uint64 head = consumer.head.load(std::memory_order_relaxed); head != tail; head++)
+            {
+                std::destroy_at(GetSlot(head));
+            }
+        }
+
+        // プロデューサーのみ（満杯なら false）
+        template<typename U>
+        bool Push(U&& value)
+        {
+            uint64 tail = producer.tail.load(std::memory_order_relaxed);
+
+            if (tail - producer.cachedHead >= Capacity)
+            {
+                producer.cachedHead = consumer.head.load(std::memory_order_acquire);
+                if (tail - producer.cachedHead >= Capacity)
+                    return false;
+            }
+
+            std::construct_at(GetSlot(tail), Traits::Forward<U>(value));
+            producer.tail.store(tail + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        // コンシューマーのみ（空なら false）
+        bool Pop(T& out)
+        {
+            uint64 head = consumer.head.load(std::memory_order_relaxed);
+
+            if (head == consumer.cachedTail)
+            {
+                consumer.cachedTail = producer.tail.load(std::memory_order_acquire);
+                if (head == consumer.cachedTail)
+                    return false;
+            }
+
+            T* slot = GetSlot(head);
+            out = Traits::Move(*slot);
+            std::destroy_at(slot);
+
+            consumer.head.store(head + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        // 他のスレッドから呼ぶと、呼び出し中に変化するので目安の値になる
+        uint64 GetSize() const
+        {
+            uint64 tail = producer.tail.load(std::memory_order_acquire);
+            uint64 head = consumer.head.load(std::memory_order_acquire);
+            return tail - head;
+        }
+
+        bool IsEmpty() const
+        {
+            return GetSize() == 0;
+        }
+
+        static constexpr uint64 GetCapacity()
+        {
+            return Capacity;
+        }
+
+    private:
+
+        T* GetSlot(uint64 position)
+        {
+            return reinterpret_cast<T*>(storage + sizeof(T) * (position & (Capacity - 1)));
+        }
+
+        struct SL_CACHE_ALIGN Producer
+        {
+            std::atomic<uint64> tail       = 0;
+            uint64              cachedHead = 0;
+        };
+
+        struct SL_CACHE_ALIGN Consumer
+        {
+            std::atomic<uint64> head       = 0;
+            uint64              cachedTail = 0;
+        };
+
+        Producer producer;
+        Consumer consumer;
+
+        SL_CACHE_ALIGN alignas(T) byte storage[sizeof(T) * Capacity];
+    };
+
+
+    //============================================================================
+    // 有界 MPMC キュー（Vyukov 型）
+    //----------------------------------------------------------------------------
+    // https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+    // セルごとのシーケンス番号で、書き込み完了・読み込み完了を判定する
+    // 追加・取り出しはそれぞれ位置の CAS 1回で確定し、他のスレッドの完了を待たない
+    //============================================================================
+    template<typename T, uint64 Capacity>
+    class MPMCQueue
+    {
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "容量は 2のべき乗である必要があります");
+
+    public:
+
+        MPMCQueue()
+        {
+            for (uint64 i = 0; i < Capacity; i++)
+            {
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        ~MPMCQueue()
+        {
+            Clear();
+        }
+
+        // 満杯なら false
+        template<typename U>
+        bool Push(U&& value)
+        {
+            Cell*  cell;
+            uint64 pos = enqueuePos.load(std::memory_order_relaxed);
+
+            while (true)
+            {
+                cell = &cells[pos & (Capacity - 1)];
+
+                uint64 sequence = cell->sequence.load(std::memory_order_acquire);
+                int64  diff     = (int64)sequence - (int64)pos;
+
+                if (diff == 0)
+                {
+                    if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                {
+                    // 満杯
+                    return false;
+                }
+                else
+                {
+                    pos = enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+
+            std::construct_at(cell->Get(), Traits::Forward<U>(value));
+            cell->sequence.store(pos + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        // 空なら false
+        bool Pop(T& out)
+        {
+            Cell*  cell;
+            uint64 pos = dequeuePos.load(std::memory_order_relaxed);
+
+            while (true)
+            {
+                cell = &cells[pos & (Capacity - 1)];
+
+                uint64 sequence = cell->sequence.load(std::memory_order_acquire);
+                int64  diff     = (int64)sequence - (int64)(pos + 1);
+
+                if (diff == 0)
+                {
+                    if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                {
+                    // 空
+                    return false;
+                }
+                else
+                {
+                    pos = dequeuePos.load(std::memory_order_relaxed);
+                }
+            }
+
+            out = Traits::Move(*cell->Get());
+            std::destroy_at(cell->Get());
+            cell->sequence.store(pos + Capacity, std::memory_order_release);
+
+            return true;
+        }
+
+        // 残っている要素を破棄して初期状態に戻す（他のスレッドが使用していない状態で呼び出すこと）
+        void Clear()
+        {
+            uint64 enqueue = enqueuePos.load(std::memory_order_relaxed);
+            for (uint64 pos = dequeuePos.load(std::memory_order_relaxed); pos != enqueue; pos++)
+            {
+                std::destroy_at(cells[pos & (Capacity - 1)].Get());
+            }
+
+            for (uint64 i = 0; i < Capacity; i++)
+            {
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+
+            enqueuePos.store(0, std::memory_order_relaxed);
+            dequeuePos.store(0, std::memory_order_relaxed);
+        }
+
+        // 他のスレッドから呼ぶと、呼び出し中に変化するので目安の値になる
+        uint64 GetSize() const
+        {
+            uint64 enqueue = enqueuePos.load(std::memory_order_relaxed);
+            uint64 dequeue = dequeuePos.load(std::memory_order_relaxed);
+            return enqueue > dequeue ? enqueue - dequeue : 0;
+        }
+
+        static constexpr uint64 GetCapacity()
+        {
+            return Capacity;
+        }
+
+    private:
+
+        struct Cell
+        {
+            std::atomic<uint64> sequence;
+            alignas(T) byte     storage[sizeof(T)];
+
+            T* Get() { return reinterpret_cast<T*>(storage); }
+        };
+
+        SL_CACHE_ALIGN std::atomic<uint64>        enqueuePos = 0;
+        SL_CACHE_ALIGN std::atomic<uint64>        dequeuePos = 0;
+        SL_CACHE_ALIGN std::array<Cell, Capacity> cells;
+    };
+}
@@ -4,8 +4,9 @@
 #define NEW_RENDERER                    1
 #define SL_PLATFORM_OPENGL              1
 #define SL_PLATFORM_VULKAN              0
-#define SL_ENABLE_TRACK_HEAP_ALLOCATION 0
+#define SL_ENABLE_TRACK_HEAP_ALLOCATION 1
 #define SL_ENABLE_ASSERTS               1
+#define SL_ENABLE_RENDER_THREAD         1
 
 // 結合マクロ
 #define COMBINE(x, y) x##y
@@ -26,17 +27,26 @@
 // インターフェース抽象化ハンドル
 #define SL_HANDLE(name) using name = Handle;
 
+// キャッシュライン サイズ（スレッド毎のデータの偽共有を避けるためのアライメント）
+#define SL_CACHE_LINE_SIZE 64
+#define SL_CACHE_ALIGN     alignas(SL_CACHE_LINE_SIZE)
+
 // プラットフォーム固有 (Windowsオンリーなので実質、分岐はしない)
 #if _MSC_VER
-    #define SL_DEBUG_BREAK() __debugbreak();
-    #define SL_FORCEINLINE   __forceinline
-    #define SL_FUNCNAME      __FUNCTION__
-    #define SL_FUNCSIG       __FUNCSIG__
+    #include <intrin.h>
+    #define SL_DEBUG_BREAK()    __debugbreak();
+    #define SL_FORCEINLINE      __forceinline
+    #define SL_NOINLINE         __declspec(noinline)
+    #define SL_FUNCNAME         __FUNCTION__
+    #define SL_FUNCSIG          __FUNCSIG__
+    #define SL_RETURN_ADDRESS() _ReturnAddress()
 #else
-    #define SL_DEBUG_BREAK() __builtin_trap();
-    #define SL_FORCEINLINE   __attribute__((__always_inline__))
-    #define SL_FUNCNAME      __FUNCTION__
-    #define SL_FUNCSIG       __PRETTY_FUNCTION__
+    #define SL_DEBUG_BREAK()    __builtin_trap();
+    #define SL_FORCEINLINE      __attribute__((__always_inline__)) inline
+    #define SL_NOINLINE         __attribute__((__noinline__))
+    #define SL_FUNCNAME         __FUNCTION__
+    #define SL_FUNCSIG          __PRETTY_FUNCTION__
+    #define SL_RETURN_ADDRESS() __builtin_return_address(0)
 #endif
 
 
@@ -0,0 +1,169 @@
+
+#include "PCH.h"
+
+#include "Core/MainThreadQueue.h"
+#include "Core/OS.h"
+
+#include <thread>
+
+
+namespace Silex
+{
+    //============================================================================
+    // 状態
+    //----------------------------------------------------------------------------
+    // 追加されたタスクは incoming に逆順（後に追加したものが先頭）で積まれる
+    // メインスレッドはまとめて取り出して追加順に並べ直し、pending から実行する
+    //============================================================================
+    static std::atomic<MainThreadTask*> incoming = nullptr;
+
+    static MainThreadTask* pendingHead = nullptr;
+    static MainThreadTask* pendingTail = nullptr;
+
+    static std::atomic<uint32> pendingCount = 0;
+    static float               timeBudget   = 2.0f;
+    static std::thread::id     mainThreadID;
+
+    static MainThreadQueueStats stats;
+
+
+    void MainThreadQueue::Initialize()
+    {
+        mainThreadID = std::this_thread::get_id();
+        stats        = {};
+    }
+
+    void MainThreadQueue::Finalize()
+    {
+        // 残っているタスクの後始末（リソースの解放など）も行う必要があるので、破棄せずに実行する
+        Flush();
+    }
+
+    void MainThreadQueue::Push(MainThreadTask* task)
+    {
+        // 取り出し側で減算する前に加算されているように、先に数える
+        pendingCount.fetch_add(1, std::memory_order_relaxed);
+
+        MainThreadTask* head = incoming.load(std::memory_order_relaxed);
+        do
+        {
+            task->next = head;
+        }
+        while (!incoming.compare_exchange_weak(head, task, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    // 追加されたタスクを追加順に pending の末尾へ移す
+    static void CollectIncoming()
+    {
+        MainThreadTask* reversed = incoming.exchange(nullptr, std::memory_order_acquire);
+        if (reversed == nullptr)
+            return;
+
+        MainThreadTask* ordered = nullptr;
+        MainThreadTask* last    = reversed;
+
+        while (reversed)
+        {
+            MainThreadTask* next = reversed->next;
+            reversed->next = ordered;
+            ordered  = reversed;
+            reversed = next;
+        }
+
+        if (pendingTail)
+        {
+            pendingTail->next = ordered;
+        }
+        else
+        {
+            pendingHead = ordered;
+        }
+
+        pendingTail = last;
+    }
+
+    void MainThreadQueue::Execute(float budgetMilliseconds)
+    {
+        CollectIncoming();
+
+        uint64 budget   = (uint64)(budgetMilliseconds * 1000.0f);
+        uint64 begin    = OS::Get()->GetTickSeconds();
+        uint64 now      = begin;
+        uint64 maxTime  = 0;
+        uint32 executed = 0;
+
+        // 実行中に追加されたタスクは、次のフレームで実行する（同一フレーム内で無限に連鎖しないように）
+        while (pendingHead)
+        {
+            MainThreadTask* task = pendingHead;
+            pendingHead = task->next;
+
+            if (pendingHead == nullptr)
+            {
+                pendingTail = nullptr;
+            }
+
+            uint64 taskBegin = now;
+            task->execute(task);
+            now = OS::Get()->GetTickSeconds();
+
+            maxTime = std::max(maxTime, now - taskBegin);
+            executed++;
+
+            pendingCount.fetch_sub(1, std::memory_order_relaxed);
+
+            if (now - begin >= budget)
+                break;
+        }
+
+        stats.numExecuted = executed;
+        stats.numPending  = pendingCount.load(std::memory_order_relaxed);
+        stats.executeTime = (now - begin) / 1000.0f;
+        stats.maxTaskTime = maxTime / 1000.0f;
+    }
+
+    void MainThreadQueue::Flush()
+    {
+        // 実行中に追加されたタスクも含めて、空になるまで実行する
+        while (pendingCount.load(std::memory_order_acquire) != 0)
+        {
+            CollectIncoming();
+
+            while (pendingHead)
+            {
+                MainThreadTask* task = pendingHead;
+                pendingHead = task->next;
+
+                task->execute(task);
+                pendingCount.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            pendingTail = nullptr;
+        }
+    }
+
+    void MainThreadQueue::SetTimeBudget(float milliseconds)
+    {
+        timeBudget = milliseconds;
+    }
+
+    float MainThreadQueue::GetTimeBudget()
+    {
+        return timeBudget;
+    }
+
+    uint32 MainThreadQueue::GetPendingCount()
+    {
+        return pendingCount.load(std::memory_order_relaxed);
+    }
+
+    bool MainThreadQueue::IsMainThread()
+    {
+        return std::this_thread::get_id() == mainThreadID;
+    }
+
+    const MainThreadQueueStats& MainThreadQueue::GetStats()
+    {
+        return stats;
+    }
+}
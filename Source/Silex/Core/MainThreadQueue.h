@@ -0,0 +1,98 @@
+#pragma once
+#include "Core/CoreType.h"
+#include "Core/Memory.h"
+#include <atomic>
+
+
+namespace Silex
+{
+    // 直前のフレームの実行結果
+    struct MainThreadQueueStats
+    {
+        uint32 numExecuted = 0;    // 実行したタスク数
+        uint32 numPending  = 0;    // 実行しきれずに残ったタスク数（バックログ）
+        float  executeTime = 0.0f; // 実行に使った時間（ms）
+        float  maxTaskTime = 0.0f; // 1タスクの最大実行時間（ms）
+    };
+
+
+    // 追加されたタスク（関数オブジェクトは派生側に格納する）
+    struct MainThreadTask
+    {
+        using ExecuteFunction = void(*)(MainThreadTask* task);
+
+        ExecuteFunction execute = nullptr;
+        const char*     name    = nullptr;
+        MainThreadTask* next    = nullptr;
+    };
+
+
+    //=========================================================================
+    // メインスレッドキュー
+    //-------------------------------------------------------------------------
+    // GL オブジェクトの生成・転送など、メインスレッド（GL コンテキストのスレッド）でしか
+    // 行えない処理を、ワーカースレッドから後続処理として追加する
+    //
+    // 追加は任意のスレッドからロックフリーで行い、Engine::MainLoop が毎フレーム
+    // 時間予算の範囲で追加順に実行する（予算を超えた分は次のフレームに持ち越す）
+    //
+    // レンダースレッド有効時は、タスク内の GL 命令も SL_ENQUEUE_RENDER_COMMAND 経由で発行すること
+    //=========================================================================
+    class MainThreadQueue
+    {
+    public:
+
+        static void Initialize();
+        static void Finalize();
+
+        // 関数オブジェクトはムーブ（左辺値ならコピー）して保持する
+        template<typename Function>
+        static void Post(const char* name, Function&& function)
+        {
+            using FunctionT = std::decay_t<Function>;
+
+            TaskNode<FunctionT>* node = Memory::Allocate<TaskNode<FunctionT>>(Traits::Forward<Function>(function));
+            node->name    = name;
+            node->execute = [](MainThreadTask* task)
+            {
+                TaskNode<FunctionT>* node = static_cast<TaskNode<FunctionT>*>(task);
+                std::invoke(node->function);
+                Memory::Deallocate(node);
+            };
+
+            Push(node);
+        }
+
+        // 予算（ms）の範囲でタスクを実行する。予算に関わらず、少なくとも 1つは実行する
+        static void Execute(float budgetMilliseconds);
+
+        // 全てのタスクを実行する（終了時など）
+        static void Flush();
+
+        static void  SetTimeBudget(float milliseconds);
+        static float GetTimeBudget();
+
+        // 追加済みで未実行のタスク数
+        static uint32 GetPendingCount();
+
+        // 呼び出し元が Initialize を呼んだスレッド（メインスレッド）かどうか
+        static bool IsMainThread();
+
+        static const MainThreadQueueStats& GetStats();
+
+    private:
+
+        template<typename FunctionT>
+        struct TaskNode : MainThreadTask
+        {
+            template<typename Function>
+            TaskNode(Function&& function)
+                : function(Traits::Forward<Function>(function))
+            {}
+
+            FunctionT function;
+        };
+
+        static void Push(MainThreadTask* task);
+    };
+}
@@ -2,19 +2,46 @@
 #include "PCH.h"
 
 #include "Core/Memory.h"
+#include "Core/Metrics.h"
 #include "Core/Logger.h"
+#include "Core/OS.h"
 
 #include <filesystem>
 
 
 namespace Silex
 {
-    static bool s_Initialized = false;
+    // プール・ヒープからの確保回数（フレームアリーナ・std::malloc は含まない）
+    static MetricID allocationMetric = Metrics::invalidMetric;
+
+    // 先頭をラージページで確保するサイズクラス（ビット i が minBlockByteSize << i のクラス）
+    // クラス毎に 4MB が常駐し Trim で返却されないため、既定では使用しない
+    // 有効にする場合は SilexTest の MemoryPool_LargePages で効果を確認したクラスのみにする
+    static constexpr uint32 poolLargePageClasses = 0;
+
+    // ヒープの先頭をラージページで確保するサイズ（遅延コミットも返却もできず常駐するので、既定では使用しない）
+    static constexpr uint64 heapLargePageByteSize = 0;
+
+    // フレームアリーナのチャンクをラージページから確保するか
+    // チャンクはラージページ単位（2MB）に切り上がり、スレッド毎・ダブルバッファで常駐するので既定では使用しない
+    static constexpr bool frameArenaLargePages = false;
 
 
     void PoolAllocator::Initialize()
     {
-        pool.Initialize();
+        pool.Initialize(poolLargePageClasses);
+
+        allocationMetric = Metrics::RegisterCounter("Memory/Allocations");
+        Metrics::RegisterGauge("Memory/PoolAllocatedBytes", []()
+        {
+            int64 allocated = 0;
+            for (const MemoryPoolStatus& status : pool.GetStatus())
+            {
+                allocated += status.totalAllocated;
+            }
+
+            return allocated;
+        });
     }
 
     void PoolAllocator::Finalize()
@@ -22,9 +49,10 @@ namespace Silex
         pool.Finalize();
     }
 
-    void* PoolAllocator::Allocate(uint64 sizeByte)
+    void* PoolAllocator::Allocate(uint64 sizeByte, uint64 alignment)
     {
-        return pool.Allocate(sizeByte);
+        Metrics::Increment(allocationMetric);
+        return pool.Allocate(sizeByte, alignment);
     }
 
     void PoolAllocator::Deallocate(void* pointer)
@@ -32,84 +60,284 @@ namespace Silex
         pool.Deallocate(pointer);
     }
 
+    void* PoolAllocator::AllocateFromPool(uint32 poolIndex)
+    {
+        Metrics::Increment(allocationMetric);
+        return pool.AllocateFromPool(poolIndex);
+    }
 
+    void PoolAllocator::DeallocateToPool(void* pointer, uint32 poolIndex)
+    {
+        pool.DeallocateToPool(pointer, poolIndex);
+    }
 
+    void PoolAllocator::Trim()
+    {
+        pool.Trim();
+    }
 
-    void MemoryTracker::Initialize()
+    void PoolAllocator::SetReleaseIdleTime(float seconds)
     {
-        if (s_Initialized)
-            return;
+        pool.SetReleaseIdleTime(seconds);
+    }
+
+
+
+    void HeapAllocator::Initialize()
+    {
+        // アドレス空間のみ予約し、使用量に応じてコミットする（heapLargePageByteSize が 0 でなければ別途ラージページで確保する）
+        heap.Initialize(4ull * 1024 * 1024 * 1024, heapLargePageByteSize);
+
+        Metrics::RegisterGauge("Memory/HeapUsedBytes", []()
+        {
+            return (int64)heap.GetStatus().usedSize;
+        });
+    }
+
+    void HeapAllocator::Finalize()
+    {
+        heap.Finalize();
+    }
+
+    void* HeapAllocator::Allocate(uint64 sizeByte, uint64 alignment)
+    {
+        Metrics::Increment(allocationMetric);
 
-        allocationData = Memory::Construct<AllocationMap>(Memory::Malloc(sizeof(AllocationMap)));;
-        allocationData->totalAllocationSize = 0;
+        void* ptr = heap.Allocate(sizeByte, alignment);
+        SL_ASSERT(ptr != nullptr, "ヒープの容量が不足しています");
 
-        s_Initialized = true;
+        return ptr;
     }
 
-    void MemoryTracker::Finalize()
+    void HeapAllocator::Deallocate(void* pointer)
     {
-        s_Initialized = false;
+        heap.Deallocate(pointer);
+    }
 
-        Memory::Destruct(allocationData);
-        Memory::Free(allocationData);
 
-        allocationData = nullptr;
+
+    void Memory::VerifyAlignment(const void* ptr, uint64 alignment)
+    {
+        SL_ASSERT((alignment & (alignment - 1)) == 0, "アライメントは2のべき乗である必要があります");
+        SL_ASSERT(IsAligned(ptr, alignment),          "確保したメモリのアライメントが不正です");
     }
 
-    void MemoryTracker::RecordAllocate(void* allocatedPtr, size_t size, const char* desc, const char* file, size_t line)
+    void Memory::LogLargePageStatus()
     {
-        // Init() 呼び出し前に、静的変数がoperator new() を呼び出す可能性があるため
-        if (!s_Initialized)
-            Initialize();
+        uint64 largePageSize = OS::Get()->GetLargePageSize();
+        if (largePageSize == 0)
+        {
+            SL_LOG_INFO("ラージページは使用できません（SeLockMemoryPrivilege が付与されていません）");
+            return;
+        }
 
+        const uint64 mb = 1024 * 1024;
+        SL_LOG_INFO("ラージページ: {} KB", largePageSize / 1024);
+        SL_LOG_INFO("  メモリプール    : {} MB", PoolAllocator::GetLargePageByteSize() / mb);
+        SL_LOG_INFO("  ヒープ          : {} MB", HeapAllocator::GetStatus().largePageSize / mb);
+
+        // フレームアリーナはチャンクを最初に確保した時点で結果を出力する（AllocateChunk）
+        if (!frameArenaLargePages)
         {
-            std::scoped_lock lock(allocationData->mutex);
+            SL_LOG_INFO("  フレームアリーナ: {} MB（無効）", FrameArena::GetLargePageByteSize() / mb);
+        }
+    }
+
 
-            AllocationElement& element = allocationData->memoryMap[allocatedPtr];
-            element.size = size;
-            element.file = file;
-            element.line = line;
-            element.desc = desc;
 
-            allocationData->totalAllocationSize += size;
+
+    //============================================================================
+    // フレームアリーナ
+    //============================================================================
+    static constexpr uint64 frameArenaChunkByteSize = 256 * 1024;
+
+    FrameArena::Chunk* FrameArena::AllocateChunk(uint64 sizeByte)
+    {
+        // 有効かつラージページが使えれば、ページサイズ単位に切り上げてラージページから確保する
+        uint64 largePageSize = frameArenaLargePages ? OS::Get()->GetLargePageSize() : 0;
+        if (largePageSize != 0)
+        {
+            uint64 allocateSize = (sizeof(Chunk) + sizeByte + (largePageSize - 1)) & ~(largePageSize - 1);
+
+            Chunk* chunk = static_cast<Chunk*>(OS::Get()->AllocateLargePages(allocateSize));
+
+            // 起動時にはチャンクが無いので、最初のチャンクでラージページを使用できたかを報告する
+            static std::atomic<bool> reported = false;
+            if (!reported.exchange(true, std::memory_order_relaxed))
+            {
+                if (chunk) SL_LOG_INFO("フレームアリーナ: ラージページでチャンクを確保しました（{} KB）", allocateSize / 1024);
+                else       SL_LOG_WARN("フレームアリーナ: ラージページを確保できないため、通常のページで確保します");
+            }
+
+            if (chunk)
+            {
+                chunk->size      = allocateSize - sizeof(Chunk);
+                chunk->largePage = true;
+
+                largePageByteSize.fetch_add(allocateSize, std::memory_order_relaxed);
+                return chunk;
+            }
         }
+
+        Chunk* chunk = static_cast<Chunk*>(Memory::Malloc(sizeof(Chunk) + sizeByte));
+        chunk->size      = sizeByte;
+        chunk->largePage = false;
+
+        return chunk;
     }
 
-    void MemoryTracker::RecordDeallocate(void* ptr)
+    void FrameArena::ReleaseChunk(Chunk* chunk)
     {
-        if (ptr == nullptr)
-            return;
+        if (chunk->largePage)
+        {
+            uint64 allocateSize = sizeof(Chunk) + chunk->size;
 
-        // メモリートラッカー解放後のアクセスを抑制
-        if (s_Initialized)
+            largePageByteSize.fetch_sub(allocateSize, std::memory_order_relaxed);
+            OS::Get()->ReleaseMemory(chunk, allocateSize);
+        }
+        else
+        {
+            Memory::Free(chunk);
+        }
+    }
+
+    void FrameArena::Buffer::Reset()
+    {
+        current = head;
+        cursor  = head ? reinterpret_cast<byte*>(head + 1) : nullptr;
+        end     = head ? cursor + head->size               : nullptr;
+    }
+
+    void* FrameArena::Buffer::Allocate(uint64 sizeByte, uint64 alignment)
+    {
+        byte* ptr = reinterpret_cast<byte*>(((uint64)cursor + (alignment - 1)) & ~(alignment - 1));
+        if (cursor && ptr + sizeByte <= end)
         {
-            std::scoped_lock lock(allocationData->mutex);
+            cursor = ptr + sizeByte;
+            return ptr;
+        }
+
+        // 後続のチャンク（前フレームまでに確保済み）から収まるものを探す
+        uint64 requiredSize = sizeByte + alignment;
+
+        Chunk* chunk = current ? current->next : nullptr;
+        while (chunk && chunk->size < requiredSize)
+        {
+            chunk = chunk->next;
+        }
 
-            auto itr = allocationData->memoryMap.find(ptr);
-            if (itr != allocationData->memoryMap.end())
+        // 見つからなければ新規チャンクを現在のチャンクの後ろに追加する（次フレーム以降も再利用する）
+        if (chunk == nullptr)
+        {
+            uint64 chunkSize = std::max(frameArenaChunkByteSize, requiredSize);
+
+            chunk = AllocateChunk(chunkSize);
+
+            if (current)
             {
-                auto& [p, element] = *itr;
+                chunk->next   = current->next;
+                current->next = chunk;
+            }
+            else
+            {
+                chunk->next = head;
+                head        = chunk;
+            }
+        }
+
+        current = chunk;
+        cursor  = reinterpret_cast<byte*>(chunk + 1);
+        end     = cursor + chunk->size;
+
+        ptr    = reinterpret_cast<byte*>(((uint64)cursor + (alignment - 1)) & ~(alignment - 1));
+        cursor = ptr + sizeByte;
+
+        return ptr;
+    }
+
+    void FrameArena::Buffer::Release()
+    {
+        Chunk* chunk = head;
+        while (chunk)
+        {
+            Chunk* next = chunk->next;
+            ReleaseChunk(chunk);
+            chunk = next;
+        }
+
+        *this = Buffer();
+    }
+
+    FrameArena::ThreadArena* FrameArena::GetThreadArena()
+    {
+        // Finalize 後に再初期化された場合は、古いサブアリーナを参照しないよう世代で判定する
+        static thread_local ThreadArena* threadArena      = nullptr;
+        static thread_local uint64       threadGeneration = 0;
+
+        uint64 currentGeneration = generation.load(std::memory_order_acquire);
+        if (threadArena == nullptr || threadGeneration != currentGeneration)
+        {
+            threadArena      = Memory::Construct<ThreadArena>(Memory::Malloc(sizeof(ThreadArena)));
+            threadGeneration = currentGeneration;
+
+            // サブアリーナはスレッド終了後も Finalize まで保持する（フレームデータが参照している可能性があるため）
+            std::scoped_lock lock(arenaListMutex);
+            threadArena->next = arenaList;
+            arenaList         = threadArena;
+        }
 
-                allocationData->totalAllocationSize -= element.size;
-                allocationData->memoryMap.erase(ptr);
+        return threadArena;
+    }
+
+    void FrameArena::Initialize()
+    {
+        frameCount.store(0, std::memory_order_relaxed);
+        generation.fetch_add(1, std::memory_order_release);
+    }
+
+    void FrameArena::Finalize()
+    {
+        std::scoped_lock lock(arenaListMutex);
+
+        ThreadArena* arena = arenaList;
+        while (arena)
+        {
+            ThreadArena* next = arena->next;
+
+            for (Buffer& buffer : arena->buffers)
+            {
+                buffer.Release();
             }
+
+            Memory::Destruct(arena);
+            Memory::Free(arena);
+
+            arena = next;
         }
+
+        arenaList = nullptr;
+        generation.fetch_add(1, std::memory_order_release);
+    }
+
+    void FrameArena::NextFrame()
+    {
+        frameCount.fetch_add(1, std::memory_order_release);
     }
 
-    void MemoryTracker::DumpMemoryStats()
+    void* FrameArena::Allocate(uint64 sizeByte, uint64 alignment)
     {
-#if SL_ENABLE_TRACK_HEAP_ALLOCATION
-        SL_LOG_DEBUG("***************************************************************************************************");
-        SL_LOG_DEBUG("MemoryUsage: {} byte", s_AllocationData->TotalAllocationSize);
+        SL_ASSERT((alignment & (alignment - 1)) == 0, "アライメントは2のべき乗である必要があります");
 
-        if (!s_AllocationData->memoryMap.empty())
-        SL_LOG_DEBUG("***************************************************************************************************");
+        uint64  frame  = frameCount.load(std::memory_order_acquire);
+        Buffer& buffer = GetThreadArena()->buffers[frame & 1];
 
-        for (auto& [ptr, info] : s_AllocationData->memoryMap)
+        // このスレッドで今フレーム初めての確保なら、2フレーム前のデータを破棄する
+        if (buffer.frame != frame)
         {
-            SL_LOG_DEBUG(" {:>8} byte | {:<16} | {} [{}]", info.size, info.desc, info.file, info.line);
+            buffer.Reset();
+            buffer.frame = frame;
         }
-        SL_LOG_DEBUG("***************************************************************************************************");
-#endif
+
+        return buffer.Allocate(sizeByte, alignment);
     }
 }
@@ -3,11 +3,16 @@
 #include "Core/Macros.h"
 #include "Core/CoreType.h"
 #include "Core/MemoryPool.h"
+#include "Core/TLSFHeap.h"
+#include "Core/MemoryTracker.h"
+#include "Core/ObjectPool.h"
 
 #include <algorithm>
 #include <map>
+#include <vector>
 #include <unordered_map>
 #include <mutex>
+#include <atomic>
 
 
 //===============================================================
@@ -58,14 +63,32 @@ namespace Silex
         static void Initialize();
         static void Finalize();
 
-        static void* Allocate(uint64 sizeByte);
+        static void* Allocate(uint64 sizeByte, uint64 alignment = MemoryPool::minBlockByteSize);
         static void  Deallocate(void* pointer);
 
-        static const std::array<MemoryPoolStatus, 6>& GetStatus()
+        static void* AllocateFromPool(uint32 poolIndex);
+        static void  DeallocateToPool(void* pointer, uint32 poolIndex);
+
+        static bool Contains(const void* pointer)
+        {
+            return pool.Contains(pointer);
+        }
+
+        // 一定時間使用されていないスラブを OS に返却する
+        static void Trim();
+        static void SetReleaseIdleTime(float seconds);
+
+        static std::array<MemoryPoolStatus, MemoryPool::numPools> GetStatus()
         {
             return pool.GetStatus();
         }
 
+        // ラージページで確保した領域の合計サイズ
+        static uint64 GetLargePageByteSize()
+        {
+            return pool.GetLargePageByteSize();
+        }
+
     private:
 
         static inline MemoryPool pool;
@@ -73,44 +96,161 @@ namespace Silex
 
 
     //===============================================================
-    // デバッグ用メモリトラッカー
+    // ヒープアロケータ（プールに収まらない 1KB 超の確保）
+    //===============================================================
+    class HeapAllocator
+    {
+    public:
+
+        static void Initialize();
+        static void Finalize();
+
+        static void* Allocate(uint64 sizeByte, uint64 alignment = TLSFHeap::alignment);
+        static void  Deallocate(void* pointer);
+
+        static TLSFHeapStatus GetStatus()
+        {
+            return heap.GetStatus();
+        }
+
+    private:
+
+        static inline TLSFHeap heap;
+    };
+
+
+    //===============================================================
+    // フレームアリーナ
+    //---------------------------------------------------------------
+    // フレーム内でのみ使用する一時データ用の線形アロケーター
+    // スレッド毎のサブアリーナからポインタを進めるだけで確保し、個別の解放は行わない
+    // ダブルバッファなので、確保したメモリは次のフレームの終了まで有効
     //===============================================================
-    class MemoryTracker
+    class FrameArena
     {
     public:
 
         static void Initialize();
         static void Finalize();
 
-        static void RecordAllocate(void* allocatedPtr, size_t size, const char* typeName, const char* file, size_t line);
-        static void RecordDeallocate(void* ptr);
-        static void DumpMemoryStats();
+        // フレームを進め、2フレーム前に確保したメモリを再利用可能にする（フレーム毎に1回呼び出す）
+        static void NextFrame();
+
+        static void* Allocate(uint64 sizeByte, uint64 alignment = alignof(std::max_align_t));
+
+        // ラージページから確保したチャンクの合計サイズ
+        static uint64 GetLargePageByteSize()
+        {
+            return largePageByteSize.load(std::memory_order_relaxed);
+        }
 
     private:
 
-        // メモリデータ
-        struct AllocationElement
+        struct Chunk
         {
-            size_t      size = {};
-            const char* desc = {};
-            const char* file = {};
-            size_t      line = {};
+            Chunk* next;
+            uint64 size;
+            bool   largePage;
         };
 
-        // メモリデータコンテナ
-        struct AllocationMap
+        // 1フレーム分のサブアリーナ（チャンクはフレームを跨いで再利用する）
+        struct Buffer
         {
-            using Type              = void*;
-            using AllocatorType     = DefaultAllocator<std::pair<const Type, AllocationElement>>;
-            using AllocationHashMap = std::unordered_map<Type, AllocationElement, std::hash<Type>, std::equal_to<>, AllocatorType>;
+            Chunk* head    = nullptr;
+            Chunk* current = nullptr;
+            byte*  cursor  = nullptr;
+            byte*  end     = nullptr;
+            uint64 frame   = ~0ull;
+
+            void  Reset();
+            void* Allocate(uint64 sizeByte, uint64 alignment);
+            void  Release();
+        };
 
-            AllocationHashMap memoryMap;
-            std::mutex        mutex;
-            uint64            totalAllocationSize;
+        struct ThreadArena
+        {
+            std::array<Buffer, 2> buffers;
+            ThreadArena*          next = nullptr;
         };
 
+        static ThreadArena* GetThreadArena();
+        static Chunk*       AllocateChunk(uint64 sizeByte);
+        static void         ReleaseChunk(Chunk* chunk);
+
+    private:
+
+        static inline std::atomic<uint64> frameCount        = 0;
+        static inline std::atomic<uint64> generation        = 0;
+        static inline std::atomic<uint64> largePageByteSize = 0;
+
+        static inline std::mutex   arenaListMutex;
+        static inline ThreadArena* arenaList = nullptr;
+    };
+
+
+    //===============================================================
+    // フレームアリーナ STL アロケーター
+    //---------------------------------------------------------------
+    // deallocate は何もしないので、コンテナはフレーム毎に作り直す
+    // (clear ではバケット配列などが前フレームのメモリに残るため)
+    //===============================================================
+    template <typename T>
+    class FrameAllocator
+    {
+    public:
+
+        using value_type      = T;
+        using is_always_equal = std::true_type;
+
+        FrameAllocator() = default;
 
-        static inline AllocationMap* allocationData = nullptr;
+        template <typename U>
+        FrameAllocator(const FrameAllocator<U>&) noexcept {}
+
+        T* allocate(std::size_t n)
+        {
+            return static_cast<T*>(FrameArena::Allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T* p, std::size_t) noexcept
+        {
+        }
+
+        template <typename U>
+        bool operator==(const FrameAllocator<U>&) const noexcept { return true; }
+    };
+
+    template<typename T>
+    using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+    template<typename Key, typename Value, typename Hash = std::hash<Key>>
+    using FrameHashMap = std::unordered_map<Key, Value, Hash, std::equal_to<Key>, FrameAllocator<std::pair<const Key, Value>>>;
+
+
+    //===============================================================
+    // アライメント検証（デバッグビルドのみ）
+    //===============================================================
+#if SL_DEBUG
+    #define SL_VERIFY_ALIGNMENT(ptr, alignment) ::Silex::Memory::VerifyAlignment(ptr, alignment)
+#else
+    #define SL_VERIFY_ALIGNMENT(ptr, alignment)
+#endif
+
+
+    //===============================================================
+    // キャッシュライン境界に揃えたラッパー
+    //---------------------------------------------------------------
+    // スレッド毎のデータを配列に並べる場合に、隣接要素との偽共有を防ぐ
+    //===============================================================
+    template<typename T>
+    struct SL_CACHE_ALIGN CacheAligned
+    {
+        T value;
+
+        T*       operator->()       { return &value; }
+        const T* operator->() const { return &value; }
+        T&       operator*()        { return value;  }
+        const T& operator*()  const { return value;  }
     };
 
 
@@ -122,14 +262,25 @@ namespace Silex
         {
             MemoryTracker::Initialize();
             PoolAllocator::Initialize();
+            HeapAllocator::Initialize();
+            ObjectPoolBase::Initialize();
+            FrameArena::Initialize();
+
+            LogLargePageStatus();
         }
 
         static void Finalize()
         {
+            FrameArena::Finalize();
+            ObjectPoolBase::Finalize();
+            HeapAllocator::Finalize();
             PoolAllocator::Finalize();
             MemoryTracker::Finalize();
         }
 
+        // ラージページの使用状況をログに出力する
+        static void LogLargePageStatus();
+
         //=======================================
         // コンストラクタ / デストラクタ 呼び出し
         //=======================================
@@ -159,22 +310,179 @@ namespace Silex
         }
 
         //=======================================
-        // プールから確保
+        // プール・ヒープから確保
+        //---------------------------------------
+        // 1KB 以下はメモリプール、それ以上は TLSF ヒープから確保する
+        // UseObjectPool を特殊化した型は、型専用のオブジェクトプールから確保する
+        // アライメントは alignof(T) 以上を保証する
         //=======================================
         template<typename T, typename... Args>
-        static T* Allocate(Args&& ... args)
+        SL_ALLOCATION_ENTRY static T* Allocate(Args&& ... args)
         {
-            static_assert(sizeof(T) <= 1024);
-
-            void* ptr = PoolAllocator::Allocate(sizeof(T));
-            return Memory::Construct<T>(ptr, Traits::Forward<Args>(args)...);
+            return Memory::AllocateAlignedAt<T, alignof(T)>(SL_ALLOCATION_CALL_SITE(), Traits::Forward<Args>(args)...);
         }
 
         template<typename T>
         static void Deallocate(T* ptr)
         {
+            Memory::DeallocateAligned<T, alignof(T)>(ptr);
+        }
+
+        //=======================================
+        // アライメントを指定して確保（SIMD 用データなど）
+        //---------------------------------------
+        // 解放は同じアライメントを指定した DeallocateAligned で行う
+        //=======================================
+        template<typename T, uint64 Alignment, typename... Args>
+        SL_ALLOCATION_ENTRY static T* AllocateAligned(Args&& ... args)
+        {
+            return Memory::AllocateAlignedAt<T, Alignment>(SL_ALLOCATION_CALL_SITE(), Traits::Forward<Args>(args)...);
+        }
+
+        template<typename T, uint64 Alignment>
+        static void DeallocateAligned(T* ptr)
+        {
+            // 基底クラスのポインタで派生クラスを解放する場合は sizeof(T) が実際のサイズと異なり、
+            // オブジェクトプールの型もプール外（基底クラスとして確保された派生クラス、プールの初期化前に
+            // 確保されたものなど）のオブジェクトがあり得るので、どちらもアドレスから確保元を求める
+            constexpr bool resolveByAddress = UseObjectPool<T>::Value || (std::is_polymorphic_v<T> && !std::is_final_v<T>);
+
+            // オブジェクトプールの走査対象から、破棄を始める前に外す
+            if constexpr (resolveByAddress)
+            {
+                if (ObjectPoolBase::Contains(ptr))
+                    ObjectPoolBase::RetireAny((void*)ptr);
+            }
+
             Memory::Destruct(ptr);
-            PoolAllocator::Deallocate((void*)ptr);
+
+            if constexpr (resolveByAddress)
+            {
+                Memory::DeallocateBytes((void*)ptr);
+            }
+            else if constexpr (std::max<uint64>(sizeof(T), Alignment) <= MemoryPool::maxBlockByteSize)
+            {
+                constexpr uint32 poolIndex = MemoryPool::GetSizeClass(std::max<uint64>(sizeof(T), Alignment));
+                PoolAllocator::DeallocateToPool((void*)ptr, poolIndex);
+            }
+            else
+            {
+                HeapAllocator::Deallocate((void*)ptr);
+            }
+        }
+
+        //=======================================
+        // キャッシュライン境界に揃えて確保（スレッド毎のデータなど）
+        //=======================================
+        template<typename T, typename... Args>
+        SL_ALLOCATION_ENTRY static T* AllocateCacheAligned(Args&& ... args)
+        {
+            return Memory::AllocateAlignedAt<T, std::max<uint64>(alignof(T), SL_CACHE_LINE_SIZE)>(SL_ALLOCATION_CALL_SITE(), Traits::Forward<Args>(args)...);
+        }
+
+        template<typename T>
+        static void DeallocateCacheAligned(T* ptr)
+        {
+            Memory::DeallocateAligned<T, std::max<uint64>(alignof(T), SL_CACHE_LINE_SIZE)>(ptr);
+        }
+
+        SL_ALLOCATION_ENTRY static void* AllocateCacheAlignedBytes(uint64 sizeByte)
+        {
+            return Memory::AllocateBytesAt(sizeByte, SL_CACHE_LINE_SIZE, SL_ALLOCATION_CALL_SITE());
+        }
+
+        SL_FORCEINLINE static bool IsAligned(const void* ptr, uint64 alignment)
+        {
+            return ((uint64)ptr & (alignment - 1)) == 0;
+        }
+
+        // 確保したメモリが指定アライメントを満たしているか検証する（デバッグビルドのみ）
+        static void VerifyAlignment(const void* ptr, uint64 alignment);
+
+        //=======================================
+        // バイト単位で確保（バッファなど）
+        //=======================================
+        SL_ALLOCATION_ENTRY static void* AllocateBytes(uint64 sizeByte, uint64 alignment = alignof(std::max_align_t))
+        {
+            return Memory::AllocateBytesAt(sizeByte, alignment, SL_ALLOCATION_CALL_SITE());
+        }
+
+        static void DeallocateBytes(void* ptr)
+        {
+            if (PoolAllocator::Contains(ptr))
+            {
+                PoolAllocator::Deallocate(ptr);
+            }
+            else if (ObjectPoolBase::Contains(ptr))
+            {
+                ObjectPoolBase::DeallocateAny(ptr);
+            }
+            else
+            {
+                HeapAllocator::Deallocate(ptr);
+            }
+        }
+
+    private:
+
+        //=======================================
+        // 確保の実体（callSite は入口で取得した確保元）
+        //=======================================
+        template<typename T, uint64 Alignment, typename... Args>
+        SL_FORCEINLINE static T* AllocateAlignedAt(const void* callSite, Args&& ... args)
+        {
+            static_assert((Alignment & (Alignment - 1)) == 0, "アライメントは2のべき乗である必要があります");
+            static_assert(Alignment >= alignof(T),            "alignof(T) 未満のアライメントは指定できません");
+
+            void* ptr = nullptr;
+
+            if constexpr (UseObjectPool<T>::Value)
+            {
+                static_assert(Alignment == alignof(T), "オブジェクトプールの型にはアライメントを指定できません");
+                ptr = ObjectPool<T>::Get().Allocate();
+            }
+            else if constexpr (std::max<uint64>(sizeof(T), Alignment) <= MemoryPool::maxBlockByteSize)
+            {
+                // サイズクラスはコンパイル時に決定する（ブロックはブロックサイズ境界に配置される）
+                constexpr uint32 poolIndex = MemoryPool::GetSizeClass(std::max<uint64>(sizeof(T), Alignment));
+                ptr = PoolAllocator::AllocateFromPool(poolIndex);
+            }
+            else
+            {
+                ptr = HeapAllocator::Allocate(sizeof(T), std::max<uint64>(Alignment, TLSFHeap::alignment));
+            }
+
+            SL_VERIFY_ALIGNMENT(ptr, Alignment);
+            SL_TRACK_ALLOCATION(sizeof(T), GetTrackingTypeName<T>(), callSite);
+
+            T* object = Memory::Construct<T>(ptr, Traits::Forward<Args>(args)...);
+
+            // コンストラクタが完了してから走査の対象にする
+            if constexpr (UseObjectPool<T>::Value)
+            {
+                ObjectPool<T>::Get().Publish(object);
+            }
+
+            return object;
+        }
+
+        SL_FORCEINLINE static void* AllocateBytesAt(uint64 sizeByte, uint64 alignment, const void* callSite)
+        {
+            void* ptr = nullptr;
+
+            if (std::max(sizeByte, alignment) <= MemoryPool::maxBlockByteSize)
+            {
+                ptr = PoolAllocator::Allocate(sizeByte, alignment);
+            }
+            else
+            {
+                ptr = HeapAllocator::Allocate(sizeByte, std::max<uint64>(alignment, TLSFHeap::alignment));
+            }
+
+            SL_VERIFY_ALIGNMENT(ptr, alignment);
+            SL_TRACK_ALLOCATION(sizeByte, "bytes", callSite);
+
+            return ptr;
         }
     };
 
@@ -3,26 +3,13 @@
 
 #include "Core/MemoryPool.h"
 #include "Core/Memory.h"
+#include "Core/OS.h"
 
 
 namespace Silex
 {
     namespace Internal
     {
-        // 最上位ビット側から見て最初に見つかったビットの位置を返す
-        SL_FORCEINLINE static ulong CountSetBitFromTop(uint64 value)
-        {
-            ulong index; _BitScanReverse64(&index, value);
-            return index;
-        }
-
-        // 最下位ビット側から見て最初に見つかったビットの位置を返す
-        SL_FORCEINLINE static ulong CountSetBitFromLast(uint64 value)
-        {
-            ulong index; _BitScanForward64(&index, value);
-            return index;
-        }
-
         //***********************************************************************************
         // 最も小さいサイズのメモリブロックのサイズ(現在は32)が0ビットとなるようにビットシフトしたビット列から
         // 最も位が大きいビットのビットインデックスを求める。
@@ -44,21 +31,9 @@ namespace Silex
         // m_BlockSize[4] ==  512
         // m_BlockSize[5] == 1024
 
-        //template<class Size>
-        //static constexpr uint32 SelectPoolIndexFromSize(Size requestByteSize)
-        //{
-        //    if      constexpr(  1 <= requestByteSize && requestByteSize <=   32) { return 0; }
-        //    else if constexpr( 33 <= requestByteSize && requestByteSize <=   64) { return 1; }
-        //    else if constexpr( 65 <= requestByteSize && requestByteSize <=  128) { return 2; }
-        //    else if constexpr(129 <= requestByteSize && requestByteSize <=  256) { return 3; }
-        //    else if constexpr(257 <= requestByteSize && requestByteSize <=  512) { return 4; }
-        //    else if constexpr(513 <= requestByteSize && requestByteSize <= 1024) { return 5; }
-        //
-        //    return 0;
-        //}
-
         //====================================================
         // if分岐の方がパフォーマンスが良かったので、ビット操作を行わない
+        // コンパイル時にサイズが決まる場合は MemoryPool::GetSizeClass を使用する
         //====================================================
         static uint32 SelectPoolIndex(uint32 requestByteSize)
         {
@@ -77,87 +52,662 @@ namespace Silex
     //============================================================================
     // プールデータ
     //============================================================================
-    void MemoryPool::Pool::Create(const uint32 chunkSize, const uint32 poolSize)
+    void MemoryPool::Pool::Create(byte* reservedBase, const uint32 chunkSize, const uint32 numLargePageSlabs)
     {
+        static_assert(sizeof(Slab) <= slabHeaderByteSize);
+
+        // 先頭ブロックをブロックサイズ境界に揃える（管理データ領域より小さい場合は管理データの直後）
+        base          = reservedBase;
         blockByteSize = chunkSize;
-        numBlocks     = poolSize / blockByteSize;
-        ptr           = Memory::Malloc(poolSize + (numBlocks * sizeof(Header)));
+        blockOffset   = std::max<uint32>(slabHeaderByteSize, blockByteSize);
+        blocksPerSlab = (slabByteSize - blockOffset) / blockByteSize;
+
+        largePageSlabs = numLargePageSlabs;
+
+        committedSlabs = static_cast<uint8*>(Memory::Malloc(maxSlabs));
+        std::memset(committedSlabs, 0, maxSlabs);
+
+        freeSlabs     = nullptr;
+        freeSlabsTail = nullptr;
+        numSlabs      = 0;
+        peakSlabs     = 0;
+        slabWatermark = 0;
+    }
+
+    void MemoryPool::Pool::Destroy()
+    {
+        Memory::Free(committedSlabs);
 
-        for (uint32 i = 0; i < numBlocks; i++)
+        base           = nullptr;
+        committedSlabs = nullptr;
+        freeSlabs      = nullptr;
+        freeSlabsTail  = nullptr;
+        numSlabs       = 0;
+        slabWatermark  = 0;
+    }
+
+    MemoryPool::Slab* MemoryPool::Pool::CommitSlab(uint64 time)
+    {
+        // 返却済みのスラブを優先して再利用し、なければ未使用領域を切り出す
+        uint32 slabIndex = slabWatermark;
+        if (numSlabs < slabWatermark)
+        {
+            for (uint32 i = 0; i < slabWatermark; i++)
+            {
+                if (!committedSlabs[i])
+                {
+                    slabIndex = i;
+                    break;
+                }
+            }
+        }
+
+        if (slabIndex >= maxSlabs)
+            return nullptr;
+
+        // ラージページの領域はコミット済み
+        byte* address = base + slabIndex * slabByteSize;
+        if (slabIndex >= largePageSlabs && !OS::Get()->CommitMemory(address, slabByteSize))
+            return nullptr;
+
+        committedSlabs[slabIndex] = 1;
+        slabWatermark = std::max(slabWatermark, slabIndex + 1);
+        peakSlabs     = std::max(peakSlabs, ++numSlabs);
+
+        Slab* slab = Memory::Construct<Slab>(address);
+        slab->idleStartTime = time;
+
+        // 先頭アドレスのブロックから使用されるよう、末尾から連結する
+        byte* blocks = address + blockOffset;
+        for (uint32 i = blocksPerSlab; i > 0; i--)
         {
-            uint64 address = (uint64)ptr + (i * sizeof(Header)) + (i * blockByteSize);
-            PushFront(reinterpret_cast<Header*>(address));
+            Block* block = reinterpret_cast<Block*>(blocks + (uint64)(i - 1) * blockByteSize);
+            block->next    = slab->freeList;
+            slab->freeList = block;
         }
+
+        LinkFreeSlab(slab);
+        return slab;
     }
 
-    void MemoryPool::Pool::Destroy()
+    void MemoryPool::Pool::DecommitSlab(Slab* slab)
+    {
+        uint32 slabIndex = (uint32)(((byte*)slab - base) / slabByteSize);
+
+        UnlinkFreeSlab(slab);
+        OS::Get()->DecommitMemory(slab, slabByteSize);
+
+        committedSlabs[slabIndex] = 0;
+        numSlabs--;
+    }
+
+    MemoryPool::Slab* MemoryPool::Pool::GetSlab(Block* block) const
+    {
+        // スラブは予約領域内でスラブサイズ境界に配置されている
+        return reinterpret_cast<Slab*>((uint64)block & ~(slabByteSize - 1));
+    }
+
+    void MemoryPool::Pool::LinkFreeSlab(Slab* slab)
+    {
+        slab->prev = freeSlabsTail;
+        slab->next = nullptr;
+
+        if (freeSlabsTail) freeSlabsTail->next = slab;
+        else               freeSlabs           = slab;
+
+        freeSlabsTail = slab;
+    }
+
+    void MemoryPool::Pool::UnlinkFreeSlab(Slab* slab)
+    {
+        if (slab->prev) slab->prev->next = slab->next;
+        else            freeSlabs        = slab->next;
+
+        if (slab->next) slab->next->prev = slab->prev;
+        else            freeSlabsTail    = slab->prev;
+
+        slab->prev = nullptr;
+        slab->next = nullptr;
+    }
+
+    uint32 MemoryPool::Pool::PopBlocks(Block** outFirst, uint32 maxCount)
+    {
+        Block* first = nullptr;
+        uint32  count = 0;
+
+        while (count < maxCount && freeSlabs)
+        {
+            Slab*   slab   = freeSlabs;
+            Block* block = slab->freeList;
+
+            slab->freeList = block->next;
+            slab->usedBlocks++;
+
+            if (slab->freeList == nullptr)
+                UnlinkFreeSlab(slab);
+
+            block->next = first;
+            first       = block;
+            count++;
+        }
+
+        *outFirst = first;
+        return count;
+    }
+
+    void MemoryPool::Pool::PushBlocks(Block* first, uint64 time)
+    {
+        Block* block = first;
+        while (block)
+        {
+            Block* next = block->next;
+            Slab*  slab = GetSlab(block);
+
+            // 満杯だったスラブは空きスラブリストに戻す
+            if (slab->freeList == nullptr)
+                LinkFreeSlab(slab);
+
+            block->next    = slab->freeList;
+            slab->freeList = block;
+
+            if (--slab->usedBlocks == 0)
+                slab->idleStartTime = time;
+
+            block = next;
+        }
+    }
+
+
+    //============================================================================
+    // スレッドキャッシュ
+    //============================================================================
+    MemoryPool::ThreadCache::~ThreadCache()
+    {
+        // プール終了後にスレッドが破棄された場合は、既に解放済みなので何もしない
+        MemoryPool* pool = owner.load(std::memory_order_acquire);
+        if (pool && pool->initialized.load(std::memory_order_acquire))
+        {
+            for (uint32 i = 0; i < numPools; i++)
+            {
+                pool->Drain(bins[i], i, bins[i].count);
+            }
+
+            pool->UnregisterCache(this);
+        }
+    }
+
+    MemoryPool::ThreadCache& MemoryPool::GetThreadCache()
+    {
+        static thread_local ThreadCache cache;
+        return cache;
+    }
+
+    void MemoryPool::AdoptCache(ThreadCache& cache)
+    {
+        MemoryPool* previous = cache.owner.load(std::memory_order_acquire);
+        if (previous)
+        {
+            // 別のプールのブロックを、このプールから確保しないように元のプールへ戻す
+            for (uint32 i = 0; i < numPools; i++)
+            {
+                previous->Drain(cache.bins[i], i, cache.bins[i].count);
+            }
+
+            previous->UnregisterCache(&cache);
+        }
+        else
+        {
+            // 終了したプールのブロックが残っている場合は破棄する
+            cache.bins = {};
+            for (auto& allocated : cache.allocatedBlocks)
+            {
+                allocated.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        RegisterCache(&cache);
+    }
+
+    void MemoryPool::RegisterCache(ThreadCache* cache)
+    {
+        std::scoped_lock lock(cacheListMutex);
+
+        cache->owner.store(this, std::memory_order_release);
+        cache->prevCache = nullptr;
+        cache->nextCache = cacheList;
+
+        if (cacheList)
+            cacheList->prevCache = cache;
+
+        cacheList = cache;
+    }
+
+    void MemoryPool::UnregisterCache(ThreadCache* cache)
+    {
+        std::scoped_lock lock(cacheListMutex);
+
+        if (cache->prevCache) cache->prevCache->nextCache = cache->nextCache;
+        else                  cacheList                   = cache->nextCache;
+
+        if (cache->nextCache)
+            cache->nextCache->prevCache = cache->prevCache;
+
+        // 統計を引き継ぐ
+        for (uint32 i = 0; i < numPools; i++)
+        {
+            retiredBlocks[i].fetch_add(cache->allocatedBlocks[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            cache->allocatedBlocks[i].store(0, std::memory_order_relaxed);
+        }
+
+        cache->owner.store(nullptr, std::memory_order_release);
+        cache->nextCache = nullptr;
+        cache->prevCache = nullptr;
+    }
+
+    // キャッシュとデポ間で移動するバッチのブロック数（16KB 相当, 8 ～ 64 ブロック）
+    uint32 MemoryPool::GetBatchBlockCount(uint32 index)
+    {
+        constexpr uint32 batchByteSize = 16 * 1024;
+        constexpr uint32 minBlockSize  = 32;
+
+        return std::clamp<uint32>(batchByteSize / (minBlockSize << index), 8, 64);
+    }
+
+    MemoryPool::Block* MemoryPool::Refill(ThreadCache::Bin& bin, uint32 index)
+    {
+        uint32 batchCount = GetBatchBlockCount(index);
+
+        while (true)
+        {
+            // デポからバッチを取得（ロックフリー）
+            Block* batch;
+            if (depots[index].Pop(batch))
+            {
+                sharedFreeBlocks[index].fetch_sub(batchCount, std::memory_order_relaxed);
+
+                bin.head  = batch;
+                bin.count = batchCount;
+
+                return batch;
+            }
+
+            // デポが空ならセントラルフリーリストから切り出し、空きがなければスラブを追加する
+            // ただし、他スレッドがデポへ書き込み中のバッチがある場合は、スラブを追加せずに完了を待つ
+            {
+                std::scoped_lock lock(centralMutex[index]);
+
+                Pool& pool = pools[index];
+                bool  grow = pool.freeSlabs == nullptr && sharedFreeBlocks[index].load(std::memory_order_relaxed) < batchCount;
+
+                if (grow && pool.CommitSlab(OS::Get()->GetTickSeconds()))
+                {
+                    sharedFreeBlocks[index].fetch_add(pool.blocksPerSlab, std::memory_order_relaxed);
+                }
+
+                Block* first = nullptr;
+                uint32  count = pool.PopBlocks(&first, batchCount);
+
+                if (count != 0)
+                {
+                    sharedFreeBlocks[index].fetch_sub(count, std::memory_order_relaxed);
+
+                    bin.head  = first;
+                    bin.count = count;
+
+                    return first;
+                }
+            }
+
+            // スラブを追加できない場合でも、デポ・セントラルの空き数が正の間は
+            // 他スレッドが書き込み中のブロックが存在するので、書き込み完了を待つ
+            if (sharedFreeBlocks[index].load(std::memory_order_acquire) <= 0)
+                return nullptr;
+
+            std::this_thread::yield();
+        }
+    }
+
+    void MemoryPool::Drain(ThreadCache::Bin& bin, uint32 index, uint32 numDrain)
     {
-        Memory::Free(ptr);
-        ptr = nullptr;
+        if (numDrain == 0 || bin.head == nullptr)
+            return;
+
+        // キャッシュ先頭から numDrain 個のブロックを切り離す
+        Block* first = bin.head;
+        Block* last  = first;
+
+        for (uint32 i = 1; i < numDrain; i++)
+        {
+            last = last->next;
+        }
+
+        bin.head   = last->next;
+        bin.count -= numDrain;
+        last->next = nullptr;
+
+        sharedFreeBlocks[index].fetch_add(numDrain, std::memory_order_release);
+
+        // 満杯のバッチのみデポに戻し、それ以外（端数・デポ満杯）はセントラルに戻す
+        if (numDrain == GetBatchBlockCount(index) && depots[index].Push(first))
+            return;
+
+        ReturnToCentral(first, index);
     }
 
-    MemoryPool::Header* MemoryPool::Pool::PopFront()
+    void MemoryPool::ReturnToCentral(Block* first, uint32 index)
     {
-        Header* top = head;
-        head = head->next;
-        return top;
+        uint64 time = OS::Get()->GetTickSeconds();
+
+        std::scoped_lock lock(centralMutex[index]);
+        pools[index].PushBlocks(first, time);
     }
 
-    void MemoryPool::Pool::PushFront(Header* header)
+    void MemoryPool::ReleaseIdleSlabs(uint32 index, uint64 time)
     {
-        header->next = head;
-        head = header;
+        // デポ内のバッチはスラブを使用中として扱うので、一度セントラルに戻す
+        Block* batch;
+        while (depots[index].Pop(batch))
+        {
+            ReturnToCentral(batch, index);
+        }
+
+        uint64 idleTime = releaseIdleTime.load(std::memory_order_relaxed);
+
+        std::scoped_lock lock(centralMutex[index]);
+
+        // ラージページのスラブは OS に返却できないので対象外
+        Pool& pool = pools[index];
+        for (uint32 i = pool.largePageSlabs; i < pool.slabWatermark; i++)
+        {
+            if (!pool.committedSlabs[i])
+                continue;
+
+            Slab* slab = reinterpret_cast<Slab*>(pool.base + i * Pool::slabByteSize);
+            if (slab->usedBlocks == 0 && slab->idleStartTime + idleTime <= time)
+            {
+                pool.DecommitSlab(slab);
+                sharedFreeBlocks[index].fetch_sub(pool.blocksPerSlab, std::memory_order_relaxed);
+            }
+        }
     }
 
 
     //============================================================================
     // メモリープール
     //============================================================================
-    void MemoryPool::Initialize()
+    bool MemoryPool::ReserveWithLargePages(uint32 classMask)
     {
-        const uint64 minPoolBlockByteSize = 32;
-        const uint64 poolByteSize         = 10 * 1024 * 1024;
+        OS*    os            = OS::Get();
+        uint64 largePageSize = os->GetLargePageSize();
+        if (largePageSize == 0 || classMask == 0)
+            return false;
+
+        uint64 largeSize   = (Pool::largePageByteSize + largePageSize - 1) & ~(largePageSize - 1);
+        uint64 reserveSize = Pool::reserveByteSize * numPools;
+
+        // ラージページ境界に揃ったアドレスを得るため、余分に予約してから解放する
+        byte* address = static_cast<byte*>(os->ReserveMemory(reserveSize + largePageSize));
+        if (address == nullptr)
+            return false;
+
+        os->ReleaseMemory(address, reserveSize + largePageSize);
+        address = reinterpret_cast<byte*>(((uint64)address + largePageSize - 1) & ~(largePageSize - 1));
+
+        // 解放したアドレスに、サイズクラス毎に予約し直す
+        // 指定されたサイズクラスは [ラージページ領域 | 通常の予約領域]、それ以外は通常の予約領域のみ
+        uint32 numMapped = 0;
+        for (; numMapped < numPools; numMapped++)
+        {
+            byte* poolBase = address + Pool::reserveByteSize * numMapped;
+
+            if ((classMask & (1u << numMapped)) == 0)
+            {
+                if (os->ReserveMemory(Pool::reserveByteSize, poolBase) == nullptr)
+                    break;
+
+                continue;
+            }
+
+            void* large = os->AllocateLargePages(largeSize, poolBase);
+            void* rest  = large ? os->ReserveMemory(Pool::reserveByteSize - largeSize, poolBase + largeSize) : nullptr;
+
+            if (rest == nullptr)
+            {
+                if (large) os->ReleaseMemory(large, largeSize);
+                break;
+            }
+        }
+
+        reservedBase       = address;
+        largePageByteSize  = largeSize;
+        largePageClassMask = classMask;
+
+        // 途中で失敗した場合（物理メモリ不足・他スレッドによるアドレスの使用）は全て戻す
+        if (numMapped != numPools)
+        {
+            ReleaseReservation(numMapped);
+
+            reservedBase       = nullptr;
+            largePageByteSize  = 0;
+            largePageClassMask = 0;
+
+            return false;
+        }
+
+        return true;
+    }
+
+    void MemoryPool::ReleaseReservation(uint32 numMapped)
+    {
+        if (largePageClassMask == 0)
+        {
+            OS::Get()->ReleaseMemory(reservedBase, Pool::reserveByteSize * numPools);
+            return;
+        }
+
+        // サイズクラス毎に予約し直しているので、確保した単位で解放する
+        for (uint32 i = 0; i < numMapped; i++)
+        {
+            byte* poolBase = reservedBase + Pool::reserveByteSize * i;
+
+            if ((largePageClassMask & (1u << i)) == 0)
+            {
+                OS::Get()->ReleaseMemory(poolBase, Pool::reserveByteSize);
+                continue;
+            }
+
+            OS::Get()->ReleaseMemory(poolBase,                     largePageByteSize);
+            OS::Get()->ReleaseMemory(poolBase + largePageByteSize, Pool::reserveByteSize - largePageByteSize);
+        }
+    }
+
+    void MemoryPool::Initialize(uint32 largePageClasses)
+    {
+        // 全サイズクラス分のアドレス空間をまとめて予約し、アドレスからサイズクラスを求められるようにする
+        // 物理メモリはスラブ確保時にコミットする（ラージページの領域は予約と同時にコミット済み）
+        if (!ReserveWithLargePages(largePageClasses & ((1u << numPools) - 1)))
+        {
+            reservedBase = static_cast<byte*>(OS::Get()->ReserveMemory(Pool::reserveByteSize * numPools));
+        }
+
+        SL_ASSERT(reservedBase != nullptr && ((uint64)reservedBase & (Pool::slabByteSize - 1)) == 0);
 
         for (uint32 i = 0; i < pools.size(); i++)
         {
-            uint64 blockSize = minPoolBlockByteSize << i;
-            pools[i].Create(blockSize, poolByteSize);
+            uint32 numLargePageSlabs = (largePageClassMask & (1u << i)) ? (uint32)(largePageByteSize / Pool::slabByteSize) : 0;
+            pools[i].Create(reservedBase + Pool::reserveByteSize * i, minBlockByteSize << i, numLargePageSlabs);
+            depots[i].Clear();
 
-            status[i] = MemoryPoolStatus(blockSize, 0, poolByteSize);
+            sharedFreeBlocks[i].store(0, std::memory_order_relaxed);
+            retiredBlocks[i].store(0, std::memory_order_relaxed);
         }
+
+        lastTrimTime.store(OS::Get()->GetTickSeconds(), std::memory_order_relaxed);
+        initialized.store(true, std::memory_order_release);
     }
 
     void MemoryPool::Finalize()
     {
+        initialized.store(false, std::memory_order_release);
+
+        // 呼び出しスレッドのキャッシュは解放済みメモリを指すので破棄する
+        ThreadCache& cache = GetThreadCache();
+        if (cache.owner.load(std::memory_order_relaxed) == this)
+        {
+            cache.bins = {};
+            UnregisterCache(&cache);
+        }
+
+        // 他のスレッドのキャッシュも登録を解除し、次に使用したプールで空にさせる
+        {
+            std::scoped_lock lock(cacheListMutex);
+
+            while (ThreadCache* other = cacheList)
+            {
+                cacheList = other->nextCache;
+
+                other->owner.store(nullptr, std::memory_order_release);
+                other->nextCache = nullptr;
+                other->prevCache = nullptr;
+            }
+        }
+
         for (uint32 i = 0; i < pools.size(); i++)
         {
             pools[i].Destroy();
         }
+
+        ReleaseReservation(numPools);
+
+        reservedBase       = nullptr;
+        largePageByteSize  = 0;
+        largePageClassMask = 0;
     }
 
-    void* MemoryPool::Allocate(const uint64 allocationSize)
+    void* MemoryPool::Allocate(const uint64 allocationSize, const uint64 alignment)
     {
-        // バイトサイズからプールを選択
-        uint32 index = Internal::SelectPoolIndex(allocationSize);
+        SL_ASSERT((alignment & (alignment - 1)) == 0, "アライメントは2のべき乗である必要があります");
+        SL_ASSERT(std::max(allocationSize, alignment) <= maxBlockByteSize);
 
-        // ヘッダーにプールインデックスを格納
-        Header* header = pools[index].PopFront();
-        header->blockIndex = index;
+        // バイトサイズとアライメントからプールを選択
+        return AllocateFromPool(Internal::SelectPoolIndex((uint32)std::max(allocationSize, alignment)));
+    }
 
-        status[index].totalAllocated += pools[index].blockByteSize;
+    void MemoryPool::Deallocate(void* pointer)
+    {
+        // ブロックのアドレスからプールを選択
+        DeallocateToPool(pointer, GetPoolIndex(pointer));
+    }
+
+    void* MemoryPool::AllocateFromPool(uint32 poolIndex)
+    {
+        ThreadCache& cache = GetThreadCache();
+        if (cache.owner.load(std::memory_order_relaxed) != this)
+            AdoptCache(cache);
+
+        ThreadCache::Bin& bin = cache.bins[poolIndex];
+
+        Block* block = bin.head;
+        if (block == nullptr)
+        {
+            block = Refill(bin, poolIndex);
+            SL_ASSERT(block != nullptr, "メモリプールの容量が不足しています");
+        }
 
-        // ヘッダー分ポインタをずらす
-        return ++header;
+        bin.head = block->next;
+        bin.count--;
+
+        // 所有スレッドのみが書き込むので、アトミックな加算は不要
+        auto& allocated = cache.allocatedBlocks[poolIndex];
+        allocated.store(allocated.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+        return block;
     }
 
-    void MemoryPool::Deallocate(void* pointer)
+    void MemoryPool::DeallocateToPool(void* pointer, uint32 poolIndex)
     {
-        // ヘッダーの次のアドレスが渡されるはずなので、ヘッダーの先頭に戻す
-        Header* header = static_cast<Header*>(pointer);
-        --header;
+        SL_ASSERT(GetPoolIndex(pointer) == poolIndex, "解放するブロックのサイズクラスが一致しません");
+
+        ThreadCache& cache = GetThreadCache();
+        if (cache.owner.load(std::memory_order_relaxed) != this)
+            AdoptCache(cache);
+
+        ThreadCache::Bin& bin = cache.bins[poolIndex];
+
+        Block* block = static_cast<Block*>(pointer);
+        block->next = bin.head;
+        bin.head    = block;
+        bin.count++;
+
+        auto& allocated = cache.allocatedBlocks[poolIndex];
+        allocated.store(allocated.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+
+        // キャッシュが上限 (2バッチ分) を超えたら、1バッチ分をデポへ戻す
+        uint32 batchCount = GetBatchBlockCount(poolIndex);
+        if (bin.count > batchCount * 2)
+        {
+            Drain(bin, poolIndex, batchCount);
+        }
+    }
+
+    void MemoryPool::Trim()
+    {
+        // 返却処理はデポのバッチを崩すので、1秒に1回まで
+        constexpr uint64 trimInterval = 1'000'000;
+
+        uint64 time = OS::Get()->GetTickSeconds();
+        uint64 last = lastTrimTime.load(std::memory_order_relaxed);
+
+        if (time - last < trimInterval || !lastTrimTime.compare_exchange_strong(last, time, std::memory_order_relaxed))
+            return;
+
+        for (uint32 i = 0; i < numPools; i++)
+        {
+            ReleaseIdleSlabs(i, time);
+        }
+    }
+
+    void MemoryPool::SetReleaseIdleTime(float seconds)
+    {
+        releaseIdleTime.store((uint64)(seconds * 1'000'000), std::memory_order_relaxed);
+    }
+
+    std::array<MemoryPoolStatus, MemoryPool::numPools> MemoryPool::GetStatus() const
+    {
+        std::array<int64, numPools> blocks;
+        for (uint32 i = 0; i < numPools; i++)
+        {
+            blocks[i] = retiredBlocks[i].load(std::memory_order_relaxed);
+        }
+
+        {
+            std::scoped_lock lock(cacheListMutex);
+
+            for (ThreadCache* cache = cacheList; cache; cache = cache->nextCache)
+            {
+                for (uint32 i = 0; i < numPools; i++)
+                {
+                    blocks[i] += cache->allocatedBlocks[i].load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        std::array<MemoryPoolStatus, numPools> status;
+        for (uint32 i = 0; i < numPools; i++)
+        {
+            std::scoped_lock lock(centralMutex[i]);
+
+            const Pool& pool      = pools[i];
+            uint32      blockSize = pool.blockByteSize;
+
+            status[i].chunkSize      = blockSize;
+            status[i].totalAllocated = (uint32)std::max<int64>(blocks[i], 0) * blockSize;
+            status[i].totalSize      = pool.numSlabs * pool.blocksPerSlab * blockSize;
+            status[i].numSlabs       = pool.numSlabs;
+            status[i].peakSlabs      = pool.peakSlabs;
+            status[i].largePageSize  = (uint32)(pool.largePageSlabs * Pool::slabByteSize);
+        }
 
-        uint32 index = header->blockIndex;
-        pools[index].PushFront(header);
-        status[index].totalAllocated -= pools[index].blockByteSize;
+        return status;
     }
 }
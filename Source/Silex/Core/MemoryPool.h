@@ -1,7 +1,11 @@
-
 #pragma once
 
+#include "Core/Macros.h"
 #include "Core/CoreType.h"
+#include "Core/LockFreeQueue.h"
+#include <atomic>
+#include <bit>
+#include <mutex>
 
 
 namespace Silex
@@ -11,49 +15,233 @@ namespace Silex
         uint32 chunkSize      = 0;
         uint32 totalAllocated = 0;
         uint32 totalSize      = 0;
+        uint32 numSlabs       = 0;
+        uint32 peakSlabs      = 0;
+        uint32 largePageSize  = 0; // ラージページで常駐する領域（Trim で返却されない）
     };
 
 
+    //=========================================================================
+    // スレッドセーフなメモリプール
+    //-------------------------------------------------------------------------
+    // サイズクラス毎に仮想アドレス空間を予約し、スラブ単位で必要な分だけコミットする
+    // Initialize で指定したサイズクラスのみ、先頭をラージページで確保して TLB ミスを減らす
+    // ラージページの領域は遅延コミットも返却もできず、使用量に関わらず常駐するので既定では使用しない
+    // （常駐量は Trim 後のスラブ（totalSize）とラージページの領域（largePageSize）の合計）
+    //
+    // 確保・解放はスレッド毎のブロックキャッシュで完結し、キャッシュの補充・排出は
+    // バッチ（ブロックの連結リスト）単位でロックフリーなデポとやり取りする
+    // デポが空・満杯の場合のみ、サイズクラス毎のミューテックスで保護された
+    // セントラルフリーリストにアクセスする
+    //=========================================================================
     class MemoryPool
     {
+    public:
+
+        static constexpr uint32 numPools         = 6;
+        static constexpr uint64 minBlockByteSize = 32;
+        static constexpr uint64 maxBlockByteSize = minBlockByteSize << (numPools - 1);
+
+        // サイズクラスをコンパイル時に決定する（型付き確保で、サイズによる分岐をなくすため）
+        static consteval uint32 GetSizeClass(uint64 size)
+        {
+            uint32 index = 0;
+            while ((minBlockByteSize << index) < size)
+            {
+                index++;
+            }
+
+            return index;
+        }
+
     public:
 
         MemoryPool()  = default;
         ~MemoryPool() = default;
 
-        void Initialize();
+        // largePageClasses: 先頭をラージページで確保するサイズクラスのビットマスク（既定は使用しない）
+        void Initialize(uint32 largePageClasses = 0);
         void Finalize();
 
-        void* Allocate(const uint64 allocationSize);
+        // ブロックはブロックサイズ境界に配置されるので、アライメント以上のサイズクラスから確保する
+        void* Allocate(const uint64 allocationSize, const uint64 alignment = minBlockByteSize);
         void  Deallocate(void* pointer);
 
-        const std::array<MemoryPoolStatus, 6>& GetStatus() const { return status; }
+        // プールの予約領域内のアドレスか
+        bool Contains(const void* pointer) const
+        {
+            return reservedBase <= (const byte*)pointer && (const byte*)pointer < reservedBase + Pool::reserveByteSize * numPools;
+        }
+
+        // サイズクラスが既知の場合（Memory::Allocate<T> など）
+        void* AllocateFromPool(uint32 poolIndex);
+        void  DeallocateToPool(void* pointer, uint32 poolIndex);
+
+        // 一定時間使用されていないスラブを OS に返却する（毎フレーム呼び出し可能）
+        void Trim();
+        void SetReleaseIdleTime(float seconds);
+
+        // ラージページで確保した領域の合計サイズ（使用できなかった場合は 0）
+        uint64 GetLargePageByteSize() const { return largePageByteSize * std::popcount(largePageClassMask); }
+
+        std::array<MemoryPoolStatus, numPools> GetStatus() const;
 
     private:
 
-        struct Header
+        // 空きブロックは先頭に次の空きブロックへのポインタを格納する（使用中は全領域をユーザーが使用）
+        struct Block
         {
-            uint32  blockIndex;
-            Header* next;
+            Block* next;
         };
 
+        //=====================================================
+        // スラブ（ページ境界に揃えた 64KB のブロック群）
+        //-----------------------------------------------------
+        // 管理データはスラブ先頭に配置し、残りをブロックに分割する
+        // ブロックはブロックサイズ境界に配置するので、自然なアライメントが保証される
+        // 使用中ブロック数が 0 のまま一定時間経過したスラブは OS に返却する
+        //=====================================================
+        struct Slab
+        {
+            Block* freeList      = nullptr;
+            uint32 usedBlocks    = 0;
+            uint64 idleStartTime = 0;
+
+            // 空きブロックを持つスラブのリスト
+            Slab* prev = nullptr;
+            Slab* next = nullptr;
+        };
+
+        //=====================================================
+        // セントラルフリーリスト（ミューテックスで保護）
+        //-----------------------------------------------------
+        // 全サイズクラスで連続した仮想アドレス空間を予約し、クラス毎に 512MB ずつ割り当てる
+        // 必要に応じてスラブ単位でコミットする
+        //=====================================================
         struct Pool
         {
-            Header* head = nullptr;
-            void*   ptr  = nullptr;
+            static constexpr uint64 slabByteSize       = 64 * 1024;
+            static constexpr uint64 slabHeaderByteSize = 64;
+            static constexpr uint32 reserveShift       = 29;
+            static constexpr uint64 reserveByteSize    = 1ull << reserveShift;
+            static constexpr uint32 maxSlabs           = reserveByteSize / slabByteSize;
+
+            // 指定されたサイズクラスの先頭をラージページで確保するサイズ
+            static constexpr uint64 largePageByteSize = 4 * 1024 * 1024;
+
+            byte*  base           = nullptr;
+            uint8* committedSlabs = nullptr;
+            Slab*  freeSlabs      = nullptr;
+            Slab*  freeSlabsTail  = nullptr;
 
-            uint32 blockByteSize;
-            uint32 numBlocks;
+            uint32 blockByteSize = 0;
+            uint32 blockOffset   = 0;
+            uint32 blocksPerSlab = 0;
 
-            void Create(const uint32 chunkSize, const uint32 poolSize);
+            // 先頭からこの数のスラブはラージページで常にコミットされている（OS に返却しない）
+            uint32 largePageSlabs = 0;
+
+            uint32 numSlabs      = 0;
+            uint32 peakSlabs     = 0;
+            uint32 slabWatermark = 0;
+
+            void Create(byte* reservedBase, const uint32 chunkSize, const uint32 numLargePageSlabs);
             void Destroy();
 
-            void    PushFront(Header* header);
-            Header* PopFront();
+            Slab* CommitSlab(uint64 time);
+            void  DecommitSlab(Slab* slab);
+            Slab* GetSlab(Block* block) const;
+
+            void LinkFreeSlab(Slab* slab);
+            void UnlinkFreeSlab(Slab* slab);
+
+            uint32 PopBlocks(Block** outFirst, uint32 maxCount);
+            void   PushBlocks(Block* first, uint64 time);
         };
 
-        std::array<Pool,             6> pools;
-        std::array<MemoryPoolStatus, 6> status;
+        //=====================================================
+        // バッチデポ（有界 MPMC キュー）
+        //-----------------------------------------------------
+        // バッチ先頭ブロックのポインタのみを格納し、デポ内ではブロックの
+        // メモリに触れないため ABA 問題や解放済みメモリ参照が発生しない
+        //=====================================================
+        using BatchDepot = MPMCQueue<Block*, 1024>;
+
+        //=====================================================
+        // スレッド毎のブロックキャッシュ
+        //-----------------------------------------------------
+        // キャッシュはスレッドに1つで、最後に使用したプールが所有する
+        // 別のプールを使用すると、ブロックを元のプールへ戻してから所有者を切り替える
+        //=====================================================
+        struct ThreadCache
+        {
+            struct Bin
+            {
+                Block* head  = nullptr;
+                uint32 count = 0;
+            };
+
+            ~ThreadCache();
+
+            std::array<Bin, numPools> bins;
+
+            // スレッド毎の確保ブロック数（所有スレッドのみが書き込む）
+            std::array<std::atomic<int64>, numPools> allocatedBlocks = {};
+
+            // 所有スレッドが切り替え、Finalize が登録を解除する
+            std::atomic<MemoryPool*> owner = nullptr;
+
+            ThreadCache* nextCache  = nullptr;
+            ThreadCache* prevCache  = nullptr;
+        };
+
+        static ThreadCache& GetThreadCache();
+
+        void    AdoptCache(ThreadCache& cache);
+        void    RegisterCache(ThreadCache* cache);
+        void    UnregisterCache(ThreadCache* cache);
+        Block*  Refill(ThreadCache::Bin& bin, uint32 index);
+        void    Drain(ThreadCache::Bin& bin, uint32 index, uint32 numDrain);
+        void    ReturnToCentral(Block* first, uint32 index);
+        void    ReleaseIdleSlabs(uint32 index, uint64 time);
+
+        bool    ReserveWithLargePages(uint32 classMask);
+        void    ReleaseReservation(uint32 numMapped);
+
+        static uint32 GetBatchBlockCount(uint32 index);
+
+        // ブロックのアドレスから、所属するサイズクラスを求める
+        uint32 GetPoolIndex(void* pointer) const
+        {
+            return (uint32)(((byte*)pointer - reservedBase) >> Pool::reserveShift);
+        }
+
+    private:
+
+        byte*  reservedBase       = nullptr;
+        uint64 largePageByteSize  = 0; // サイズクラス 1つあたり
+        uint32 largePageClassMask = 0; // 実際にラージページで確保できたサイズクラス
+
+        std::array<Pool,       numPools> pools;
+        std::array<BatchDepot, numPools> depots;
+        mutable std::array<std::mutex, numPools> centralMutex;
+
+        // デポとセントラルにある空きブロック数（スレッドキャッシュ内は含まない）
+        // ブロックの移動前に加算・取得後に減算するので、書き込み中のブロックも含む
+        std::array<std::atomic<int64>, numPools> sharedFreeBlocks = {};
+
+        // 登録済みスレッドキャッシュ（統計用）
+        mutable std::mutex  cacheListMutex;
+        ThreadCache*        cacheList = nullptr;
+
+        // 終了したスレッドの確保ブロック数
+        std::array<std::atomic<int64>, numPools> retiredBlocks = {};
+
+        // スラブを OS に返却するまでの待機時間（μs）と、最後に返却処理を行った時間
+        std::atomic<uint64> releaseIdleTime = 5'000'000;
+        std::atomic<uint64> lastTrimTime    = 0;
+
+        std::atomic<bool> initialized = false;
 
     private:
 
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "Core/Memory.h"
+
+#include <map>
+#include <memory_resource>
+
+
+namespace Silex
+{
+    //===============================================================
+    // プール メモリリソース（std::pmr）
+    //---------------------------------------------------------------
+    // 1KB 以下はメモリプール、それ以上は TLSF ヒープから確保する
+    // プールは Memory::Finalize で解放されるので、静的変数のコンテナには使用しない
+    //===============================================================
+    class PoolMemoryResource : public std::pmr::memory_resource
+    {
+    public:
+
+        static PoolMemoryResource* Get()
+        {
+            return &instance;
+        }
+
+    private:
+
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            return Memory::AllocateBytes(bytes, alignment);
+        }
+
+        void do_deallocate(void* ptr, std::size_t, std::size_t) override
+        {
+            Memory::DeallocateBytes(ptr);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+
+    private:
+
+        static PoolMemoryResource instance;
+    };
+
+    inline PoolMemoryResource PoolMemoryResource::instance;
+
+
+    //===============================================================
+    // フレームアリーナ メモリリソース（std::pmr）
+    //---------------------------------------------------------------
+    // 解放は何もしない。確保したメモリは次のフレームの終了まで有効
+    //===============================================================
+    class FrameMemoryResource : public std::pmr::memory_resource
+    {
+    public:
+
+        static FrameMemoryResource* Get()
+        {
+            return &instance;
+        }
+
+    private:
+
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            return FrameArena::Allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void*, std::size_t, std::size_t) override
+        {
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+
+    private:
+
+        static FrameMemoryResource instance;
+    };
+
+    inline FrameMemoryResource FrameMemoryResource::instance;
+
+
+    //===============================================================
+    // モノトニックアリーナ（std::pmr）
+    //---------------------------------------------------------------
+    // スコープ内の一時データ用。初期バッファ（スタック上の配列など）から確保し、
+    // 足りなくなれば上流リソース（既定はプール）から追加で確保する
+    // 個別の解放は行わず、デストラクタで一括解放する
+    //===============================================================
+    class MonotonicArena : public std::pmr::monotonic_buffer_resource
+    {
+    public:
+
+        explicit MonotonicArena(uint64 initialByteSize, std::pmr::memory_resource* upstream = PoolMemoryResource::Get())
+            : std::pmr::monotonic_buffer_resource(initialByteSize, upstream)
+        {}
+
+        MonotonicArena(void* buffer, uint64 bufferByteSize, std::pmr::memory_resource* upstream = PoolMemoryResource::Get())
+            : std::pmr::monotonic_buffer_resource(buffer, bufferByteSize, upstream)
+        {}
+    };
+
+
+    //===============================================================
+    // プール STL アロケーター
+    //---------------------------------------------------------------
+    // std::pmr を使わずに、既存のコンテナ型のままプールから確保する場合に使用する
+    //===============================================================
+    template <typename T>
+    class PooledAllocator
+    {
+    public:
+
+        using value_type      = T;
+        using is_always_equal = std::true_type;
+
+        PooledAllocator() = default;
+
+        template <typename U>
+        PooledAllocator(const PooledAllocator<U>&) noexcept {}
+
+        T* allocate(std::size_t n)
+        {
+            return static_cast<T*>(Memory::AllocateBytes(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T* p, std::size_t) noexcept
+        {
+            Memory::DeallocateBytes(p);
+        }
+
+        template <typename U>
+        bool operator==(const PooledAllocator<U>&) const noexcept { return true; }
+    };
+
+    template<typename T>
+    using PoolVector = std::vector<T, PooledAllocator<T>>;
+
+    template<typename Key, typename Value, typename Hash = std::hash<Key>>
+    using PoolHashMap = std::unordered_map<Key, Value, Hash, std::equal_to<Key>, PooledAllocator<std::pair<const Key, Value>>>;
+
+    template<typename Key, typename Value, typename Compare = std::less<Key>>
+    using PoolMap = std::map<Key, Value, Compare, PooledAllocator<std::pair<const Key, Value>>>;
+}
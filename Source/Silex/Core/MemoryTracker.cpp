@@ -0,0 +1,494 @@
+
+#include "PCH.h"
+
+#include "Core/MemoryTracker.h"
+#include "Core/Memory.h"
+#include "Core/Logger.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace Silex
+{
+    namespace Internal
+    {
+        // サンプリング停止中も、一定量の確保毎に間隔の変更を確認する
+        static constexpr int64 disabledCheckInterval = 16 * 1024 * 1024;
+
+        // テーブルの探索上限（超えた場合はオーバーフロー用の集計に記録する）
+        static constexpr uint32 maxProbeCount = 16;
+
+        struct SiteKey
+        {
+            const void* callSite;
+            const char* typeName;
+        };
+
+        struct SiteKeyHash
+        {
+            uint64 operator()(const SiteKey& key) const
+            {
+                return std::hash<const void*>()(key.callSite) ^ (std::hash<const void*>()(key.typeName) * 0x9E3779B97F4A7C15ull);
+            }
+        };
+
+        // 確保元の順序（スレッド毎に分かれた同じ確保元を、並べて合算するため）
+        static bool CompareSite(const AllocationSiteStats& a, const AllocationSiteStats& b)
+        {
+            if (a.callSite != b.callSite)
+                return (uint64)a.callSite < (uint64)b.callSite;
+
+            return (uint64)a.typeName < (uint64)b.typeName;
+        }
+
+        static bool IsSameSite(const AllocationSiteStats& a, const AllocationSiteStats& b)
+        {
+            return a.callSite == b.callSite && a.typeName == b.typeName;
+        }
+
+        // 確保元でソートし、同じ確保元を合算する（容量を再利用するので、ウォームアップ後は確保しない）
+        static void SortAndMergeSites(std::vector<AllocationSiteStats>& sites)
+        {
+            std::sort(sites.begin(), sites.end(), CompareSite);
+
+            uint64 numMerged = 0;
+            for (const AllocationSiteStats& site : sites)
+            {
+                if (numMerged != 0 && IsSameSite(sites[numMerged - 1], site))
+                {
+                    sites[numMerged - 1].count += site.count;
+                    sites[numMerged - 1].bytes += site.bytes;
+                }
+                else
+                {
+                    sites[numMerged++] = site;
+                }
+            }
+
+            sites.resize(numMerged);
+        }
+
+        // スレッド毎の乱数の初期値（0 は未初期化を表すので避ける）
+        static uint64 SeedRandom()
+        {
+            static std::atomic<uint64> sequence = 0;
+
+            uint64 seed = sequence.fetch_add(0x9E3779B97F4A7C15ull, std::memory_order_relaxed) ^ (uint64)&seed;
+            seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ull;
+            seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBull;
+            seed =  seed ^ (seed >> 31);
+
+            return seed != 0 ? seed : 1;
+        }
+    }
+
+
+    //============================================================================
+    // 型名
+    //============================================================================
+    std::string_view GetReadableTypeName(const char* signature)
+    {
+        if (signature == nullptr)
+            return "(unknown)";
+
+        std::string_view name = signature;
+
+        // MSVC: "const char *__cdecl Silex::GetTrackingTypeName<struct Silex::Mesh>(void)"
+        uint64 begin = name.find('<');
+        uint64 end   = name.rfind('>');
+        if (begin != std::string_view::npos && end != std::string_view::npos && begin < end)
+            return name.substr(begin + 1, end - begin - 1);
+
+        // GCC / Clang: "const char* Silex::GetTrackingTypeName() [with T = Silex::Mesh]"
+        begin = name.find("T = ");
+        end   = name.rfind(']');
+        if (begin != std::string_view::npos && end != std::string_view::npos && begin < end)
+            return name.substr(begin + 4, end - begin - 4);
+
+        return name;
+    }
+
+
+    //============================================================================
+    // スレッド毎の集計テーブル
+    //============================================================================
+
+    // 直近 2フレーム分の確保元毎の確保量（確保元でソート済み）
+    // 集計用のコンテナは記録対象外（グローバル new）なので、集計中の確保が記録を再帰させることはない
+    static std::mutex                       frameMutex;
+    static std::vector<AllocationSiteStats> currentFrame;
+    static std::vector<AllocationSiteStats> previousFrame;
+
+    void MemoryTracker::GetThreadSites(std::vector<AllocationSiteStats>& outSites)
+    {
+        std::scoped_lock lock(recordListMutex);
+
+        auto visit = [&](const Site& site)
+        {
+            AllocationSiteStats stats;
+            stats.callSite = site.callSite.load(std::memory_order_acquire);
+            stats.typeName = site.typeName.load(std::memory_order_relaxed);
+            stats.count    = site.count.load(std::memory_order_relaxed);
+            stats.bytes    = site.bytes.load(std::memory_order_relaxed);
+
+            if (stats.count != 0)
+            {
+                outSites.push_back(stats);
+            }
+        };
+
+        for (ThreadRecord* record = recordList; record; record = record->next)
+        {
+            uint32 numUsedSlots = record->numUsedSlots.load(std::memory_order_acquire);
+            for (uint32 i = 0; i < numUsedSlots; i++)
+            {
+                visit(record->sites[record->usedSlots[i]]);
+            }
+
+            visit(record->overflow);
+        }
+    }
+
+    MemoryTracker::ThreadRecord* MemoryTracker::GetThreadRecord()
+    {
+        // Finalize 後に再初期化された場合は、古いテーブルを参照しないよう世代で判定する
+        static thread_local ThreadRecord* threadRecord     = nullptr;
+        static thread_local uint64        threadGeneration = 0;
+
+        uint64 currentGeneration = generation.load(std::memory_order_acquire);
+        if (threadRecord == nullptr || threadGeneration != currentGeneration)
+        {
+            // 記録対象のアロケーターを使うと再帰するので、malloc から確保する
+            threadRecord     = Memory::Construct<ThreadRecord>(Memory::Malloc(sizeof(ThreadRecord)));
+            threadGeneration = currentGeneration;
+
+            std::scoped_lock lock(recordListMutex);
+            threadRecord->next = recordList;
+            recordList         = threadRecord;
+        }
+
+        return threadRecord;
+    }
+
+
+    //============================================================================
+    // 初期化・終了
+    //============================================================================
+    void MemoryTracker::Initialize()
+    {
+        generation.fetch_add(1, std::memory_order_release);
+    }
+
+    void MemoryTracker::Finalize()
+    {
+        {
+            std::scoped_lock lock(frameMutex);
+            currentFrame  = {};
+            previousFrame = {};
+        }
+
+        std::scoped_lock lock(recordListMutex);
+
+        // 以降の確保で古いテーブルを参照しないよう、先に世代を進める
+        generation.fetch_add(1, std::memory_order_release);
+
+        ThreadRecord* record = recordList;
+        while (record)
+        {
+            ThreadRecord* next = record->next;
+
+            Memory::Destruct(record);
+            Memory::Free(record);
+
+            record = next;
+        }
+
+        recordList = nullptr;
+    }
+
+    void MemoryTracker::SetSamplingInterval(uint64 intervalByteSize)
+    {
+        samplingInterval.store(intervalByteSize, std::memory_order_relaxed);
+    }
+
+    uint64 MemoryTracker::GetSamplingInterval()
+    {
+        return samplingInterval.load(std::memory_order_relaxed);
+    }
+
+
+    //============================================================================
+    // 記録
+    //============================================================================
+    double MemoryTracker::NextRandom()
+    {
+        randomState ^= randomState >> 12;
+        randomState ^= randomState << 25;
+        randomState ^= randomState >> 27;
+
+        return (double)(((randomState * 0x2545F4914F6CDD1Dull) >> 11) + 1) / 9007199254740992.0;
+    }
+
+    int64 MemoryTracker::NextSampleDistance(uint64 interval)
+    {
+        // 逆関数法で一様乱数を指数分布に変換する
+        return (int64)(-std::log(NextRandom()) * (double)interval) + 1;
+    }
+
+    void MemoryTracker::RecordSample(uint64 size, const char* typeName, const void* callSite)
+    {
+        uint64 interval = samplingInterval.load(std::memory_order_relaxed);
+        if (interval == 0)
+        {
+            // 再開時は間隔を引き直す
+            bytesUntilSample = Internal::disabledCheckInterval;
+            randomState      = 0;
+            return;
+        }
+
+        // スレッドの最初の確保（または再開後）は、最初のサンプル点を決めるのみ
+        // この確保の範囲にサンプル点が無ければ記録しない
+        if (randomState == 0)
+        {
+            randomState       = Internal::SeedRandom();
+            bytesUntilSample += NextSampleDistance(interval);
+
+            if (bytesUntilSample > 0)
+                return;
+        }
+
+        // 指数分布は無記憶なので、この確保の残りのバイトは捨てて次のサンプル点を決め直す
+        bytesUntilSample = NextSampleDistance(interval);
+
+        // 記録される確率 p で割り戻し、この確保と同じサイズの確保 1/p 回分を代表させる
+        // 回数は整数に丸めると偏る（p = 0.63 なら 1.59 → 2）ので、端数は確率的に切り上げる
+        double probability    = -std::expm1(-(double)std::max<uint64>(size, 1) / (double)interval);
+        double countScale     = 1.0 / probability;
+        uint64 estimatedCount = (uint64)countScale + (NextRandom() <= countScale - std::floor(countScale) ? 1 : 0);
+        uint64 estimatedBytes = (uint64)((double)size * countScale + 0.5);
+
+        ThreadRecord* record = GetThreadRecord();
+        Site*         target = &record->overflow;
+
+        uint64 hash = Internal::SiteKeyHash()({ callSite, typeName });
+        for (uint32 i = 0; i < Internal::maxProbeCount; i++)
+        {
+            Site& site = record->sites[(hash + i) & (ThreadRecord::capacity - 1)];
+
+            const void* siteCallSite = site.callSite.load(std::memory_order_relaxed);
+            if (siteCallSite == nullptr)
+            {
+                // 読み取り側が callSite を見た時点で typeName が確定しているよう、先に書き込む
+                site.typeName.store(typeName, std::memory_order_relaxed);
+                site.callSite.store(callSite, std::memory_order_release);
+
+                // 使用中のスロットとして公開する（読み取り側は numUsedSlots までのみを読む）
+                uint32 numUsedSlots = record->numUsedSlots.load(std::memory_order_relaxed);
+                record->usedSlots[numUsedSlots] = (uint16)((hash + i) & (ThreadRecord::capacity - 1));
+                record->numUsedSlots.store(numUsedSlots + 1, std::memory_order_release);
+
+                target = &site;
+                break;
+            }
+
+            if (siteCallSite == callSite && site.typeName.load(std::memory_order_relaxed) == typeName)
+            {
+                target = &site;
+                break;
+            }
+        }
+
+        // 所有スレッドのみが書き込むので、読み取りと加算を分けてよい
+        target->count.store(target->count.load(std::memory_order_relaxed) + estimatedCount, std::memory_order_relaxed);
+        target->bytes.store(target->bytes.load(std::memory_order_relaxed) + estimatedBytes, std::memory_order_relaxed);
+    }
+
+
+    //============================================================================
+    // フレーム更新
+    //============================================================================
+    void MemoryTracker::NextFrame()
+    {
+        std::scoped_lock lock(frameMutex);
+
+        previousFrame.swap(currentFrame);
+        currentFrame.clear();
+
+        // 各確保元の前回からの増分を今フレームの確保量とし、前回の値を更新する
+        auto collect = [](Site& site)
+        {
+            uint64 count = site.count.load(std::memory_order_relaxed);
+            if (count == site.frameCount)
+                return;
+
+            uint64 bytes = site.bytes.load(std::memory_order_relaxed);
+
+            AllocationSiteStats delta;
+            delta.callSite = site.callSite.load(std::memory_order_acquire);
+            delta.typeName = site.typeName.load(std::memory_order_relaxed);
+            delta.count    = count - site.frameCount;
+            delta.bytes    = bytes - site.frameBytes;
+            currentFrame.push_back(delta);
+
+            site.frameCount = count;
+            site.frameBytes = bytes;
+        };
+
+        {
+            std::scoped_lock recordLock(recordListMutex);
+
+            for (ThreadRecord* record = recordList; record; record = record->next)
+            {
+                uint32 numUsedSlots = record->numUsedSlots.load(std::memory_order_acquire);
+                for (uint32 i = 0; i < numUsedSlots; i++)
+                {
+                    collect(record->sites[record->usedSlots[i]]);
+                }
+
+                collect(record->overflow);
+            }
+        }
+
+        // 同じ確保元の記録は、スレッド毎のテーブルに分散しているので合算する
+        Internal::SortAndMergeSites(currentFrame);
+    }
+
+    AllocationSiteStats MemoryTracker::GetFrameTotal()
+    {
+        std::scoped_lock lock(frameMutex);
+
+        AllocationSiteStats total;
+        for (const AllocationSiteStats& stats : currentFrame)
+        {
+            total.count += stats.count;
+            total.bytes += stats.bytes;
+        }
+
+        return total;
+    }
+
+    std::vector<AllocationSiteStats> MemoryTracker::GetFrameTopAllocators(uint32 count)
+    {
+        std::vector<AllocationSiteStats> sites;
+
+        {
+            std::scoped_lock lock(frameMutex);
+            sites = currentFrame;
+        }
+
+        uint32 numSites = std::min<uint32>(count, (uint32)sites.size());
+        std::partial_sort(sites.begin(), sites.begin() + numSites, sites.end(), [](const AllocationSiteStats& a, const AllocationSiteStats& b)
+        {
+            return a.bytes > b.bytes;
+        });
+
+        sites.resize(numSites);
+        return sites;
+    }
+
+
+    //============================================================================
+    // ダンプ
+    //============================================================================
+    std::vector<AllocationSiteStats> MemoryTracker::GetTopAllocators(uint32 count, bool sortByCount)
+    {
+        std::vector<AllocationSiteStats> sites;
+        GetThreadSites(sites);
+
+        // 同じ確保元の記録は、スレッド毎のテーブルに分散しているので合算する
+        Internal::SortAndMergeSites(sites);
+
+        auto compare = [sortByCount](const AllocationSiteStats& a, const AllocationSiteStats& b)
+        {
+            return sortByCount ? a.count > b.count : a.bytes > b.bytes;
+        };
+
+        uint32 numSites = std::min<uint32>(count, (uint32)sites.size());
+        std::partial_sort(sites.begin(), sites.begin() + numSites, sites.end(), compare);
+        sites.resize(numSites);
+
+        return sites;
+    }
+
+    void MemoryTracker::DumpTopAllocators(uint32 count)
+    {
+        SL_LOG_INFO("***************************************************************************************************");
+        SL_LOG_INFO("確保元 上位 {} (サンプリング間隔: {} byte, 推定値)", count, GetSamplingInterval());
+
+        for (bool sortByCount : { false, true })
+        {
+            SL_LOG_INFO("----- {} -----", sortByCount ? "確保回数" : "確保サイズ");
+
+            for (const AllocationSiteStats& site : GetTopAllocators(count, sortByCount))
+            {
+                SL_LOG_INFO(" {:>12} byte | {:>10} 回 | 0x{:016x} | {}", site.bytes, site.count, (uint64)site.callSite, GetReadableTypeName(site.typeName));
+            }
+        }
+
+        SL_LOG_INFO("***************************************************************************************************");
+    }
+
+    void MemoryTracker::DumpFrameDiff(uint32 count)
+    {
+        std::vector<AllocationSiteStats> diffs;
+
+        {
+            std::scoped_lock lock(frameMutex);
+
+            // 今フレームと前フレームの確保量の差（どちらか一方にしかない確保元も含む）
+            // 両方とも確保元でソート済みなので、先頭から突き合わせる
+            uint64 current  = 0;
+            uint64 previous = 0;
+
+            while (current < currentFrame.size() || previous < previousFrame.size())
+            {
+                bool hasCurrent  = current  < currentFrame.size();
+                bool hasPrevious = previous < previousFrame.size();
+
+                if (hasCurrent && hasPrevious && Internal::IsSameSite(currentFrame[current], previousFrame[previous]))
+                {
+                    AllocationSiteStats diff = currentFrame[current++];
+                    diff.count -= previousFrame[previous].count;
+                    diff.bytes -= previousFrame[previous].bytes;
+                    previous++;
+
+                    diffs.push_back(diff);
+                }
+                else if (hasCurrent && (!hasPrevious || Internal::CompareSite(currentFrame[current], previousFrame[previous])))
+                {
+                    diffs.push_back(currentFrame[current++]);
+                }
+                else
+                {
+                    AllocationSiteStats diff = previousFrame[previous++];
+                    diff.count = 0 - diff.count;
+                    diff.bytes = 0 - diff.bytes;
+
+                    diffs.push_back(diff);
+                }
+            }
+        }
+
+        // 差の絶対値が大きい順
+        auto magnitude = [](uint64 value) { return (int64)value < 0 ? 0 - value : value; };
+        std::sort(diffs.begin(), diffs.end(), [&](const AllocationSiteStats& a, const AllocationSiteStats& b)
+        {
+            return magnitude(a.bytes) > magnitude(b.bytes);
+        });
+
+        SL_LOG_INFO("***************************************************************************************************");
+        SL_LOG_INFO("前フレームからの確保量の変化 上位 {} (推定値)", count);
+
+        for (uint32 i = 0; i < std::min<uint32>(count, (uint32)diffs.size()); i++)
+        {
+            const AllocationSiteStats& diff = diffs[i];
+            if (diff.bytes == 0 && diff.count == 0)
+                break;
+
+            SL_LOG_INFO(" {:>+12} byte | {:>+10} 回 | 0x{:016x} | {}", (int64)diff.bytes, (int64)diff.count, (uint64)diff.callSite, GetReadableTypeName(diff.typeName));
+        }
+
+        SL_LOG_INFO("***************************************************************************************************");
+    }
+}
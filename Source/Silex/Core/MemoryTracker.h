@@ -0,0 +1,162 @@
+#pragma once
+
+#include "Core/Macros.h"
+#include "Core/CoreType.h"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+
+namespace Silex
+{
+    // 確保元（呼び出し位置 + 型名）毎の集計値（サンプリングからの推定値）
+    struct AllocationSiteStats
+    {
+        const void* callSite = nullptr;
+        const char* typeName = nullptr;
+        uint64      count    = 0;
+        uint64      bytes    = 0;
+    };
+
+
+    //=========================================================================
+    // サンプリング メモリトラッカー
+    //-------------------------------------------------------------------------
+    // 確保したバイト列上に、平均がサンプリング間隔の指数分布に従う間隔でサンプル点を置き、
+    // サンプル点を含む確保のみを記録する（周期的な確保パターンと間隔が同期して偏らないよう、間隔は毎回乱数で決める）
+    // サイズ s の確保が記録される確率 p = 1 - exp(-s / 間隔) から、1回の記録で 1/p 回・s/p バイトを代表させる
+    //
+    // 記録はスレッド毎の集計テーブルに行うので、ロックを取らない
+    // （テーブルの読み取りはダンプ・フレーム更新時のみ）
+    //
+    // 集計は確保元（呼び出し位置のアドレス + 型名）単位で、解放は追跡しない
+    // 確保量の多い確保元と、フレーム毎の確保量の変化を調べるためのもの
+    //=========================================================================
+    class MemoryTracker
+    {
+    public:
+
+        static void Initialize();
+        static void Finalize();
+
+        // サンプリング間隔（バイト）0 で記録を停止する
+        static void   SetSamplingInterval(uint64 intervalByteSize);
+        static uint64 GetSamplingInterval();
+
+        // 確保を記録する（大半はカウンタの減算のみで終わる。スレッドの最初の確保は間隔を決めるために RecordSample を通る）
+        // callSite は確保の入口で取得した呼び出し元のアドレス（SL_ALLOCATION_CALL_SITE）
+        SL_FORCEINLINE static void RecordAllocate(uint64 size, const char* typeName, const void* callSite)
+        {
+            bytesUntilSample -= (int64)size;
+            if (bytesUntilSample <= 0)
+            {
+                RecordSample(size, typeName, callSite);
+            }
+        }
+
+        // 前フレームからの確保量を確定する（フレーム毎に1回呼び出す。使用中の確保元のみを走査し、確保しない）
+        static void NextFrame();
+
+        // 累計の確保量上位
+        static std::vector<AllocationSiteStats> GetTopAllocators(uint32 count, bool sortByCount = false);
+
+        // 全スレッドの記録（同じ確保元でもスレッド毎に分かれたまま）
+        static void GetThreadSites(std::vector<AllocationSiteStats>& outSites);
+
+        // 直前のフレームの確保量の合計
+        static AllocationSiteStats GetFrameTotal();
+
+        // 直前のフレームの確保量上位（確保サイズ順）
+        static std::vector<AllocationSiteStats> GetFrameTopAllocators(uint32 count);
+
+        static void DumpTopAllocators(uint32 count = 20);
+        static void DumpFrameDiff(uint32 count = 20);
+
+    private:
+
+        // サンプリング時のみ呼ばれるので、呼び出し側に展開しない
+        SL_NOINLINE static void RecordSample(uint64 size, const char* typeName, const void* callSite);
+
+        // (0, 1] の一様乱数（スレッド毎の xorshift64*）
+        static double NextRandom();
+
+        // 次のサンプル点までのバイト数（平均 interval の指数分布）
+        static int64 NextSampleDistance(uint64 interval);
+
+        // スレッド毎の集計テーブル（所有スレッドのみが書き込む）
+        struct Site
+        {
+            std::atomic<const void*> callSite = nullptr;
+            std::atomic<const char*> typeName = nullptr;
+            std::atomic<uint64>      count    = 0;
+            std::atomic<uint64>      bytes    = 0;
+
+            // 前回の NextFrame 時点の値（NextFrame のみが読み書きする）
+            uint64 frameCount = 0;
+            uint64 frameBytes = 0;
+        };
+
+        struct SL_CACHE_ALIGN ThreadRecord
+        {
+            static constexpr uint32 capacity = 512;
+
+            std::array<Site, capacity> sites;
+
+            // テーブルが埋まった場合の記録先
+            Site overflow;
+
+            // 使用中のスロット番号（所有スレッドが使用順に追加し、読み取り側はこれだけを走査する）
+            std::array<uint16, capacity> usedSlots;
+            std::atomic<uint32>          numUsedSlots = 0;
+
+            ThreadRecord* next = nullptr;
+        };
+
+        static ThreadRecord* GetThreadRecord();
+
+    private:
+
+        // randomState が 0 の間は間隔が未決定（最初の確保で決める）
+        static inline thread_local int64  bytesUntilSample = 0;
+        static inline thread_local uint64 randomState      = 0;
+
+        // 終了したスレッドの記録も累計に含めるため、Finalize まで保持する
+        static inline std::mutex    recordListMutex;
+        static inline ThreadRecord* recordList = nullptr;
+
+        static inline std::atomic<uint64> samplingInterval = 64 * 1024;
+        static inline std::atomic<uint64> generation       = 0;
+    };
+
+
+    // 記録用の型名（RTTI を使わずに関数シグネチャ文字列で代用し、ダンプ時に型名部分を切り出す）
+    template<typename T>
+    const char* GetTrackingTypeName()
+    {
+        return SL_FUNCSIG;
+    }
+
+
+    // GetTrackingTypeName の文字列から、型名部分を切り出す
+    std::string_view GetReadableTypeName(const char* signature);
+
+
+    //===============================================================
+    // 確保元の取得
+    //---------------------------------------------------------------
+    // 確保の入口（Memory::Allocate など）はインライン展開せず、入口で戻りアドレスを取得して
+    // 内部の処理に渡す。展開の有無（Debug / Release）に関わらず、入口を呼び出した位置が確保元になる
+    //===============================================================
+#if SL_ENABLE_TRACK_HEAP_ALLOCATION
+    #define SL_ALLOCATION_ENTRY                           SL_NOINLINE
+    #define SL_ALLOCATION_CALL_SITE()                     SL_RETURN_ADDRESS()
+    #define SL_TRACK_ALLOCATION(size, typeName, callSite) ::Silex::MemoryTracker::RecordAllocate(size, typeName, callSite)
+#else
+    #define SL_ALLOCATION_ENTRY
+    #define SL_ALLOCATION_CALL_SITE()                     nullptr
+    #define SL_TRACK_ALLOCATION(size, typeName, callSite) SL_NO_USE(callSite)
+#endif
+}
@@ -0,0 +1,240 @@
+
+#include "PCH.h"
+
+#include "Core/Metrics.h"
+#include "Core/Profiler.h"
+
+#include <cstring>
+
+
+namespace Silex
+{
+    //============================================================================
+    // 登録情報・シャード
+    //----------------------------------------------------------------------------
+    // Initialize より前の登録・加算にも対応するため、静的な配列に置く（動的確保しない）
+    //============================================================================
+    struct MetricDefinition
+    {
+        const char*   name    = nullptr;
+        MetricType    type    = MetricType::Counter;
+        MetricSampler sampler = nullptr;
+    };
+
+    // スレッド毎の累計値（所有スレッドのみが加算し、メインスレッドが合計する）
+    struct SL_CACHE_ALIGN MetricShard
+    {
+        std::atomic<uint64> values[Metrics::maxMetrics];
+    };
+
+    static MetricDefinition    definitions[Metrics::maxMetrics];
+    static std::atomic<uint32> numMetrics = 0;
+    static std::mutex          registerMutex;
+
+    static MetricShard               shards[Metrics::maxShards];
+    static std::atomic<uint32>       numShards   = 0;
+    static thread_local MetricShard* threadShard = nullptr;
+
+    static std::atomic<int64> gauges[Metrics::maxMetrics];
+
+
+    //============================================================================
+    // 履歴
+    //============================================================================
+    // メモリシステムより先に破棄されないように、Initialize で確保し Finalize で解放する
+    struct MetricsData
+    {
+        uint64            frameCount = 0;
+        PoolVector<int64> history; // [フレーム][ID]
+        uint64            lastTotals[Metrics::maxMetrics] = {}; // 前フレームまでのカウンターの累計
+    };
+
+    static MetricsData* data = nullptr;
+
+
+    static MetricShard* GetThreadShard()
+    {
+        if (threadShard == nullptr)
+        {
+            uint32 index = numShards.fetch_add(1, std::memory_order_relaxed);
+            threadShard = &shards[std::min(index, Metrics::maxShards - 1)];
+        }
+
+        return threadShard;
+    }
+
+    static MetricID Register(const char* name, MetricType type, MetricSampler sampler)
+    {
+        std::scoped_lock lock(registerMutex);
+
+        uint32 count = numMetrics.load(std::memory_order_relaxed);
+        for (MetricID id = 1; id <= count; id++)
+        {
+            if (std::strcmp(definitions[id].name, name) == 0)
+            {
+                SL_ASSERT(definitions[id].type == type, "同じ名前で種類の異なるメトリクスが登録されています");
+                return id;
+            }
+        }
+
+        if (count + 1 == Metrics::maxMetrics)
+        {
+            SL_LOG_WARN("メトリクスの登録数が上限に達しました: {}", name);
+            return Metrics::invalidMetric;
+        }
+
+        MetricID id = count + 1;
+        definitions[id].name    = name;
+        definitions[id].type    = type;
+        definitions[id].sampler = sampler;
+
+        // 登録情報を書き込んでから公開する
+        numMetrics.store(id, std::memory_order_release);
+        return id;
+    }
+
+
+    void Metrics::Initialize()
+    {
+        data = Memory::Allocate<MetricsData>();
+        data->history.resize(historySize * maxMetrics);
+    }
+
+    void Metrics::Finalize()
+    {
+        Memory::Deallocate(data);
+        data = nullptr;
+    }
+
+    MetricID Metrics::RegisterCounter(const char* name)
+    {
+        return Register(name, MetricType::Counter, nullptr);
+    }
+
+    MetricID Metrics::RegisterGauge(const char* name, MetricSampler sampler)
+    {
+        return Register(name, MetricType::Gauge, sampler);
+    }
+
+    void Metrics::Increment(MetricID id, uint64 value)
+    {
+        GetThreadShard()->values[id].fetch_add(value, std::memory_order_relaxed);
+    }
+
+    void Metrics::SetGauge(MetricID id, int64 value)
+    {
+        gauges[id].store(value, std::memory_order_relaxed);
+    }
+
+    void Metrics::NextFrame()
+    {
+        uint32 count         = numMetrics.load(std::memory_order_acquire);
+        uint32 numUsedShards = std::min(numShards.load(std::memory_order_relaxed), maxShards);
+        int64* snapshot      = &data->history[(data->frameCount % historySize) * maxMetrics];
+
+        for (MetricID id = 1; id <= count; id++)
+        {
+            const MetricDefinition& definition = definitions[id];
+
+            if (definition.type == MetricType::Counter)
+            {
+                // 累計の差分なので、合計中に加算されても次のフレームに繰り越されるだけで失われない
+                uint64 total = 0;
+                for (uint32 i = 0; i < numUsedShards; i++)
+                {
+                    total += shards[i].values[id].load(std::memory_order_relaxed);
+                }
+
+                snapshot[id]         = (int64)(total - data->lastTotals[id]);
+                data->lastTotals[id] = total;
+            }
+            else
+            {
+                snapshot[id] = definition.sampler ? definition.sampler() : gauges[id].load(std::memory_order_relaxed);
+            }
+        }
+
+        data->frameCount++;
+
+        if (Profiler::IsCapturing())
+        {
+            for (MetricID id = 1; id <= count; id++)
+            {
+                Profiler::AddCounter(definitions[id].name, (double)snapshot[id]);
+            }
+        }
+    }
+
+    uint32 Metrics::GetMetricCount()
+    {
+        return numMetrics.load(std::memory_order_acquire);
+    }
+
+    const char* Metrics::GetName(MetricID id)
+    {
+        return definitions[id].name;
+    }
+
+    MetricType Metrics::GetType(MetricID id)
+    {
+        return definitions[id].type;
+    }
+
+    int64 Metrics::GetValue(MetricID id)
+    {
+        if (data->frameCount == 0)
+            return 0;
+
+        return data->history[((data->frameCount - 1) % historySize) * maxMetrics + id];
+    }
+
+    uint32 Metrics::GetHistory(MetricID id, int64* outValues, uint32 maxCount)
+    {
+        uint32 count = (uint32)std::min<uint64>({ data->frameCount, historySize, maxCount });
+        uint64 begin = data->frameCount - count;
+
+        for (uint32 i = 0; i < count; i++)
+        {
+            outValues[i] = data->history[((begin + i) % historySize) * maxMetrics + id];
+        }
+
+        return count;
+    }
+
+    bool Metrics::WriteCsv(const std::string& filePath)
+    {
+        std::ofstream fout(filePath);
+        if (!fout)
+        {
+            SL_LOG_ERROR("メトリクスを書き出せません: {}", filePath);
+            return false;
+        }
+
+        uint32 count = GetMetricCount();
+
+        fout << "frame";
+        for (MetricID id = 1; id <= count; id++)
+        {
+            fout << ",\"" << definitions[id].name << "\"";
+        }
+        fout << "\n";
+
+        uint64 numFrames = std::min<uint64>(data->frameCount, historySize);
+        uint64 begin     = data->frameCount - numFrames;
+
+        for (uint64 frame = begin; frame < data->frameCount; frame++)
+        {
+            const int64* snapshot = &data->history[(frame % historySize) * maxMetrics];
+
+            fout << frame;
+            for (MetricID id = 1; id <= count; id++)
+            {
+                fout << "," << snapshot[id];
+            }
+            fout << "\n";
+        }
+
+        SL_LOG_INFO("メトリクスを書き出しました: {}", filePath);
+        return true;
+    }
+}
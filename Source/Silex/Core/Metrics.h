@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Core/CoreType.h"
+
+#include <string>
+
+
+namespace Silex
+{
+    enum class MetricType : uint8
+    {
+        Counter, // フレーム毎の加算量（スナップショットには前フレームからの増分が入る）
+        Gauge,   // 現在値（スナップショット時の値）
+    };
+
+    // 0 は未登録の ID（加算は捨てられ、表示・書き出しもされない）
+    using MetricID = uint32;
+
+    // ゲージをスナップショット時に読み取る関数（メインスレッドから呼ばれる）
+    using MetricSampler = int64(*)();
+
+
+    //=========================================================================
+    // メトリクス（名前付きカウンター・ゲージ）
+    //-------------------------------------------------------------------------
+    // サブシステムは 1度だけ登録して ID を保持し、以降は Increment（relaxed の加算 1回）で記録する
+    // カウンターはスレッド毎のシャードに加算するので、複数スレッドから加算しても競合しない
+    //
+    // NextFrame でシャードを合計してスナップショットを取り、historySize フレーム分の履歴に残す
+    // キャプチャ中は、スナップショットをプロファイラーのカウンタートラックにも記録する
+    //
+    // 登録は Initialize より前（メモリシステムの初期化中など）からでも行える
+    //=========================================================================
+    class Metrics
+    {
+    public:
+
+        static constexpr uint32   maxMetrics    = 128; // ID 0 を含む
+        static constexpr uint32   maxShards     = 64;  // 超えたスレッドは最後のシャードを共有する
+        static constexpr uint32   historySize   = 1024;
+        static constexpr MetricID invalidMetric = 0;
+
+        static void Initialize();
+        static void Finalize();
+
+        // 同じ名前で登録済みなら、その ID を返す（name は文字列リテラルを渡すこと）
+        static MetricID RegisterCounter(const char* name);
+        static MetricID RegisterGauge(const char* name, MetricSampler sampler = nullptr);
+
+        // 任意のスレッドから呼び出せる
+        static void Increment(MetricID id, uint64 value = 1);
+        static void SetGauge(MetricID id, int64 value);
+
+        // 全メトリクスのスナップショットを取る（メインスレッドからフレーム毎に 1回、Profiler::NextFrame より前に呼び出す）
+        static void NextFrame();
+
+        // 登録済みのメトリクス数（ID は 1 から GetMetricCount() まで）
+        static uint32      GetMetricCount();
+        static const char* GetName(MetricID id);
+        static MetricType  GetType(MetricID id);
+
+        // 直前のスナップショットの値
+        static int64 GetValue(MetricID id);
+
+        // 履歴を古い順にコピーし、コピーした数を返す
+        static uint32 GetHistory(MetricID id, int64* outValues, uint32 maxCount);
+
+        // 履歴を CSV（行: フレーム、列: メトリクス）で書き出す
+        static bool WriteCsv(const std::string& filePath);
+    };
+}
@@ -37,8 +37,21 @@ namespace Silex
 
         // 時間
         virtual uint64 GetTickSeconds()       = 0;
+        virtual uint64 GetTickNanoseconds()   = 0;
         virtual void   Sleep(uint32 millisec) = 0;
 
+        // 仮想メモリ（address を指定した場合は、そのアドレスに確保できなければ失敗する）
+        virtual void*  ReserveMemory(uint64 size, void* address = nullptr) = 0;
+        virtual bool   CommitMemory(void* ptr, uint64 size)                = 0;
+        virtual void   DecommitMemory(void* ptr, uint64 size)              = 0;
+        virtual void   ReleaseMemory(void* ptr, uint64 size)               = 0;
+        virtual uint64 GetPageSize()                                       = 0;
+
+        // ラージページ（使用できない場合はサイズが 0）
+        // ラージページは後からコミットできないので、予約とコミットを同時に行う。解放は ReleaseMemory で行う
+        virtual void*  AllocateLargePages(uint64 size, void* address = nullptr) = 0;
+        virtual uint64 GetLargePageSize()                                       = 0;
+
         // ファイル
         virtual std::string OpenFile(const char* filter = "All\0*.*\0")                                  = 0;
         virtual std::string SaveFile(const char* filter = "All\0*.*\0", const char* extention = nullptr) = 0;
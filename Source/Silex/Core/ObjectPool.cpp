@@ -0,0 +1,212 @@
+
+#include "PCH.h"
+
+#include "Core/ObjectPool.h"
+#include "Core/OS.h"
+
+
+namespace Silex
+{
+    namespace Internal
+    {
+        SL_FORCEINLINE static uint64 AlignUp(uint64 value, uint64 align)
+        {
+            return (value + (align - 1)) & ~(align - 1);
+        }
+    }
+
+
+    //============================================================================
+    // 全プールのアドレス空間
+    //============================================================================
+    void ObjectPoolBase::Initialize()
+    {
+        // アドレス空間のみ予約し、スラブ単位でコミットする
+        regionBase = static_cast<byte*>(OS::Get()->ReserveMemory(reserveByteSize * maxPools));
+        SL_ASSERT(regionBase != nullptr);
+    }
+
+    void ObjectPoolBase::Finalize()
+    {
+        OS::Get()->ReleaseMemory(regionBase, reserveByteSize * maxPools);
+        regionBase = nullptr;
+
+        // プール自体は静的変数なので残り続ける。再初期化に備えて状態のみ戻す
+        uint32 count = numPools.load(std::memory_order_acquire);
+        for (uint32 i = 0; i < count; i++)
+        {
+            ObjectPoolBase* pool = pools[i];
+
+            std::scoped_lock lock(pool->mutex);
+            pool->numSlabs    = 0;
+            pool->numObjects  = 0;
+            pool->peakObjects = 0;
+            pool->freeList    = nullptr;
+        }
+    }
+
+    void ObjectPoolBase::DeallocateAny(void* pointer)
+    {
+        uint32 index = (uint32)(((byte*)pointer - regionBase) >> reserveShift);
+        SL_ASSERT(index < numPools.load(std::memory_order_acquire));
+
+        pools[index]->DeallocateSlot(pointer);
+    }
+
+    void ObjectPoolBase::RetireAny(void* pointer)
+    {
+        uint32 index = (uint32)(((byte*)pointer - regionBase) >> reserveShift);
+        SL_ASSERT(index < numPools.load(std::memory_order_acquire));
+
+        pools[index]->RetireSlot(pointer);
+    }
+
+    void ObjectPoolBase::GetAllStatus(std::vector<ObjectPoolStatus>& outStatus)
+    {
+        uint32 count = numPools.load(std::memory_order_acquire);
+        for (uint32 i = 0; i < count; i++)
+        {
+            outStatus.push_back(pools[i]->GetStatus());
+        }
+    }
+
+
+    //============================================================================
+    // プール
+    //============================================================================
+    ObjectPoolBase::ObjectPoolBase(uint64 objectSize, uint64 objectAlignment, const char* typeName)
+        : typeName(typeName)
+        , objectSize(objectSize)
+    {
+        // スラブはページ境界に揃えるので、スロットのアライメントはヘッダーサイズ以下なら保証される
+        stride       = Internal::AlignUp(objectSize, objectAlignment);
+        slabByteSize = Internal::AlignUp(slabHeaderByteSize + stride * objectsPerSlab, OS::Get()->GetPageSize());
+        maxSlabs     = (uint32)(reserveByteSize / slabByteSize);
+
+        poolIndex = numPools.fetch_add(1, std::memory_order_acq_rel);
+        SL_ASSERT(poolIndex < maxPools, "オブジェクトプールの数が上限を超えています");
+
+        pools[poolIndex] = this;
+    }
+
+    bool ObjectPoolBase::CommitSlab()
+    {
+        if (numSlabs >= maxSlabs)
+            return false;
+
+        byte* slab = GetBase() + numSlabs * slabByteSize;
+        if (!OS::Get()->CommitMemory(slab, slabByteSize))
+            return false;
+
+        reinterpret_cast<Slab*>(slab)->allocated = 0;
+        reinterpret_cast<Slab*>(slab)->occupied  = 0;
+
+        // 先頭のスロットから使われるよう、逆順に空きリストへ積む
+        byte* slots = slab + slabHeaderByteSize;
+        for (int32 i = objectsPerSlab - 1; i >= 0; i--)
+        {
+            FreeSlot* slot = reinterpret_cast<FreeSlot*>(slots + i * stride);
+            slot->next = freeList;
+            freeList   = slot;
+        }
+
+        numSlabs++;
+        return true;
+    }
+
+    ObjectPoolBase::Slab* ObjectPoolBase::GetSlab(void* pointer, uint64& outSlotIndex) const
+    {
+        uint64 offset    = (byte*)pointer - GetBase();
+        uint64 slabIndex = offset / slabByteSize;
+        outSlotIndex     = (offset - slabIndex * slabByteSize - slabHeaderByteSize) / stride;
+
+        return reinterpret_cast<Slab*>(GetBase() + slabIndex * slabByteSize);
+    }
+
+    void* ObjectPoolBase::AllocateSlot()
+    {
+        SL_ASSERT(regionBase != nullptr, "オブジェクトプールが初期化されていません");
+
+        std::scoped_lock lock(mutex);
+
+        if (freeList == nullptr)
+        {
+            bool committed = CommitSlab();
+            SL_ASSERT(committed, "オブジェクトプールの容量が不足しています");
+        }
+
+        FreeSlot* slot = freeList;
+        freeList = slot->next;
+
+        // 確保済みビットのみ立てる（使用中ビットはコンストラクタの完了後に PublishSlot で立てる）
+        uint64 slotIndex;
+        Slab*  slab = GetSlab(slot, slotIndex);
+        slab->allocated |= 1ull << slotIndex;
+
+        numObjects++;
+        peakObjects = std::max(peakObjects, numObjects);
+
+        return slot;
+    }
+
+    void ObjectPoolBase::DeallocateSlot(void* pointer)
+    {
+        if (pointer == nullptr)
+            return;
+
+        std::scoped_lock lock(mutex);
+
+        uint64 slotIndex;
+        Slab*  slab = GetSlab(pointer, slotIndex);
+        SL_ASSERT(slab->allocated & (1ull << slotIndex), "解放済みのオブジェクトを解放しようとしました");
+
+        // RetireSlot を経ずに解放された場合も、走査の対象から外す
+        slab->allocated &= ~(1ull << slotIndex);
+        slab->occupied  &= ~(1ull << slotIndex);
+
+        FreeSlot* slot = static_cast<FreeSlot*>(pointer);
+        slot->next = freeList;
+        freeList   = slot;
+
+        numObjects--;
+    }
+
+    void ObjectPoolBase::PublishSlot(void* pointer)
+    {
+        std::scoped_lock lock(mutex);
+
+        uint64 slotIndex;
+        Slab*  slab = GetSlab(pointer, slotIndex);
+        SL_ASSERT(slab->allocated & (1ull << slotIndex), "確保されていないスロットです");
+
+        slab->occupied |= 1ull << slotIndex;
+    }
+
+    void ObjectPoolBase::RetireSlot(void* pointer)
+    {
+        if (pointer == nullptr)
+            return;
+
+        // 走査中ならその完了を待ってから外すので、デストラクタと走査は重ならない
+        std::scoped_lock lock(mutex);
+
+        uint64 slotIndex;
+        Slab*  slab = GetSlab(pointer, slotIndex);
+        slab->occupied &= ~(1ull << slotIndex);
+    }
+
+    ObjectPoolStatus ObjectPoolBase::GetStatus() const
+    {
+        std::scoped_lock lock(mutex);
+
+        ObjectPoolStatus status;
+        status.typeName      = typeName;
+        status.objectSize    = (uint32)objectSize;
+        status.numObjects    = numObjects;
+        status.peakObjects   = peakObjects;
+        status.numSlabs      = numSlabs;
+        status.committedSize = numSlabs * slabByteSize;
+
+        return status;
+    }
+}
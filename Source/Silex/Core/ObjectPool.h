@@ -0,0 +1,227 @@
+#pragma once
+
+#include "Core/Macros.h"
+#include "Core/CoreType.h"
+#include "Core/MemoryTracker.h"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <vector>
+
+
+namespace Silex
+{
+    struct ObjectPoolStatus
+    {
+        const char* typeName      = nullptr;
+        uint32      objectSize    = 0;
+        uint32      numObjects    = 0;
+        uint32      peakObjects   = 0;
+        uint32      numSlabs      = 0;
+        uint64      committedSize = 0;
+    };
+
+
+    //=========================================================================
+    // 型専用プールの使用指定
+    //-------------------------------------------------------------------------
+    // 特殊化した型は Memory::Allocate / CreateShared で ObjectPool<T> から確保される
+    // 特殊化はクラス定義の直後に SL_USE_OBJECT_POOL(T) で宣言する（確保より前に見える必要がある）
+    //=========================================================================
+    template<typename T>
+    struct UseObjectPool : Traits::TFalse {};
+
+    #define SL_USE_OBJECT_POOL(T) template<> struct UseObjectPool<T> : Traits::TTrue {};
+
+
+    //=========================================================================
+    // オブジェクトプール 基底（型に依存しない管理部分）
+    //-------------------------------------------------------------------------
+    // 全ての型のプールで連続した仮想アドレス空間を予約し、型毎に 256MB ずつ割り当てる
+    // スラブ（64 オブジェクト）単位でコミットし、スラブ先頭の使用中ビットマスクで生存オブジェクトを走査する
+    // 解放時はアドレスからプールを求めるので、基底クラスのポインタからでも解放できる
+    //
+    // 使用中ビットは確保済みビットとは別に、コンストラクタの完了後に Publish で立て、デストラクタの前に
+    // Retire で下ろす。走査（ロック中）は構築途中・破棄途中のオブジェクトを見ないので、他スレッドの
+    // 確保・解放と並行して走査できる
+    //=========================================================================
+    class ObjectPoolBase
+    {
+    public:
+
+        static constexpr uint32 maxPools           = 64;
+        static constexpr uint32 reserveShift       = 28;
+        static constexpr uint64 reserveByteSize    = 1ull << reserveShift;
+        static constexpr uint32 objectsPerSlab     = 64;
+        static constexpr uint64 slabHeaderByteSize = 64;
+
+    public:
+
+        // 全プールのアドレス空間の予約・解放
+        static void Initialize();
+        static void Finalize();
+
+        static bool Contains(const void* pointer)
+        {
+            return regionBase <= (const byte*)pointer && (const byte*)pointer < regionBase + reserveByteSize * maxPools;
+        }
+
+        // アドレスから所属するプールを求めて解放する（デストラクタは呼び出し側で呼ぶ）
+        static void DeallocateAny(void* pointer);
+
+        // アドレスから所属するプールを求めて、走査の対象から外す（デストラクタの前に呼ぶ）
+        static void RetireAny(void* pointer);
+
+        static void GetAllStatus(std::vector<ObjectPoolStatus>& outStatus);
+
+        ObjectPoolStatus GetStatus() const;
+
+    protected:
+
+        ObjectPoolBase(uint64 objectSize, uint64 objectAlignment, const char* typeName);
+        ~ObjectPoolBase() = default;
+
+        void* AllocateSlot();
+        void  DeallocateSlot(void* pointer);
+
+        // 構築済みのオブジェクトを走査の対象にする / 外す
+        void PublishSlot(void* pointer);
+        void RetireSlot(void* pointer);
+
+        // 構築済みのオブジェクトをアドレス順に走査する（関数内でこのプールから確保・解放しないこと）
+        template<typename Function>
+        void ForEachSlot(Function&& function)
+        {
+            std::scoped_lock lock(mutex);
+
+            byte* base = GetBase();
+            for (uint32 slabIndex = 0; slabIndex < numSlabs; slabIndex++)
+            {
+                byte*  slab     = base + slabIndex * slabByteSize;
+                uint64 occupied = reinterpret_cast<Slab*>(slab)->occupied;
+
+                while (occupied)
+                {
+                    uint32 slot = (uint32)std::countr_zero(occupied);
+                    occupied &= occupied - 1;
+
+                    function(slab + slabHeaderByteSize + slot * stride);
+                }
+            }
+        }
+
+    private:
+
+        // スラブ先頭の管理データ
+        struct Slab
+        {
+            uint64 allocated; // 確保済み（二重解放の検出用）
+            uint64 occupied;  // 構築済み（走査の対象）
+        };
+
+        // 空きスロットは先頭に次の空きスロットへのポインタを格納する
+        struct FreeSlot
+        {
+            FreeSlot* next;
+        };
+
+        byte* GetBase() const
+        {
+            return regionBase + reserveByteSize * poolIndex;
+        }
+
+        bool CommitSlab();
+
+        // スロットの属するスラブとスロット番号を求める
+        Slab* GetSlab(void* pointer, uint64& outSlotIndex) const;
+
+    private:
+
+        const char* typeName     = nullptr;
+        uint64      objectSize   = 0;
+        uint64      stride       = 0;
+        uint64      slabByteSize = 0;
+        uint32      maxSlabs     = 0;
+        uint32      poolIndex    = 0;
+
+        uint32    numSlabs    = 0;
+        uint32    numObjects  = 0;
+        uint32    peakObjects = 0;
+        FreeSlot* freeList    = nullptr;
+
+        mutable std::mutex mutex;
+
+    private:
+
+        static inline byte*                                 regionBase = nullptr;
+        static inline std::atomic<uint32>                   numPools   = 0;
+        static inline std::array<ObjectPoolBase*, maxPools> pools      = {};
+
+    private:
+
+        ObjectPoolBase(ObjectPoolBase&)             = delete;
+        ObjectPoolBase(ObjectPoolBase&&)            = delete;
+        ObjectPoolBase& operator=(ObjectPoolBase&)  = delete;
+        ObjectPoolBase& operator=(ObjectPoolBase&&) = delete;
+    };
+
+
+    //=========================================================================
+    // 型専用オブジェクトプール
+    //-------------------------------------------------------------------------
+    // 同じ型のオブジェクトを専用のスラブに詰めて配置し、生存オブジェクトを連続して走査できる
+    // 確保するのはメモリのみで、コンストラクタ・デストラクタは Memory 側で呼び出す
+    // （Memory はコンストラクタの後に Publish、デストラクタの前に Retire を呼ぶ）
+    //=========================================================================
+    template<typename T>
+    class ObjectPool : public ObjectPoolBase
+    {
+    public:
+
+        static_assert(sizeof(T)  >= sizeof(void*),     "空きリストのポインタを格納できるサイズが必要です");
+        static_assert(alignof(T) <= slabHeaderByteSize, "スラブヘッダー サイズを超えるアライメントには対応していません");
+
+        static ObjectPool& Get()
+        {
+            static ObjectPool pool;
+            return pool;
+        }
+
+        void* Allocate()
+        {
+            return AllocateSlot();
+        }
+
+        void Deallocate(T* pointer)
+        {
+            DeallocateSlot(pointer);
+        }
+
+        void Publish(T* pointer)
+        {
+            PublishSlot(pointer);
+        }
+
+        void Retire(T* pointer)
+        {
+            RetireSlot(pointer);
+        }
+
+        template<typename Function>
+        void ForEach(Function&& function)
+        {
+            ForEachSlot([&](void* pointer)
+            {
+                function(*static_cast<T*>(pointer));
+            });
+        }
+
+    private:
+
+        ObjectPool()
+            : ObjectPoolBase(sizeof(T), alignof(T), GetTrackingTypeName<T>())
+        {}
+    };
+}
@@ -0,0 +1,347 @@
+#pragma once
+
+#include "Core/ThreadPool.h"
+#include "Core/MemoryResource.h"
+#include "Core/Profiler.h"
+
+#include <array>
+#include <atomic>
+#include <functional>
+
+
+namespace Silex
+{
+    namespace Internal
+    {
+        // 自動の分割サイズ（スレッド数の数倍に分割し、負荷の偏りを吸収する）
+        inline uint64 GetAutoGrainSize(uint64 count)
+        {
+            uint64 numSplits = (uint64)(ThreadPool::GetThreadCount() + 1) * 4;
+            return std::max<uint64>(count / numSplits, 1);
+        }
+
+        // 分割した範囲をワーカーと呼び出しスレッドで取り合って実行する
+        // function(chunkIndex, begin, end)
+        template<typename Function>
+        void ParallelChunks(uint64 begin, uint64 end, uint64 grainSize, Function&& function)
+        {
+            if (begin >= end)
+                return;
+
+            uint64 count     = end - begin;
+            uint64 numChunks = (count + grainSize - 1) / grainSize;
+            uint64 numTasks  = std::min<uint64>(numChunks - 1, ThreadPool::GetThreadCount());
+
+            // 分割できない・ワーカーが無い場合は直列で実行
+            if (numTasks == 0)
+            {
+                for (uint64 chunk = 0; chunk < numChunks; chunk++)
+                {
+                    uint64 chunkBegin = begin + chunk * grainSize;
+                    function(chunk, chunkBegin, std::min(chunkBegin + grainSize, end));
+                }
+
+                return;
+            }
+
+            std::atomic<uint64> nextChunk = 0;
+
+            // ワーカーで実行した範囲も、呼び出し元のスコープの子として計測する
+            ProfileLink parent = Profiler::GetCurrentScope();
+
+            auto run = [&]()
+            {
+                ProfileParentScope parentScope(parent);
+
+                uint64 chunk;
+                while ((chunk = nextChunk.fetch_add(1, std::memory_order_relaxed)) < numChunks)
+                {
+                    uint64 chunkBegin = begin + chunk * grainSize;
+                    function(chunk, chunkBegin, std::min(chunkBegin + grainSize, end));
+                }
+            };
+
+            // キャプチャがスロットに収まるように、run は参照で渡す（Wait で完了を待つまで有効）
+            TaskCounter counter;
+            for (uint64 i = 0; i < numTasks; i++)
+            {
+                ThreadPool::AddTask([&run]() { run(); }, counter);
+            }
+
+            // 呼び出しスレッドも分割範囲を処理し、残りはワーカーの完了を待つ
+            run();
+            ThreadPool::Wait(counter);
+        }
+
+        // ペイロード無しのソート用
+        struct NoPayload {};
+    }
+
+
+    //=========================================================================
+    // 並列 for
+    //-------------------------------------------------------------------------
+    // [begin, end) を grainSize 毎に分割して ThreadPool で実行する（0 なら自動）
+    // 分割数が 1つ以下なら呼び出しスレッドでそのまま実行する
+    // function(index)
+    //=========================================================================
+    template<typename Function>
+    void ParallelFor(uint64 begin, uint64 end, Function&& function, uint64 grainSize = 0)
+    {
+        if (begin >= end)
+            return;
+
+        if (grainSize == 0)
+        {
+            grainSize = Internal::GetAutoGrainSize(end - begin);
+        }
+
+        Internal::ParallelChunks(begin, end, grainSize, [&](uint64, uint64 chunkBegin, uint64 chunkEnd)
+        {
+            for (uint64 i = chunkBegin; i < chunkEnd; i++)
+            {
+                function(i);
+            }
+        });
+    }
+
+    // 分割した範囲単位で実行する  function(begin, end)
+    template<typename Function>
+    void ParallelForRange(uint64 begin, uint64 end, Function&& function, uint64 grainSize = 0)
+    {
+        if (begin >= end)
+            return;
+
+        if (grainSize == 0)
+        {
+            grainSize = Internal::GetAutoGrainSize(end - begin);
+        }
+
+        Internal::ParallelChunks(begin, end, grainSize, [&](uint64, uint64 chunkBegin, uint64 chunkEnd)
+        {
+            function(chunkBegin, chunkEnd);
+        });
+    }
+
+
+    //=========================================================================
+    // 並列リダクション
+    //-------------------------------------------------------------------------
+    // 分割範囲毎に identity から畳み込み、分割範囲の結果を順番に combine する
+    // 分割は実行するスレッドに依存しないので、浮動小数点でも結果は毎回同じになる
+    // map(index) -> T,  combine(T, T) -> T
+    //=========================================================================
+    template<typename T, typename Map, typename Combine>
+    T ParallelReduce(uint64 begin, uint64 end, T identity, Map&& map, Combine&& combine, uint64 grainSize = 0)
+    {
+        if (begin >= end)
+            return identity;
+
+        if (grainSize == 0)
+        {
+            grainSize = Internal::GetAutoGrainSize(end - begin);
+        }
+
+        uint64 numChunks = (end - begin + grainSize - 1) / grainSize;
+        PoolVector<T> partials(numChunks, identity);
+
+        Internal::ParallelChunks(begin, end, grainSize, [&](uint64 chunk, uint64 chunkBegin, uint64 chunkEnd)
+        {
+            T value = identity;
+            for (uint64 i = chunkBegin; i < chunkEnd; i++)
+            {
+                value = combine(value, map(i));
+            }
+
+            partials[chunk] = value;
+        });
+
+        T result = identity;
+        for (const T& partial : partials)
+        {
+            result = combine(result, partial);
+        }
+
+        return result;
+    }
+
+
+    //=========================================================================
+    // 並列 排他的スキャン（output[i] = init + input[0] + ... + input[i - 1]）
+    //-------------------------------------------------------------------------
+    // 分割範囲毎の合計 → 分割範囲の先頭値（直列）→ 分割範囲内のスキャン の 2パスで行う
+    // input と output は同じ配列でもよい
+    //=========================================================================
+    template<typename T, typename Combine = std::plus<T>>
+    void ParallelExclusiveScan(const T* input, T* output, uint64 count, T init, Combine&& combine = Combine(), uint64 grainSize = 0)
+    {
+        if (count == 0)
+            return;
+
+        if (grainSize == 0)
+        {
+            grainSize = Internal::GetAutoGrainSize(count);
+        }
+
+        uint64 numChunks = (count + grainSize - 1) / grainSize;
+        PoolVector<T> chunkSums(numChunks);
+
+        // 分割範囲毎の合計（最後の分割範囲は不要）
+        Internal::ParallelChunks(0, (numChunks - 1) * grainSize, grainSize, [&](uint64 chunk, uint64 chunkBegin, uint64 chunkEnd)
+        {
+            T sum = input[chunkBegin];
+            for (uint64 i = chunkBegin + 1; i < chunkEnd; i++)
+            {
+                sum = combine(sum, input[i]);
+            }
+
+            chunkSums[chunk] = sum;
+        });
+
+        // 分割範囲の先頭値
+        T running = init;
+        for (uint64 chunk = 0; chunk < numChunks; chunk++)
+        {
+            T sum = chunkSums[chunk];
+            chunkSums[chunk] = running;
+            running = combine(running, sum);
+        }
+
+        // 分割範囲内のスキャン（上書きする前に入力を読む）
+        Internal::ParallelChunks(0, count, grainSize, [&](uint64 chunk, uint64 chunkBegin, uint64 chunkEnd)
+        {
+            T value = chunkSums[chunk];
+            for (uint64 i = chunkBegin; i < chunkEnd; i++)
+            {
+                T next = combine(value, input[i]);
+                output[i] = value;
+                value = next;
+            }
+        });
+    }
+
+
+    //=========================================================================
+    // 並列 基数ソート（LSD, 8bit 毎, 安定）
+    //-------------------------------------------------------------------------
+    // キーは uint32 / uint64。ペイロード（values）をキーと一緒に並べ替える
+    // 各パスは、ブロック毎のヒストグラム（並列）→ 出力位置の計算（直列）→ 振り分け（並列）
+    // 全キーで同じ値になる桁のパスは飛ばす
+    //=========================================================================
+    template<typename Key, typename Value>
+    void ParallelRadixSort(Key* keys, Value* values, uint64 count, uint64 grainSize = 0)
+    {
+        static_assert(Traits::IsSame<Key, uint32>() || Traits::IsSame<Key, uint64>(), "キーは uint32 / uint64 のみ対応しています");
+
+        static constexpr bool   hasPayload = !Traits::IsSame<Value, Internal::NoPayload>();
+        static constexpr uint32 radixBits  = 8;
+        static constexpr uint32 radixSize  = 1 << radixBits;
+        static constexpr uint32 numPasses  = sizeof(Key) * 8 / radixBits;
+
+        if (count <= 1)
+            return;
+
+        if (grainSize == 0)
+        {
+            // ヒストグラムの集計コストに見合うよう、小さく分割しすぎない
+            grainSize = std::max<uint64>(Internal::GetAutoGrainSize(count), 4096);
+        }
+
+        uint64 numBlocks = (count + grainSize - 1) / grainSize;
+
+        PoolVector<Key>                           tempKeys(count);
+        PoolVector<Value>                         tempValues(hasPayload ? count : 0);
+        PoolVector<std::array<uint64, radixSize>> offsets(numBlocks);
+
+        Key*   srcKeys   = keys;
+        Key*   dstKeys   = tempKeys.data();
+        Value* srcValues = values;
+        Value* dstValues = tempValues.data();
+
+        for (uint32 pass = 0; pass < numPasses; pass++)
+        {
+            uint32 shift = pass * radixBits;
+
+            // ブロック毎のヒストグラム
+            Internal::ParallelChunks(0, count, grainSize, [&](uint64 block, uint64 blockBegin, uint64 blockEnd)
+            {
+                std::array<uint64, radixSize>& histogram = offsets[block];
+                histogram.fill(0);
+
+                for (uint64 i = blockBegin; i < blockEnd; i++)
+                {
+                    histogram[(srcKeys[i] >> shift) & (radixSize - 1)]++;
+                }
+            });
+
+            // 全てのキーがこの桁で同じ値なら並べ替える必要はない（桁毎に全ブロックの合計で判定する）
+            bool skipped = false;
+            for (uint32 digit = 0; digit < radixSize && !skipped; digit++)
+            {
+                uint64 digitCount = 0;
+                for (uint64 block = 0; block < numBlocks; block++)
+                {
+                    digitCount += offsets[block][digit];
+                }
+
+                skipped = digitCount == count;
+            }
+
+            if (skipped)
+                continue;
+
+            // 桁の値 → ブロックの順に並べて出力位置を求める（ブロック内の順序を保つので安定）
+            uint64 total = 0;
+            for (uint32 digit = 0; digit < radixSize; digit++)
+            {
+                for (uint64 block = 0; block < numBlocks; block++)
+                {
+                    uint64 num = offsets[block][digit];
+                    offsets[block][digit] = total;
+                    total += num;
+                }
+            }
+
+            // 振り分け
+            Internal::ParallelChunks(0, count, grainSize, [&](uint64 block, uint64 blockBegin, uint64 blockEnd)
+            {
+                std::array<uint64, radixSize>& offset = offsets[block];
+
+                for (uint64 i = blockBegin; i < blockEnd; i++)
+                {
+                    uint64 index = offset[(srcKeys[i] >> shift) & (radixSize - 1)]++;
+                    dstKeys[index] = srcKeys[i];
+
+                    if constexpr (hasPayload)
+                    {
+                        dstValues[index] = srcValues[i];
+                    }
+                }
+            });
+
+            std::swap(srcKeys, dstKeys);
+            std::swap(srcValues, dstValues);
+        }
+
+        // 奇数回振り分けた場合は、結果が一時バッファにあるので書き戻す
+        if (srcKeys != keys)
+        {
+            ParallelForRange(0, count, [&](uint64 begin, uint64 end)
+            {
+                std::copy(srcKeys + begin, srcKeys + end, keys + begin);
+
+                if constexpr (hasPayload)
+                {
+                    std::copy(srcValues + begin, srcValues + end, values + begin);
+                }
+            }, grainSize);
+        }
+    }
+
+    // キーのみ
+    template<typename Key>
+    void ParallelRadixSort(Key* keys, uint64 count, uint64 grainSize = 0)
+    {
+        ParallelRadixSort<Key, Internal::NoPayload>(keys, nullptr, count, grainSize);
+    }
+}
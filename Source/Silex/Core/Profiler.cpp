@@ -0,0 +1,520 @@
+
+#include "PCH.h"
+
+#include "Core/Profiler.h"
+#include "Core/LockFreeQueue.h"
+#include "Core/OS.h"
+
+#include <algorithm>
+
+
+namespace Silex
+{
+    //============================================================================
+    // スレッド毎の記録
+    //----------------------------------------------------------------------------
+    // スコープの終了時に 1つのイベントとして記録し、所有スレッドのみが追加する
+    // 取り出しはメインスレッドのみが行うので、SPSC キューで足りる
+    //============================================================================
+    static constexpr uint64 eventCapacity = 8192;
+    static constexpr uint32 maxScopeDepth = 64;
+
+    struct ProfileEvent
+    {
+        const char* name;
+        uint64      path;
+        uint64      parentPath;
+        uint64      begin;
+        uint64      end;
+    };
+
+    struct ProfileStackEntry
+    {
+        const char* name;
+        uint64      begin;
+        ProfileLink parent;
+    };
+
+    struct ProfileThreadState
+    {
+        SPSCQueue<ProfileEvent, eventCapacity> events;
+
+        ProfileStackEntry stack[maxScopeDepth];
+        uint32            stackSize      = 0;
+        uint32            overflowDepth  = 0; // 深さの上限を超えて記録しなかったスコープの数
+        ProfileLink       current;
+
+        std::atomic<uint64> dropped = 0;
+        ProfileThreadState* next    = nullptr;
+
+        uint32 index    = 0;
+        char   name[32] = {};
+    };
+
+    static std::atomic<ProfileThreadState*> threadStates    = nullptr;
+    static std::atomic<uint32>              numThreadStates = 0;
+    static std::atomic<bool>                enabled         = false;
+    static thread_local ProfileThreadState* threadState     = nullptr;
+
+
+    //============================================================================
+    // 集計
+    //============================================================================
+    struct ProfileEntry
+    {
+        const char* name;
+        uint64      path;
+        uint64      parentPath;
+        uint32      numCalls;
+        uint64      totalTime;
+        uint64      minTime;
+        uint64      maxTime;
+        uint64      firstBegin;
+        uint32      firstChild;
+        uint32      nextSibling;
+    };
+
+    static constexpr uint32 invalidEntry = ~0u;
+
+    // メモリシステムより先に破棄されないように、Initialize で確保し Finalize で解放する
+    struct ProfileFrameData
+    {
+        PoolVector<ProfileEntry>    entries;
+        PoolHashMap<uint64, uint32> entryIndices;
+        PoolVector<uint32>          entryOrder;
+        PoolVector<ProfileNode>     nodes;
+    };
+
+    static ProfileFrameData* frameData = nullptr;
+
+
+    //============================================================================
+    // キャプチャ
+    //----------------------------------------------------------------------------
+    // StartCapture の次のフレーム境界（NextFrame）から記録を開始する
+    //============================================================================
+    struct CaptureEvent
+    {
+        const char* name;
+        uint64      begin;
+        uint64      end;
+        uint32      threadIndex;
+    };
+
+    struct CaptureCounter
+    {
+        const char* name;
+        uint64      time;
+        double      value;
+    };
+
+    struct ProfileCapture
+    {
+        std::string filePath;
+        uint32      remainingFrames = 0;
+        bool        recording       = false;
+
+        PoolVector<CaptureEvent>   events;
+        PoolVector<CaptureCounter> counters;
+        PoolVector<uint64>         frameBoundaries;
+    };
+
+    static ProfileCapture* capture = nullptr;
+
+
+    static uint64 CombinePath(uint64 parent, const char* name)
+    {
+        uint64 value = (parent ^ (uint64)name) * 0x9E3779B97F4A7C15ull;
+        return value ^ (value >> 32);
+    }
+
+    static ProfileThreadState* GetThreadState(const char* name = nullptr)
+    {
+        if (threadState == nullptr)
+        {
+            threadState = Memory::Allocate<ProfileThreadState>();
+            threadState->index = numThreadStates.fetch_add(1, std::memory_order_relaxed);
+
+            // 名前はメインスレッドが読み込むので、リストに追加する前に書き込む
+            if (name)
+            {
+                std::snprintf(threadState->name, sizeof(threadState->name), "%s", name);
+            }
+            else
+            {
+                std::snprintf(threadState->name, sizeof(threadState->name), "Thread %u", threadState->index);
+            }
+
+            ProfileThreadState* head = threadStates.load(std::memory_order_relaxed);
+            do
+            {
+                threadState->next = head;
+            }
+            while (!threadStates.compare_exchange_weak(head, threadState, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        return threadState;
+    }
+
+
+    void Profiler::Initialize()
+    {
+        frameData = Memory::Allocate<ProfileFrameData>();
+        enabled.store(true, std::memory_order_release);
+
+        SetThreadName("Main Thread");
+    }
+
+    void Profiler::Finalize()
+    {
+        // 他のスレッド（ワーカー・レンダースレッド）が終了してから呼び出すこと
+        enabled.store(false, std::memory_order_release);
+
+        ProfileThreadState* state = threadStates.exchange(nullptr, std::memory_order_acquire);
+        while (state)
+        {
+            ProfileThreadState* next = state->next;
+            Memory::Deallocate(state);
+            state = next;
+        }
+
+        threadState = nullptr;
+        numThreadStates.store(0, std::memory_order_relaxed);
+
+        if (capture)
+        {
+            Memory::Deallocate(capture);
+            capture = nullptr;
+        }
+
+        Memory::Deallocate(frameData);
+        frameData = nullptr;
+    }
+
+    void Profiler::BeginScope(const char* name)
+    {
+        if (!enabled.load(std::memory_order_relaxed))
+            return;
+
+        ProfileThreadState* state = GetThreadState();
+        if (state->stackSize == maxScopeDepth)
+        {
+            state->overflowDepth++;
+            return;
+        }
+
+        ProfileStackEntry& entry = state->stack[state->stackSize++];
+        entry.name   = name;
+        entry.parent = state->current;
+
+        state->current.path  = CombinePath(state->current.path, name);
+        state->current.depth = state->current.depth + 1;
+
+        // 記録の準備を含めないように、最後に時刻を取得する
+        entry.begin = OS::Get()->GetTickNanoseconds();
+    }
+
+    void Profiler::EndScope()
+    {
+        uint64 end = OS::Get()->GetTickNanoseconds();
+
+        ProfileThreadState* state = threadState;
+        if (state == nullptr || state->stackSize == 0)
+            return;
+
+        if (state->overflowDepth != 0)
+        {
+            state->overflowDepth--;
+            return;
+        }
+
+        ProfileStackEntry& entry = state->stack[--state->stackSize];
+
+        ProfileEvent event;
+        event.name       = entry.name;
+        event.path       = state->current.path;
+        event.parentPath = entry.parent.path;
+        event.begin      = entry.begin;
+        event.end        = end;
+
+        if (!state->events.Push(event))
+        {
+            state->dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        state->current = entry.parent;
+    }
+
+    ProfileLink Profiler::GetCurrentScope()
+    {
+        return threadState ? threadState->current : ProfileLink();
+    }
+
+    void Profiler::SetCurrentScope(const ProfileLink& link)
+    {
+        if (!enabled.load(std::memory_order_relaxed))
+            return;
+
+        GetThreadState()->current = link;
+    }
+
+    std::string EscapeJson(const char* str)
+    {
+        std::string result;
+        for (; *str; str++)
+        {
+            if (*str == '"' || *str == '\\')
+            {
+                result.push_back('\\');
+            }
+
+            result.push_back(*str);
+        }
+
+        return result;
+    }
+
+    //============================================================================
+    // Chrome Trace Event 形式で書き出す
+    //----------------------------------------------------------------------------
+    // スコープは完了イベント（ph: X）、フレームは専用トラックのスライス、カウンターは ph: C で出力する
+    // 時刻の単位はマイクロ秒なので、ナノ秒を小数で出力する
+    //============================================================================
+    static void WriteCapture(const ProfileCapture& data)
+    {
+        static constexpr uint32 frameTrackID = ~0u >> 1;
+
+        std::ofstream fout(data.filePath);
+        if (!fout)
+        {
+            SL_LOG_ERROR("プロファイルキャプチャを書き出せません: {}", data.filePath);
+            return;
+        }
+
+        fout << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        fout << std::format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"Frame\"}}}}", frameTrackID);
+        fout << std::format(",\n{{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"sort_index\":-1}}}}", frameTrackID);
+
+        for (ProfileThreadState* state = threadStates.load(std::memory_order_acquire); state; state = state->next)
+        {
+            fout << std::format(",\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}", state->index, EscapeJson(state->name));
+            fout << std::format(",\n{{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"sort_index\":{}}}}}", state->index, state->index);
+        }
+
+        for (uint64 i = 1; i < data.frameBoundaries.size(); i++)
+        {
+            uint64 begin = data.frameBoundaries[i - 1];
+            uint64 end   = data.frameBoundaries[i];
+            fout << std::format(",\n{{\"name\":\"Frame {}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}", i - 1, frameTrackID, begin / 1000.0, (end - begin) / 1000.0);
+        }
+
+        for (const CaptureEvent& event : data.events)
+        {
+            fout << std::format(",\n{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}", EscapeJson(event.name), event.threadIndex, event.begin / 1000.0, (event.end - event.begin) / 1000.0);
+        }
+
+        for (const CaptureCounter& counter : data.counters)
+        {
+            fout << std::format(",\n{{\"name\":\"{}\",\"ph\":\"C\",\"pid\":1,\"ts\":{:.3f},\"args\":{{\"value\":{}}}}}", EscapeJson(counter.name), counter.time / 1000.0, counter.value);
+        }
+
+        fout << "\n]}\n";
+
+        SL_LOG_INFO("プロファイルキャプチャを書き出しました: {} ({} frames, {} events)", data.filePath, data.frameBoundaries.size() - 1, data.events.size());
+    }
+
+    // 集計したエントリーを深さ優先で出力する
+    static void EmitNode(ProfileFrameData& data, uint32 index, uint32 depth)
+    {
+        PoolVector<ProfileNode>& frameNodes = data.nodes;
+        const ProfileEntry&      entry      = data.entries[index];
+
+        uint64 nodeIndex = frameNodes.size();
+        ProfileNode& node = frameNodes.emplace_back();
+        node.name      = entry.name;
+        node.path      = entry.path;
+        node.depth     = depth;
+        node.numCalls  = entry.numCalls;
+        node.totalTime = entry.totalTime / 1'000'000.0f;
+        node.minTime   = entry.minTime   / 1'000'000.0f;
+        node.maxTime   = entry.maxTime   / 1'000'000.0f;
+
+        for (uint32 child = entry.firstChild; child != invalidEntry; child = data.entries[child].nextSibling)
+        {
+            EmitNode(data, child, depth + 1);
+        }
+
+        frameNodes[nodeIndex].numDescendants = (uint32)(frameNodes.size() - nodeIndex - 1);
+    }
+
+    void Profiler::NextFrame()
+    {
+        PoolVector<ProfileEntry>&    entries      = frameData->entries;
+        PoolHashMap<uint64, uint32>& entryIndices = frameData->entryIndices;
+        PoolVector<uint32>&          entryOrder   = frameData->entryOrder;
+
+        entries.clear();
+        entryIndices.clear();
+
+        bool recording = capture && capture->recording;
+
+        // 全スレッドの記録を、スコープの親子関係（パス）ごとに集計する
+        for (ProfileThreadState* state = threadStates.load(std::memory_order_acquire); state; state = state->next)
+        {
+            ProfileEvent event;
+            while (state->events.Pop(event))
+            {
+                uint64 time = event.end - event.begin;
+
+                if (recording)
+                {
+                    capture->events.push_back({ event.name, event.begin, event.end, state->index });
+                }
+
+                auto [it, inserted] = entryIndices.try_emplace(event.path, (uint32)entries.size());
+                if (inserted)
+                {
+                    ProfileEntry& entry = entries.emplace_back();
+                    entry.name       = event.name;
+                    entry.path       = event.path;
+                    entry.parentPath = event.parentPath;
+                    entry.numCalls   = 1;
+                    entry.totalTime  = time;
+                    entry.minTime    = time;
+                    entry.maxTime    = time;
+                    entry.firstBegin = event.begin;
+                }
+                else
+                {
+                    ProfileEntry& entry = entries[it->second];
+                    entry.numCalls++;
+                    entry.totalTime += time;
+                    entry.minTime    = std::min(entry.minTime, time);
+                    entry.maxTime    = std::max(entry.maxTime, time);
+                    entry.firstBegin = std::min(entry.firstBegin, event.begin);
+                }
+            }
+        }
+
+        // 兄弟は最初に開始した順に並べる（逆順に走査して、リストの先頭へ追加する）
+        entryOrder.resize(entries.size());
+        for (uint32 i = 0; i < entryOrder.size(); i++)
+        {
+            entryOrder[i] = i;
+        }
+
+        std::sort(entryOrder.begin(), entryOrder.end(), [&](uint32 a, uint32 b)
+        {
+            return entries[a].firstBegin < entries[b].firstBegin;
+        });
+
+        for (ProfileEntry& entry : entries)
+        {
+            entry.firstChild  = invalidEntry;
+            entry.nextSibling = invalidEntry;
+        }
+
+        uint32 firstRoot = invalidEntry;
+        for (auto it = entryOrder.rbegin(); it != entryOrder.rend(); ++it)
+        {
+            ProfileEntry& entry = entries[*it];
+
+            // 親がこのフレームで終了していない（フレームをまたぐスコープ）場合は、ルートとして扱う
+            auto parent = entryIndices.find(entry.parentPath);
+            if (parent != entryIndices.end())
+            {
+                entry.nextSibling = entries[parent->second].firstChild;
+                entries[parent->second].firstChild = *it;
+            }
+            else
+            {
+                entry.nextSibling = firstRoot;
+                firstRoot = *it;
+            }
+        }
+
+        frameData->nodes.clear();
+        for (uint32 root = firstRoot; root != invalidEntry; root = entries[root].nextSibling)
+        {
+            EmitNode(*frameData, root, 0);
+        }
+
+        if (capture)
+        {
+            capture->frameBoundaries.push_back(OS::Get()->GetTickNanoseconds());
+
+            if (!capture->recording)
+            {
+                capture->recording = true;
+            }
+            else if (--capture->remainingFrames == 0)
+            {
+                WriteCapture(*capture);
+
+                Memory::Deallocate(capture);
+                capture = nullptr;
+            }
+        }
+    }
+
+    const PoolVector<ProfileNode>& Profiler::GetFrameNodes()
+    {
+        return frameData->nodes;
+    }
+
+    void Profiler::SetThreadName(const char* name)
+    {
+        if (!enabled.load(std::memory_order_relaxed))
+            return;
+
+        if (threadState)
+        {
+            std::snprintf(threadState->name, sizeof(threadState->name), "%s", name);
+        }
+        else
+        {
+            GetThreadState(name);
+        }
+    }
+
+    bool Profiler::StartCapture(uint32 numFrames, const std::string& filePath)
+    {
+        if (!enabled.load(std::memory_order_relaxed) || capture || numFrames == 0)
+            return false;
+
+        capture = Memory::Allocate<ProfileCapture>();
+        capture->filePath        = filePath;
+        capture->remainingFrames = numFrames;
+
+        return true;
+    }
+
+    bool Profiler::IsCapturing()
+    {
+        return capture != nullptr;
+    }
+
+    uint32 Profiler::GetCaptureRemainingFrames()
+    {
+        return capture ? capture->remainingFrames : 0;
+    }
+
+    void Profiler::AddCounter(const char* name, double value)
+    {
+        if (capture && capture->recording)
+        {
+            capture->counters.push_back({ name, OS::Get()->GetTickNanoseconds(), value });
+        }
+    }
+
+    uint64 Profiler::GetDroppedCount()
+    {
+        uint64 dropped = 0;
+        for (ProfileThreadState* state = threadStates.load(std::memory_order_acquire); state; state = state->next)
+        {
+            dropped += state->dropped.load(std::memory_order_relaxed);
+        }
+
+        return dropped;
+    }
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "Core/CoreType.h"
+#include "Core/Macros.h"
+#include "Core/MemoryResource.h"
+
+#include <string>
+
+
+namespace Silex
+{
+    // 集計したスコープ（ツリーを深さ優先で並べた順に格納する）
+    struct ProfileNode
+    {
+        const char* name           = nullptr;
+        uint64      path           = 0; // 親からのスコープ名の連なりから求めた識別子
+        uint32      depth          = 0;
+        uint32      numDescendants = 0; // 子孫ノード数（直後に続く、このノードのサブツリーの要素数）
+        uint32      numCalls       = 0;
+        float       totalTime      = 0.0f; // ms
+        float       minTime        = 0.0f; // ms
+        float       maxTime        = 0.0f; // ms
+
+        float GetAverageTime() const
+        {
+            return numCalls ? totalTime / numCalls : 0.0f;
+        }
+    };
+
+    // スコープの親子関係を引き継ぐための位置（タスクを追加したスコープを、実行スレッド側の親にする）
+    struct ProfileLink
+    {
+        uint64 path  = 0;
+        uint32 depth = 0;
+    };
+
+
+    //=========================================================================
+    // 計測プロファイラー
+    //-------------------------------------------------------------------------
+    // スコープの開始・終了をナノ秒で記録し、スレッド毎のロックフリーバッファ（SPSC）に積む
+    // メインスレッドが NextFrame でバッファを回収し、スコープの親子関係ごとに
+    // 呼び出し回数・合計・最小・最大時間を集計したツリーを作る
+    //
+    // 別スレッドで実行するタスクは、追加時の GetCurrentScope を ProfileParentScope で
+    // 親に指定すると、追加したスコープの子として集計される
+    //
+    // キャプチャ中は、集計に加えて全スレッドのスコープをそのまま保持し、指定フレーム数の
+    // 記録が終わると Chrome Trace Event 形式（chrome://tracing, Perfetto で表示できる JSON）で書き出す
+    //=========================================================================
+    class Profiler
+    {
+    public:
+
+        static void Initialize();
+        static void Finalize();
+
+        // name はフレームをまたいで参照するので、文字列リテラルを渡すこと
+        static void BeginScope(const char* name);
+        static void EndScope();
+
+        static ProfileLink GetCurrentScope();
+        static void        SetCurrentScope(const ProfileLink& link);
+
+        // 全スレッドの記録を回収して集計する（メインスレッドからフレーム毎に 1回呼び出す）
+        static void NextFrame();
+
+        // 直前のフレームの集計結果
+        static const PoolVector<ProfileNode>& GetFrameNodes();
+
+        // バッファが満杯で記録できなかったスコープの数
+        static uint64 GetDroppedCount();
+
+        // 呼び出しスレッドの名前（キャプチャのトラック名になる。文字列はコピーする）
+        static void SetThreadName(const char* name);
+
+        // 次のフレームから numFrames フレーム分を記録し、filePath に書き出す（メインスレッドのみ）
+        static bool StartCapture(uint32 numFrames, const std::string& filePath);
+        static bool IsCapturing();
+        static uint32 GetCaptureRemainingFrames();
+
+        // キャプチャ中のみ、カウンタートラックに値を記録する（メインスレッドのみ。name は文字列リテラル）
+        static void AddCounter(const char* name, double value);
+    };
+
+
+    // スコープ寿命で計測する
+    class ProfileScope
+    {
+    public:
+
+        ProfileScope(const char* name)
+        {
+            Profiler::BeginScope(name);
+        }
+
+        ~ProfileScope()
+        {
+            Profiler::EndScope();
+        }
+
+    private:
+
+        ProfileScope(const ProfileScope&)            = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+    };
+
+    // スコープ寿命の間、計測する親スコープを差し替える
+    class ProfileParentScope
+    {
+    public:
+
+        ProfileParentScope(const ProfileLink& parent)
+            : previous(Profiler::GetCurrentScope())
+        {
+            Profiler::SetCurrentScope(parent);
+        }
+
+        ~ProfileParentScope()
+        {
+            Profiler::SetCurrentScope(previous);
+        }
+
+    private:
+
+        ProfileLink previous;
+
+    private:
+
+        ProfileParentScope(const ProfileParentScope&)            = delete;
+        ProfileParentScope& operator=(const ProfileParentScope&) = delete;
+    };
+
+
+    // JSON の文字列として出力できるように、引用符とバックスラッシュをエスケープする（スコープ名・スレッド名の書き出し用）
+    std::string EscapeJson(const char* str);
+
+
+#define SL_SCOPE_PROFILE(name) ::Silex::ProfileScope SL_COMBINE(profileScope, __LINE__)(name);
+}
@@ -0,0 +1,416 @@
+
+#include "PCH.h"
+
+#include "Core/TLSFHeap.h"
+#include "Core/OS.h"
+
+#include <bit>
+
+
+namespace Silex
+{
+    namespace Internal
+    {
+        // 最上位ビットのインデックス
+        SL_FORCEINLINE static uint32 FindLastSet(uint64 value)
+        {
+            return (uint32)std::bit_width(value) - 1;
+        }
+
+        // 最下位ビットのインデックス
+        SL_FORCEINLINE static uint32 FindFirstSet(uint32 value)
+        {
+            return (uint32)std::countr_zero(value);
+        }
+
+        SL_FORCEINLINE static uint64 AlignUp(uint64 value, uint64 align)
+        {
+            return (value + (align - 1)) & ~(align - 1);
+        }
+    }
+
+
+    //============================================================================
+    // 初期化・終了
+    //============================================================================
+    void TLSFHeap::Initialize(uint64 reserveByteSize, uint64 largePageByteSize)
+    {
+        reservedSize  = Internal::AlignUp(reserveByteSize, growByteSize);
+        committedSize = 0;
+
+        base = static_cast<byte*>(OS::Get()->ReserveMemory(reservedSize));
+        SL_ASSERT(base != nullptr);
+
+        flBitmap       = 0;
+        slBitmap       = {};
+        freeLists      = {};
+        usedSize       = 0;
+        freeSize       = 0;
+        numAllocations = 0;
+        numFreeBlocks  = 0;
+
+        // 最初のコミット領域に、空きブロックと末尾の番兵ブロックを作る
+        bool committed = OS::Get()->CommitMemory(base, growByteSize);
+        SL_ASSERT(committed);
+
+        committedSize = growByteSize;
+        sentinel      = CreateRegion(base, committedSize);
+
+        // ラージページの領域は予約と同時にコミットされるので、拡張せずに独立した領域として加える
+        uint64 largePageSize = OS::Get()->GetLargePageSize();
+        if (largePageByteSize != 0 && largePageSize != 0)
+        {
+            uint64 size = Internal::AlignUp(largePageByteSize, largePageSize);
+
+            largePageBase = static_cast<byte*>(OS::Get()->AllocateLargePages(size));
+            if (largePageBase)
+            {
+                largePageRegionSize = size;
+                CreateRegion(largePageBase, size);
+            }
+        }
+    }
+
+    void TLSFHeap::Finalize()
+    {
+        if (largePageBase)
+        {
+            OS::Get()->ReleaseMemory(largePageBase, largePageRegionSize);
+        }
+
+        OS::Get()->ReleaseMemory(base, reservedSize);
+
+        largePageBase       = nullptr;
+        largePageRegionSize = 0;
+
+        base          = nullptr;
+        sentinel      = nullptr;
+        reservedSize  = 0;
+        committedSize = 0;
+    }
+
+
+    //============================================================================
+    // サイズ → インデックス変換
+    //============================================================================
+    void TLSFHeap::MappingInsert(uint64 size, uint32* outFL, uint32* outSL)
+    {
+        uint32 fl, sl;
+
+        if (size < smallBlockSize)
+        {
+            // 小さいブロックは第1レベル 0 に線形に配置する
+            fl = 0;
+            sl = (uint32)(size / (smallBlockSize / slIndexCount));
+        }
+        else
+        {
+            fl = Internal::FindLastSet(size);
+            sl = (uint32)(size >> (fl - slIndexCountLog2)) ^ slIndexCount;
+            fl -= flIndexShift - 1;
+        }
+
+        *outFL = fl;
+        *outSL = sl;
+    }
+
+    void TLSFHeap::MappingSearch(uint64 size, uint32* outFL, uint32* outSL)
+    {
+        // 検索時は次の区間に切り上げて、見つかったリストのどのブロックでも要求を満たすようにする
+        if (size >= smallBlockSize)
+        {
+            uint64 round = (1ull << (Internal::FindLastSet(size) - slIndexCountLog2)) - 1;
+            size += round;
+        }
+
+        MappingInsert(size, outFL, outSL);
+    }
+
+
+    //============================================================================
+    // 空きリスト操作
+    //============================================================================
+    TLSFHeap::Block* TLSFHeap::FindFreeBlock(uint64 size)
+    {
+        uint32 fl, sl;
+        MappingSearch(size, &fl, &sl);
+
+        if (fl >= flIndexCount)
+            return nullptr;
+
+        // 同じ第1レベル内で、sl 以上の空きリストを探す
+        uint32 slMap = slBitmap[fl] & (~0u << sl);
+        if (slMap == 0)
+        {
+            // なければ、より大きい第1レベルから探す
+            uint32 flMap = (fl + 1 < 32) ? flBitmap & (~0u << (fl + 1)) : 0;
+            if (flMap == 0)
+                return nullptr;
+
+            fl    = Internal::FindFirstSet(flMap);
+            slMap = slBitmap[fl];
+        }
+
+        sl = Internal::FindFirstSet(slMap);
+        return freeLists[fl][sl];
+    }
+
+    void TLSFHeap::InsertFreeBlock(Block* block)
+    {
+        uint32 fl, sl;
+        MappingInsert(GetSize(block), &fl, &sl);
+
+        Block* head = freeLists[fl][sl];
+        block->nextFree = head;
+        block->prevFree = nullptr;
+
+        if (head)
+            head->prevFree = block;
+
+        freeLists[fl][sl] = block;
+        flBitmap     |= 1u << fl;
+        slBitmap[fl] |= 1u << sl;
+
+        freeSize += GetSize(block);
+        numFreeBlocks++;
+    }
+
+    void TLSFHeap::RemoveFreeBlock(Block* block)
+    {
+        uint32 fl, sl;
+        MappingInsert(GetSize(block), &fl, &sl);
+
+        if (block->prevFree) block->prevFree->nextFree = block->nextFree;
+        else                 freeLists[fl][sl]         = block->nextFree;
+
+        if (block->nextFree)
+            block->nextFree->prevFree = block->prevFree;
+
+        // リストが空になったらビットを落とす
+        if (freeLists[fl][sl] == nullptr)
+        {
+            slBitmap[fl] &= ~(1u << sl);
+
+            if (slBitmap[fl] == 0)
+                flBitmap &= ~(1u << fl);
+        }
+
+        freeSize -= GetSize(block);
+        numFreeBlocks--;
+    }
+
+
+    //============================================================================
+    // ブロック操作
+    //============================================================================
+    TLSFHeap::Block* TLSFHeap::TrimFront(Block* block, uint64 align)
+    {
+        // 前方の余白が空きブロックを作れる大きさになるよう、アライメント位置を決める
+        uint64 pointer = (uint64)ToPointer(block);
+        uint64 aligned = Internal::AlignUp(pointer, align);
+        uint64 gap     = aligned - pointer;
+
+        if (gap == 0)
+            return block;
+
+        while (gap < sizeof(Block))
+        {
+            aligned += align;
+            gap     += align;
+        }
+
+        // 前方の余白を空きブロックとして切り離す
+        uint64 flags = block->size & blockPrevFreeBit;
+        uint64 size  = GetSize(block);
+
+        Block* alignedBlock = ToBlock((void*)aligned);
+        alignedBlock->prevPhysical = block;
+        alignedBlock->size         = (size - gap) | blockPrevFreeBit;
+        GetNext(alignedBlock)->prevPhysical = alignedBlock;
+
+        block->size = (gap - blockHeaderByteSize) | blockFreeBit | flags;
+        InsertFreeBlock(block);
+
+        return alignedBlock;
+    }
+
+    void TLSFHeap::Split(Block* block, uint64 size)
+    {
+        uint64 blockSize = GetSize(block);
+        if (blockSize < size + sizeof(Block))
+            return;
+
+        // 後方の余りを空きブロックとして切り離す
+        block->size = size | (block->size & blockFlagMask);
+
+        Block* remain = GetNext(block);
+        remain->prevPhysical = block;
+        remain->size         = blockSize - size - blockHeaderByteSize;
+        GetNext(remain)->prevPhysical = remain;
+
+        MarkFreeAndMerge(remain);
+    }
+
+    void TLSFHeap::MarkUsed(Block* block)
+    {
+        block->size &= ~blockFreeBit;
+        GetNext(block)->size &= ~blockPrevFreeBit;
+    }
+
+    void TLSFHeap::MarkFreeAndMerge(Block* block)
+    {
+        // 前方の空きブロックと結合
+        if (IsPrevFree(block))
+        {
+            Block* prev = block->prevPhysical;
+            RemoveFreeBlock(prev);
+
+            prev->size += GetSize(block) + blockHeaderByteSize;
+            block = prev;
+        }
+
+        // 後方の空きブロックと結合
+        Block* next = GetNext(block);
+        if (IsFree(next))
+        {
+            RemoveFreeBlock(next);
+
+            block->size += GetSize(next) + blockHeaderByteSize;
+            next = GetNext(block);
+        }
+
+        block->size |= blockFreeBit;
+        next->prevPhysical = block;
+        next->size        |= blockPrevFreeBit;
+
+        InsertFreeBlock(block);
+    }
+
+    TLSFHeap::Block* TLSFHeap::CreateRegion(byte* memory, uint64 size)
+    {
+        // 領域全体を1つの空きブロックにし、末尾に番兵ブロック（サイズ 0, 使用中）を置く
+        Block* first = reinterpret_cast<Block*>(memory);
+        first->prevPhysical = nullptr;
+        first->size         = size - blockHeaderByteSize * 2;
+
+        Block* end = GetNext(first);
+        end->prevPhysical = first;
+        end->size         = 0;
+
+        MarkFreeAndMerge(first);
+        return end;
+    }
+
+    bool TLSFHeap::Grow(uint64 size)
+    {
+        // 検索時の切り上げ分（第2レベルの1区間）を含めて拡張しないと、拡張後の検索で見つからない
+        uint64 requiredSize = size + (size >> slIndexCountLog2) + blockHeaderByteSize * 2;
+        uint64 growSize     = Internal::AlignUp(requiredSize, growByteSize);
+        if (committedSize + growSize > reservedSize)
+            return false;
+
+        if (!OS::Get()->CommitMemory(base + committedSize, growSize))
+            return false;
+
+        committedSize += growSize;
+
+        // 現在の番兵を新しい領域の空きブロックにし、末尾に番兵を作り直す
+        Block* block = sentinel;
+        block->size = (growSize - blockHeaderByteSize) | (block->size & blockPrevFreeBit);
+
+        sentinel = GetNext(block);
+        sentinel->prevPhysical = block;
+        sentinel->size         = 0;
+
+        MarkFreeAndMerge(block);
+        return true;
+    }
+
+
+    //============================================================================
+    // 確保・解放
+    //============================================================================
+    void* TLSFHeap::Allocate(uint64 sizeByte, uint64 align)
+    {
+        SL_ASSERT((align & (align - 1)) == 0, "アライメントは2のべき乗である必要があります");
+
+        uint64 size = std::max(Internal::AlignUp(sizeByte, alignment), minBlockByteSize);
+
+        // 既定より大きいアライメントは、前方に余白ブロックを作れるだけ余分に検索する
+        uint64 searchSize = align > alignment ? size + align + sizeof(Block) : size;
+
+        std::scoped_lock lock(mutex);
+
+        Block* block = FindFreeBlock(searchSize);
+        if (block == nullptr)
+        {
+            if (!Grow(searchSize))
+                return nullptr;
+
+            block = FindFreeBlock(searchSize);
+            if (block == nullptr)
+                return nullptr;
+        }
+
+        RemoveFreeBlock(block);
+
+        if (align > alignment)
+            block = TrimFront(block, align);
+
+        Split(block, size);
+        MarkUsed(block);
+
+        usedSize += GetSize(block);
+        numAllocations++;
+
+        return ToPointer(block);
+    }
+
+    void TLSFHeap::Deallocate(void* pointer)
+    {
+        if (pointer == nullptr)
+            return;
+
+        std::scoped_lock lock(mutex);
+
+        Block* block = ToBlock(pointer);
+        SL_ASSERT(!IsFree(block), "解放済みのブロックを解放しようとしました");
+
+        usedSize -= GetSize(block);
+        numAllocations--;
+
+        MarkFreeAndMerge(block);
+    }
+
+    TLSFHeapStatus TLSFHeap::GetStatus() const
+    {
+        std::scoped_lock lock(mutex);
+
+        TLSFHeapStatus status;
+        status.usedSize       = usedSize;
+        status.freeSize       = freeSize;
+        status.committedSize  = committedSize + largePageRegionSize;
+        status.largePageSize  = largePageRegionSize;
+        status.numAllocations = numAllocations;
+        status.numFreeBlocks  = numFreeBlocks;
+
+        // 最大の空きブロックは、最上位の空きリストを走査して求める
+        if (flBitmap != 0)
+        {
+            uint32 fl = Internal::FindLastSet(flBitmap);
+            uint32 sl = Internal::FindLastSet(slBitmap[fl]);
+
+            for (Block* block = freeLists[fl][sl]; block; block = block->nextFree)
+            {
+                status.largestFreeBlock = std::max(status.largestFreeBlock, GetSize(block));
+            }
+        }
+
+        if (freeSize != 0)
+        {
+            status.fragmentation = 1.0f - (float)status.largestFreeBlock / (float)freeSize;
+        }
+
+        return status;
+    }
+}
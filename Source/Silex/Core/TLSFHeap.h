@@ -0,0 +1,153 @@
+#pragma once
+
+#include "Core/CoreType.h"
+#include <array>
+#include <mutex>
+
+
+namespace Silex
+{
+    struct TLSFHeapStatus
+    {
+        uint64 usedSize         = 0; // 使用中ブロックの合計サイズ
+        uint64 freeSize         = 0; // 空きブロックの合計サイズ
+        uint64 committedSize    = 0; // コミット済みサイズ（ラージページ領域を含む）
+        uint64 largePageSize    = 0; // ラージページ領域のサイズ
+        uint64 largestFreeBlock = 0; // 最大の空きブロックサイズ
+        uint32 numAllocations   = 0;
+        uint32 numFreeBlocks    = 0;
+        float  fragmentation    = 0.0f; // 1 - (最大空きブロック / 空き合計)
+    };
+
+
+    //=========================================================================
+    // TLSF (Two-Level Segregated Fit) ヒープ
+    //-------------------------------------------------------------------------
+    // 空きブロックをサイズの 2のべき乗区間（第1レベル）と、その区間の 32分割（第2レベル）で
+    // 分類し、ビットマップ検索で O(1) の確保・解放を行う
+    // 予約した仮想アドレス空間の末尾から、必要に応じてコミットして拡張する
+    // ラージページが使用できる場合は、別途ラージページの領域を確保して空きブロックに加える
+    //
+    // http://www.gii.upv.es/tlsf/
+    //=========================================================================
+    class TLSFHeap
+    {
+    public:
+
+        static constexpr uint64 alignment = 16;
+
+    public:
+
+        TLSFHeap()  = default;
+        ~TLSFHeap() = default;
+
+        void Initialize(uint64 reserveByteSize, uint64 largePageByteSize = 0);
+        void Finalize();
+
+        void* Allocate(uint64 sizeByte, uint64 align = alignment);
+        void  Deallocate(void* pointer);
+
+        bool Contains(const void* pointer) const
+        {
+            return (base          <= (const byte*)pointer && (const byte*)pointer < base          + reservedSize) ||
+                   (largePageBase <= (const byte*)pointer && (const byte*)pointer < largePageBase + largePageRegionSize);
+        }
+
+        TLSFHeapStatus GetStatus() const;
+
+    private:
+
+        //=====================================================
+        // ブロックヘッダー
+        //-----------------------------------------------------
+        // prevPhysical と size が常に存在するヘッダー（16 byte）
+        // nextFree / prevFree は空きブロックの場合のみ、ユーザー領域に格納される
+        // size の下位ビットは状態フラグとして使用する（サイズは 16 byte 単位）
+        //=====================================================
+        struct Block
+        {
+            Block* prevPhysical;
+            uint64 size;
+            Block* nextFree;
+            Block* prevFree;
+        };
+
+        static constexpr uint64 blockHeaderByteSize = 16;
+        static constexpr uint64 minBlockByteSize    = sizeof(Block) - blockHeaderByteSize;
+
+        static constexpr uint64 blockFreeBit     = 1 << 0;
+        static constexpr uint64 blockPrevFreeBit = 1 << 1;
+        static constexpr uint64 blockFlagMask    = blockFreeBit | blockPrevFreeBit;
+
+        // 第2レベルの分割数 (2^5 = 32)
+        static constexpr uint32 slIndexCountLog2 = 5;
+        static constexpr uint32 slIndexCount     = 1 << slIndexCountLog2;
+
+        // 第1レベル: 512 byte 未満は1区間にまとめ、最大 4GB まで
+        static constexpr uint32 flIndexShift   = slIndexCountLog2 + 4;
+        static constexpr uint32 flIndexMax     = 32;
+        static constexpr uint32 flIndexCount   = flIndexMax - flIndexShift + 1;
+        static constexpr uint64 smallBlockSize = 1ull << flIndexShift;
+
+        // 拡張時のコミット単位
+        static constexpr uint64 growByteSize = 4 * 1024 * 1024;
+
+    private:
+
+        static uint64 GetSize(const Block* block)   { return block->size & ~blockFlagMask; }
+        static bool   IsFree(const Block* block)     { return block->size & blockFreeBit;    }
+        static bool   IsPrevFree(const Block* block) { return block->size & blockPrevFreeBit; }
+
+        static void*  ToPointer(Block* block) { return (byte*)block + blockHeaderByteSize; }
+        static Block* ToBlock(void* pointer)  { return (Block*)((byte*)pointer - blockHeaderByteSize); }
+        static Block* GetNext(Block* block)   { return (Block*)((byte*)ToPointer(block) + GetSize(block)); }
+
+        static void MappingInsert(uint64 size, uint32* outFL, uint32* outSL);
+        static void MappingSearch(uint64 size, uint32* outFL, uint32* outSL);
+
+        Block* FindFreeBlock(uint64 size);
+        void   InsertFreeBlock(Block* block);
+        void   RemoveFreeBlock(Block* block);
+
+        Block* TrimFront(Block* block, uint64 align);
+        void   Split(Block* block, uint64 size);
+        void   MarkUsed(Block* block);
+        void   MarkFreeAndMerge(Block* block);
+
+        Block* CreateRegion(byte* memory, uint64 size);
+        bool   Grow(uint64 size);
+
+    private:
+
+        byte*  base          = nullptr;
+        uint64 reservedSize  = 0;
+        uint64 committedSize = 0;
+
+        // ラージページ領域（拡張はしない）
+        byte*  largePageBase       = nullptr;
+        uint64 largePageRegionSize = 0;
+
+        // 末尾の番兵ブロック（サイズ 0, 使用中）
+        Block* sentinel = nullptr;
+
+        // 空きリストのビットマップ（第1レベル / 第2レベル）と空きリスト
+        uint32                                                     flBitmap  = 0;
+        std::array<uint32, flIndexCount>                           slBitmap  = {};
+        std::array<std::array<Block*, slIndexCount>, flIndexCount> freeLists = {};
+
+        // 統計
+        uint64 usedSize       = 0;
+        uint64 freeSize       = 0;
+        uint32 numAllocations = 0;
+        uint32 numFreeBlocks  = 0;
+
+        mutable std::mutex mutex;
+
+    private:
+
+        TLSFHeap(TLSFHeap&)             = delete;
+        TLSFHeap(TLSFHeap&&)            = delete;
+        TLSFHeap& operator=(TLSFHeap&)  = delete;
+        TLSFHeap& operator=(TLSFHeap&&) = delete;
+    };
+}
@@ -0,0 +1,118 @@
+
+#include "PCH.h"
+
+#include "Core/TaskQueue.h"
+
+
+namespace Silex
+{
+    void TaskQueue::Init()
+    {
+        AllocateChunk(0);
+    }
+
+    void TaskQueue::Release()
+    {
+        Chunk* chunk = head;
+        while (chunk)
+        {
+            Chunk* next = chunk->next;
+            Memory::DeallocateBytes(chunk);
+            chunk = next;
+        }
+
+        head     = nullptr;
+        current  = nullptr;
+        cursor   = nullptr;
+        chunkEnd = nullptr;
+        stats    = {};
+    }
+
+    void TaskQueue::Execute()
+    {
+        if (current)
+        {
+            current->end = cursor;
+        }
+
+        // 統計は記録時ではなく実行時に集計する（Enqueue の処理を最小限にするため）
+        uint32 numCommands   = 0;
+        uint64 usedSize      = 0;
+        uint32 numChunks     = 0;
+        uint64 committedSize = 0;
+
+        for (Chunk* chunk = head; chunk; chunk = chunk->next)
+        {
+            byte* ptr = chunk->GetData();
+            while (ptr < chunk->end)
+            {
+                Command* command = reinterpret_cast<Command*>(ptr);
+                ptr += command->size;
+
+                command->execute(command);
+                numCommands++;
+            }
+
+            usedSize      += chunk->end - chunk->GetData();
+            committedSize += chunk->capacity - reinterpret_cast<byte*>(chunk);
+            numChunks++;
+        }
+
+        stats.numCommands   = numCommands;
+        stats.usedSize      = usedSize;
+        stats.peakUsedSize  = std::max(stats.peakUsedSize, usedSize);
+        stats.numChunks     = numChunks;
+        stats.committedSize = committedSize;
+
+        ResetCursor();
+    }
+
+    void TaskQueue::AllocateChunk(uint64 requiredSize)
+    {
+        if (current)
+        {
+            current->end = cursor;
+        }
+
+        // 次のチャンクが再利用できればそれを使う
+        Chunk* next = current ? current->next : head;
+        if (next == nullptr || uint64(next->capacity - next->GetData()) < requiredSize)
+        {
+            uint64 dataSize = std::max(chunkByteSize - sizeof(Chunk), requiredSize);
+            Chunk* chunk    = static_cast<Chunk*>(Memory::AllocateCacheAlignedBytes(sizeof(Chunk) + dataSize));
+
+            chunk->end      = chunk->GetData();
+            chunk->capacity = chunk->GetData() + dataSize;
+
+            // 容量が足りない次のチャンクは、後ろにずらして残す
+            chunk->next = next;
+
+            if (current)
+            {
+                current->next = chunk;
+            }
+            else
+            {
+                head = chunk;
+            }
+
+            next = chunk;
+        }
+
+        current  = next;
+        cursor   = current->GetData();
+        chunkEnd = current->capacity;
+    }
+
+    void TaskQueue::ResetCursor()
+    {
+        for (Chunk* chunk = head; chunk; chunk = chunk->next)
+        {
+            chunk->end = chunk->GetData();
+        }
+
+        current  = head;
+        cursor   = head ? head->GetData() : nullptr;
+        chunkEnd = head ? head->capacity  : nullptr;
+    }
+}
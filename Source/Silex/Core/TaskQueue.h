@@ -1,4 +1,3 @@
-
 #pragma once
 #include "Core/Memory.h"
 
@@ -7,6 +6,10 @@
 // デリゲートクラスではバッファが固定サイズで、ラムダ式のキャプチャが多くなった際に
 // サイズが足りなくなるため、可変長サイズな関数オブジェクトを受け取って実行する
 // キュークラス
+//------------------------------------------------------------------
+// コマンドは [ヘッダー | パディング | 関数オブジェクト] の形でチャンクに詰めて記録する
+// チャンクが足りなくなれば追加し、追加したチャンクは次のフレーム以降も再利用する
+// 呼び出しは仮想関数ではなく、ヘッダーに記録した関数ポインタ 1つで行う
 //==================================================================
 namespace Silex
 {
@@ -18,30 +21,26 @@ namespace Silex
     };
 
 
-    class TaskQueue
+    // 直前に実行したフレームの統計
+    struct TaskQueueStats
     {
-    public:
+        uint32 numCommands   = 0; // コマンド数
+        uint64 usedSize      = 0; // 記録に使用したバイト数（ヘッダー・パディングを含む）
+        uint64 peakUsedSize  = 0; // usedSize の最大値
+        uint32 numChunks     = 0; // 確保済みのチャンク数
+        uint64 committedSize = 0; // 確保済みのチャンクの合計サイズ
+    };
 
-        void Init()
-        {
-            constexpr uint64 AllocationSize = uint64(10 * 1024 * 1024);
 
-            buffer         = (byte*)Memory::Malloc(AllocationSize);
-            insertLocation = buffer;
+    class TaskQueue
+    {
+    public:
 
-            std::memset(buffer, 0, AllocationSize);
-        }
+        // 通常のチャンクサイズ（これより大きなコマンドは専用のチャンクに記録する）
+        static constexpr uint64 chunkByteSize = 256 * 1024;
 
-        void Release()
-        {
-            if (buffer)
-            {
-                Memory::Free(buffer);
-
-                buffer         = nullptr;
-                insertLocation = nullptr;
-            }
-        }
+        void Init();
+        void Release();
 
         //****************************************
         // 右辺値参照のみ受け取る
@@ -51,13 +50,26 @@ namespace Silex
         // Enqueue("rambda",           f ); // ✕
         // Enqueue("rambda",       [](){}); // 〇
 
-        template<typename Func>
+        template<Callable Func>
         void Enqueue(const char* taskName, Func&& fn)
         {
-            Memory::Construct<Task<Func>>(insertLocation, taskName, fn);
+            // 記録位置は常にヘッダーのアライメントに揃っているので、それ以下のアライメントは調整不要
+            static constexpr uint64 padding = alignof(Func) > alignof(Command) ? alignof(Func) - 1 : 0;
+            static constexpr uint64 size    = AlignUp(sizeof(Command) + padding + sizeof(Func), alignof(Command));
+
+            if (uint64(chunkEnd - cursor) < size) [[unlikely]]
+            {
+                AllocateChunk(size);
+            }
 
-            insertLocation += sizeof(Task<Func>);
-            taskCount++;
+            Command* command = reinterpret_cast<Command*>(cursor);
+            cursor += size;
+
+            command->execute = &ExecuteCommand<Func>;
+            command->name    = taskName;
+            command->size    = size;
+
+            Memory::Construct<Func>(GetFunctor<Func>(command), Traits::Move(fn));
         }
 
         template<typename Func>
@@ -66,62 +78,77 @@ namespace Silex
             static_assert(sizeof(Func) == 0, "コピーを避けるために、右辺値が渡されることを期待します");
         }
 
-        void Execute()
-        {
-            byte* ptr = buffer;
+        // 記録したコマンドを順に実行し、キューを空にする
+        void Execute();
 
-            for (uint32 i = 0; i < taskCount; i++)
-            {
-                ITask* task = reinterpret_cast<ITask*>(ptr);
-                task->Execute();
-                ptr += task->GetSize();
-
-                Memory::Destruct(task);
-            }
-
-            insertLocation = buffer;
-            taskCount      = 0;
-        }
+        const TaskQueueStats& GetStats() const { return stats; }
 
     private:
 
         //===========================================
-        // 基底タスククラス
+        // コマンドヘッダー
         //-------------------------------------------
-        // 動的にテンプレートを判別する方法がないので、
-        // 型消去で共通のインターフェース呼び出しを行う
+        // 関数オブジェクトの型は Enqueue でしか分からないので、
+        // 型毎に生成した関数で呼び出し・破棄を行う
         //===========================================
-        struct ITask
+        struct Command
         {
-            virtual ~ITask() {}
+            using ExecuteFunction = void(*)(Command* command);
 
-            virtual void        Execute() const = 0;
-            virtual uint32      GetSize() const = 0;
-            virtual const char* GetName() const = 0;
+            ExecuteFunction execute;
+            const char*     name;
+            uint32          size;    // 次のコマンドまでのバイト数
         };
 
-        template <Callable Functor>
-        struct Task : ITask
+        struct Chunk
         {
-            Functor     func;
-            uint32      size;
-            const char* name;
-
-            Task(const char* name, Functor fn)
-                : func(Traits::Forward<Functor>(fn))
-                , size(sizeof(Task))
-                , name(name)
-            {}
-
-            void        Execute() const override { std::invoke(func); }
-            uint32      GetSize() const override { return size; }
-            const char* GetName() const override { return name; }
+            Chunk* next;
+            byte*  end;     // 記録済みの終端（実行時に使用）
+            byte*  capacity;
+
+            byte* GetData() { return reinterpret_cast<byte*>(this + 1); }
         };
 
+        static_assert(sizeof(Chunk) % alignof(Command) == 0);
+
+        static constexpr uint64 AlignUp(uint64 value, uint64 alignment)
+        {
+            return (value + (alignment - 1)) & ~(alignment - 1);
+        }
+
+        template<typename Func>
+        SL_FORCEINLINE static Func* GetFunctor(Command* command)
+        {
+            uint64 address = reinterpret_cast<uint64>(command) + sizeof(Command);
+
+            if constexpr (alignof(Func) > alignof(Command))
+            {
+                address = AlignUp(address, alignof(Func));
+            }
+
+            return reinterpret_cast<Func*>(address);
+        }
+
+        // 呼び出し後に関数オブジェクトを破棄する
+        template<typename Func>
+        static void ExecuteCommand(Command* command)
+        {
+            Func* func = GetFunctor<Func>(command);
+            std::invoke(*func);
+            Memory::Destruct(func);
+        }
+
+        // 次のチャンクに切り替える（requiredSize 以上の空きを保証する）
+        void AllocateChunk(uint64 requiredSize);
+        void ResetCursor();
+
     private:
 
-        byte*  buffer         = nullptr;
-        byte*  insertLocation = nullptr;
-        uint32 taskCount      = 0;
+        Chunk* head     = nullptr;
+        Chunk* current  = nullptr;
+        byte*  cursor   = nullptr;
+        byte*  chunkEnd = nullptr;
+
+        TaskQueueStats stats;
     };
 }
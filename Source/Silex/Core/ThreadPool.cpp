@@ -1,56 +1,502 @@
 
 #include "PCH.h"
 #include "ThreadPool.h"
+#include "Core/LockFreeQueue.h"
+#include "Core/Profiler.h"
+#include "Core/Metrics.h"
+
+#include <condition_variable>
+#include <mutex>
 
 
 namespace Silex
 {
-    static uint32                   threadCount        = 0;
-    static std::atomic<uint32>      workingThreadCount = 0;
-    static std::mutex               taskMutex;
-    static std::condition_variable  condition;
-    static std::vector<std::thread> threads;
-    static std::deque<Task>         taskQueue;
-    static bool                     isStopping;
+    //============================================================================
+    // ワーカー毎のタスク両端キュー（Chase-Lev）
+    //----------------------------------------------------------------------------
+    // 所有ワーカーのみが末尾（bottom）から追加・取り出しを行い、他のスレッドは先頭（top）から盗む
+    // 容量が足りなくなれば倍の配列に移し替える。古い配列は盗み中のスレッドが参照している
+    // 可能性があるので、Finalize まで解放しない
+    //============================================================================
+    class TaskDeque
+    {
+    public:
+
+        static constexpr int64 initialCapacity = 1024;
+
+        void Initialize()
+        {
+            Array* array = CreateArray(initialCapacity);
+            buffer.store(array, std::memory_order_relaxed);
+
+            top.store(0, std::memory_order_relaxed);
+            bottom.store(0, std::memory_order_relaxed);
+        }
+
+        void Finalize()
+        {
+            Array* array = buffer.load(std::memory_order_relaxed);
+            while (array)
+            {
+                Array* previous = array->previous;
+                Memory::Free(array);
+                array = previous;
+            }
+
+            buffer.store(nullptr, std::memory_order_relaxed);
+        }
 
-    thread_local uint32        threadID        = 0;
-    static std::atomic<uint32> threadIDCounter = 0;
+        // 所有ワーカーのみ
+        void Push(TaskSlot* task)
+        {
+            int64  b     = bottom.load(std::memory_order_relaxed);
+            int64  t     = top.load(std::memory_order_acquire);
+            Array* array = buffer.load(std::memory_order_relaxed);
 
-    //--------------------------------------------------------------------------------
-    // std::condition_variable::wait()
-    //--------------------------------------------------------------------------------
-    // 条件が指定されているなら、満たされるまで(whileでビジーループ & 待機)
-    // そうでないならなら、notify_one() / notify_all() が呼び出されるまで 待機する
-    //--------------------------------------------------------------------------------
+            if (b - t > array->capacity - 1)
+            {
+                array = Grow(array, t, b);
+            }
 
-    static void ThreadLoop()
+            array->Put(b, task);
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+
+        // 所有ワーカーのみ（後に積んだものから取り出す）
+        TaskSlot* Pop()
+        {
+            int64  b     = bottom.load(std::memory_order_relaxed) - 1;
+            Array* array = buffer.load(std::memory_order_relaxed);
+
+            bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            int64 t = top.load(std::memory_order_relaxed);
+            if (t > b)
+            {
+                // 空
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            TaskSlot* task = array->Get(b);
+            if (t == b)
+            {
+                // 最後の 1つは盗むスレッドと競合するので、先頭を進められた方が取る
+                if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                {
+                    task = nullptr;
+                }
+
+                bottom.store(b + 1, std::memory_order_relaxed);
+            }
+
+            return task;
+        }
+
+        // 他のスレッドから（先に積んだものから取り出す）
+        TaskSlot* Steal()
+        {
+            int64 t = top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64 b = bottom.load(std::memory_order_acquire);
+
+            if (t >= b)
+                return nullptr;
+
+            Array* array = buffer.load(std::memory_order_acquire);
+            TaskSlot*  task  = array->Get(t);
+
+            // 他のスレッドに先に取られた場合は失敗
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return nullptr;
+
+            return task;
+        }
+
+    private:
+
+        struct Array
+        {
+            int64  capacity;
+            Array* previous;
+
+            std::atomic<TaskSlot*>* Slots()
+            {
+                return reinterpret_cast<std::atomic<TaskSlot*>*>(this + 1);
+            }
+
+            TaskSlot* Get(int64 index)
+            {
+                return Slots()[index & (capacity - 1)].load(std::memory_order_relaxed);
+            }
+
+            void Put(int64 index, TaskSlot* task)
+            {
+                Slots()[index & (capacity - 1)].store(task, std::memory_order_relaxed);
+            }
+        };
+
+        static Array* CreateArray(int64 capacity)
+        {
+            Array* array = static_cast<Array*>(Memory::Malloc(sizeof(Array) + sizeof(std::atomic<TaskSlot*>) * capacity));
+            array->capacity = capacity;
+            array->previous = nullptr;
+
+            return array;
+        }
+
+        Array* Grow(Array* array, int64 t, int64 b)
+        {
+            Array* newArray = CreateArray(array->capacity * 2);
+            for (int64 i = t; i < b; i++)
+            {
+                newArray->Put(i, array->Get(i));
+            }
+
+            newArray->previous = array;
+            buffer.store(newArray, std::memory_order_release);
+
+            return newArray;
+        }
+
+    private:
+
+        SL_CACHE_ALIGN std::atomic<int64> top    = 0;
+        SL_CACHE_ALIGN std::atomic<int64> bottom = 0;
+        std::atomic<Array*>               buffer = nullptr;
+    };
+
+
+    //============================================================================
+    // 共有タスクキュー（有界 MPMC）
+    //----------------------------------------------------------------------------
+    // ワーカー外から追加されたタスクを受け付ける。Initialize 前から使用できるよう静的に初期化する
+    //============================================================================
+    using InjectionQueue = MPMCQueue<TaskSlot*, 16384>;
+
+
+    //============================================================================
+    // タスクスロットのプール
+    //----------------------------------------------------------------------------
+    // スレッド毎に空きスロットのリストを持ち、溜まりすぎた分・不足した分はバッチ単位で共有の
+    // デポとやり取りする（タスクを追加するスレッドと実行するスレッドが異なっても偏らないように）
+    // Initialize 前にも使用されるので、スラブは malloc から確保し、プロセス終了まで保持する
+    //============================================================================
+    class TaskSlotPool
     {
-        threadID = threadIDCounter++;
+    public:
 
-        while (true)
+        static constexpr uint32 batchSize    = 32;
+        static constexpr uint32 slotsPerSlab = 256;
+
+        static TaskSlotPool& Get()
+        {
+            return instance;
+        }
+
+        ~TaskSlotPool()
+        {
+            Slab* slab = slabList;
+            while (slab)
+            {
+                Slab* next = slab->next;
+                Memory::Free(slab->memory);
+                slab = next;
+            }
+        }
+
+        TaskSlot* Allocate()
+        {
+            ThreadCache& cache = threadCache;
+            if (cache.head == nullptr)
+            {
+                cache.head  = PopBatch();
+                cache.count = GetFree(cache.head)->batchCount;
+            }
+
+            TaskSlot* slot = cache.head;
+            cache.head = GetFree(slot)->next;
+            cache.count--;
+
+            return slot;
+        }
+
+        void Deallocate(TaskSlot* slot)
         {
-            Task task;
+            ThreadCache& cache = threadCache;
 
+            GetFree(slot)->next = cache.head;
+            cache.head = slot;
+            cache.count++;
+
+            // 溜まりすぎた分は 1バッチ分をデポに返す
+            if (cache.count >= batchSize * 2)
             {
-                std::unique_lock<std::mutex> lock(taskMutex);
+                TaskSlot* batch = cache.head;
+                TaskSlot* last  = batch;
+                for (uint32 i = 1; i < batchSize; i++)
+                {
+                    last = GetFree(last)->next;
+                }
+
+                cache.head   = GetFree(last)->next;
+                cache.count -= batchSize;
+
+                GetFree(last)->next = nullptr;
+                PushBatch(batch, batchSize);
+            }
+        }
 
-                // タスクが空の場合は wait する
-                while (!isStopping && taskQueue.empty())
+    private:
+
+        // 空きスロットの管理データ（関数オブジェクトの格納領域に書き込む）
+        struct FreeSlot
+        {
+            TaskSlot* next;
+            TaskSlot* nextBatch;  // バッチ先頭のみ
+            uint32    batchCount; // バッチ先頭のみ
+        };
+
+        struct Slab
+        {
+            void* memory;
+            Slab* next;
+        };
+
+        struct ThreadCache
+        {
+            // スレッド終了時は、残っているスロットをデポに返す
+            ~ThreadCache()
+            {
+                if (head)
                 {
-                    condition.wait(lock);
+                    instance.PushBatch(head, count);
                 }
+            }
 
-                if (isStopping && taskQueue.empty())
-                    return;
+            TaskSlot* head  = nullptr;
+            uint32    count = 0;
+        };
 
-                task = taskQueue.front();
-                taskQueue.pop_front();
+        static FreeSlot* GetFree(TaskSlot* slot)
+        {
+            return reinterpret_cast<FreeSlot*>(slot->storage);
+        }
+
+        TaskSlot* PopBatch()
+        {
+            std::scoped_lock lock(depotMutex);
+
+            if (depot == nullptr)
+            {
+                CreateSlab();
             }
 
-            // タスク実行
-            workingThreadCount++;
-            task();
-            workingThreadCount--;
+            TaskSlot* batch = depot;
+            depot = GetFree(batch)->nextBatch;
+
+            return batch;
+        }
+
+        void PushBatch(TaskSlot* batch, uint32 count)
+        {
+            std::scoped_lock lock(depotMutex);
+
+            GetFree(batch)->nextBatch  = depot;
+            GetFree(batch)->batchCount = count;
+            depot = batch;
+        }
+
+        // depotMutex をロックした状態で呼び出す
+        void CreateSlab()
+        {
+            // 先頭のスロットをスラブの管理データに使い、残りをバッチに分けてデポに積む
+            void*     memory = Memory::Malloc(sizeof(TaskSlot) * (slotsPerSlab + 1) + SL_CACHE_LINE_SIZE);
+            TaskSlot* slots  = reinterpret_cast<TaskSlot*>(((uint64)memory + SL_CACHE_LINE_SIZE - 1) & ~(uint64)(SL_CACHE_LINE_SIZE - 1));
+
+            Slab* slab   = reinterpret_cast<Slab*>(&slots[0]);
+            slab->memory = memory;
+            slab->next   = slabList;
+            slabList     = slab;
+
+            for (uint32 batch = 0; batch < slotsPerSlab / batchSize; batch++)
+            {
+                TaskSlot* first = &slots[1 + batch * batchSize];
+                for (uint32 i = 0; i < batchSize; i++)
+                {
+                    GetFree(&first[i])->next = i + 1 < batchSize ? &first[i + 1] : nullptr;
+                }
+
+                GetFree(first)->nextBatch  = depot;
+                GetFree(first)->batchCount = batchSize;
+                depot = first;
+            }
+        }
+
+    private:
+
+        static TaskSlotPool             instance;
+        static thread_local ThreadCache threadCache;
+
+        std::mutex depotMutex;
+        TaskSlot*  depot    = nullptr;
+        Slab*      slabList = nullptr;
+    };
+
+    TaskSlotPool                           TaskSlotPool::instance;
+    thread_local TaskSlotPool::ThreadCache TaskSlotPool::threadCache;
+
+
+    //============================================================================
+    // 状態
+    //============================================================================
+    struct SL_CACHE_ALIGN Worker
+    {
+        TaskDeque   deque;
+        std::thread thread;
+    };
+
+    static uint32              threadCount        = 0;
+    static std::atomic<uint32> workingThreadCount = 0;
+    static Worker*             workers            = nullptr;
+    static InjectionQueue      injectionQueue;
+
+    // キューに積まれているタスク数（起床判定用）と、追加されてから完了していないタスク数
+    static std::atomic<int64> queuedTaskCount  = 0;
+    static std::atomic<int64> pendingTaskCount = 0;
+
+    // タスクが無い間の待機
+    static std::mutex              sleepMutex;
+    static std::condition_variable condition;
+    static std::atomic<uint32>     sleepingThreadCount = 0;
+    static std::atomic<bool>       isStopping          = false;
+
+    static MetricID taskExecutedMetric = Metrics::invalidMetric;
+
+    static constexpr uint32    invalidThreadID = ~0u;
+    static thread_local uint32 threadID        = invalidThreadID;
+    static thread_local uint32 randomState     = 0;
+
+
+    //============================================================================
+    // タスクの確保・実行
+    //============================================================================
+
+    TaskSlot* ThreadPool::AllocateTaskSlot()
+    {
+        return TaskSlotPool::Get().Allocate();
+    }
+
+    static void ExecuteTask(TaskSlot* task)
+    {
+        queuedTaskCount.fetch_sub(1, std::memory_order_relaxed);
+
+        workingThreadCount++;
+        task->execute(task->storage);
+        workingThreadCount--;
+
+        Metrics::Increment(taskExecutedMetric);
+
+        TaskCounter* counter = task->counter;
+        TaskSlotPool::Get().Deallocate(task);
+
+        // カウンターは待機側のスタック上にあることが多いので、減算後は触れない
+        if (counter)
+        {
+            counter->Done();
+        }
+
+        pendingTaskCount.fetch_sub(1, std::memory_order_release);
+    }
+
+    static void WakeWorker()
+    {
+        // 待機直前のワーカーを取りこぼさないよう、ロックを経由して通知する
+        if (sleepingThreadCount.load(std::memory_order_seq_cst) > 0)
+        {
+            { std::scoped_lock lock(sleepMutex); }
+            condition.notify_one();
+        }
+    }
+
+    static uint32 NextRandom()
+    {
+        // xorshift32
+        uint32 x = randomState;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        randomState = x;
+
+        return x;
+    }
+
+    // 共有キュー → 他のワーカーのキュー（ランダムに選んだ位置から一巡）の順に探す
+    static TaskSlot* FindTask(uint32 selfID)
+    {
+        TaskSlot* injected;
+        if (injectionQueue.Pop(injected))
+            return injected;
+
+        if (threadCount == 0)
+            return nullptr;
+
+        uint32 start = NextRandom() % threadCount;
+        for (uint32 i = 0; i < threadCount; i++)
+        {
+            uint32 victim = (start + i) % threadCount;
+            if (victim == selfID)
+                continue;
+
+            if (TaskSlot* task = workers[victim].deque.Steal())
+                return task;
+        }
+
+        return nullptr;
+    }
+
+
+    //============================================================================
+    // ワーカー
+    //============================================================================
+    static void ThreadLoop(uint32 id)
+    {
+        threadID    = id;
+        randomState = id * 0x9E3779B9u + 1;
+
+        Profiler::SetThreadName(std::format("Worker {}", id).c_str());
+
+        TaskDeque& deque = workers[id].deque;
+
+        while (true)
+        {
+            TaskSlot* task = deque.Pop();
+            if (task == nullptr)
+            {
+                task = FindTask(id);
+            }
+
+            if (task)
+            {
+                ExecuteTask(task);
+                continue;
+            }
+
+            // 実行できるタスクが無ければ、追加されるまで待機する
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepingThreadCount.fetch_add(1, std::memory_order_seq_cst);
+
+            while (!isStopping.load(std::memory_order_relaxed) && queuedTaskCount.load(std::memory_order_seq_cst) <= 0)
+            {
+                condition.wait(lock);
+            }
+
+            sleepingThreadCount.fetch_sub(1, std::memory_order_relaxed);
+
+            if (isStopping.load(std::memory_order_relaxed) && queuedTaskCount.load(std::memory_order_seq_cst) <= 0)
+                return;
         }
     }
 
@@ -61,12 +507,22 @@ namespace Silex
         //---------------------------
 
         isStopping  = false;
-        threadCount = std::thread::hardware_concurrency() - 1;
+        threadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
 
-        // スレッドループを予約
+        taskExecutedMetric = Metrics::RegisterCounter("ThreadPool/TasksExecuted");
+        Metrics::RegisterGauge("ThreadPool/WorkingThreads", []() { return (int64)ThreadPool::GetWorkingThreadCount(); });
+
+        workers = static_cast<Worker*>(Memory::AllocateCacheAlignedBytes(sizeof(Worker) * threadCount));
         for (uint32 i = 0; i < threadCount; i++)
         {
-            threads.emplace_back(std::thread(&Silex::ThreadLoop));
+            Memory::Construct<Worker>(&workers[i]);
+            workers[i].deque.Initialize();
+        }
+
+        // スレッドループを予約（全ワーカーのキューを作成してから起動する）
+        for (uint32 i = 0; i < threadCount; i++)
+        {
+            workers[i].thread = std::thread(&Silex::ThreadLoop, i);
         }
     }
 
@@ -78,11 +534,10 @@ namespace Silex
 
         // 実行中のタスクを完了させる
         WaitAll();
-        taskQueue.clear();
 
         {
             // 終了フラグを立てる
-            std::unique_lock<std::mutex> lock(taskMutex);
+            std::unique_lock<std::mutex> lock(sleepMutex);
             isStopping = true;
         }
 
@@ -90,26 +545,76 @@ namespace Silex
         condition.notify_all();
 
         // 全スレッドが終了するまで待機
-        for (auto& thread : threads)
-            thread.join();
+        for (uint32 i = 0; i < threadCount; i++)
+        {
+            workers[i].thread.join();
+        }
+
+        for (uint32 i = 0; i < threadCount; i++)
+        {
+            workers[i].deque.Finalize();
+            Memory::Destruct(&workers[i]);
+        }
 
-        threads.clear();
+        Memory::DeallocateBytes(workers);
+        workers     = nullptr;
+        threadCount = 0;
     }
 
-    void ThreadPool::AddTask(Task&& task)
+    void ThreadPool::SubmitTask(TaskSlot* newTask, TaskCounter* counter)
     {
-        //---------------------------
-        // SL_ASSERT(IsMainThread());
-        //---------------------------
+        newTask->counter = counter;
+
+        if (counter)
+        {
+            counter->Add(1);
+        }
+
+        pendingTaskCount.fetch_add(1, std::memory_order_relaxed);
+        queuedTaskCount.fetch_add(1, std::memory_order_seq_cst);
+
+        if (threadID != invalidThreadID)
+        {
+            // ワーカー内からの追加は自身のキューへ（他のワーカーが盗めるように起床させる）
+            workers[threadID].deque.Push(newTask);
+        }
+        else
+        {
+            // 共有キューが満杯なら、空きができるまで呼び出し元でも消化する
+            while (!injectionQueue.Push(newTask))
+            {
+                WakeWorker();
+
+                TaskSlot* queued;
+                if (injectionQueue.Pop(queued))
+                {
+                    ExecuteTask(queued);
+                }
+            }
+        }
+
+        WakeWorker();
+    }
 
+    // 残っているタスクを 1つ実行する（ワーカー内から呼んだ場合は自身のキューを優先する）
+    bool ThreadPool::RunPendingTask()
+    {
+        TaskSlot* task = nullptr;
+        if (threadID != invalidThreadID)
         {
-            // キューにタスクを追加
-            std::unique_lock<std::mutex> lock(taskMutex);
-            taskQueue.emplace_back(std::bind(std::forward<Task>(task)));
+            task = workers[threadID].deque.Pop();
         }
 
-        // 待機中のスレッドを1つだけ起動させる
-        condition.notify_one();
+        if (task == nullptr)
+        {
+            task = FindTask(threadID);
+        }
+
+        if (task == nullptr)
+            return false;
+
+        ExecuteTask(task);
+        return true;
     }
 
     void ThreadPool::WaitAll()
@@ -117,9 +622,26 @@ namespace Silex
         //---------------------------
         // SL_ASSERT(IsMainThread());
         //---------------------------
-        while (HasRunningTask())
+
+        // 待機中も残っているタスクを消化する
+        while (pendingTaskCount.load(std::memory_order_acquire) > 0)
+        {
+            if (!RunPendingTask())
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void ThreadPool::Wait(const TaskCounter& counter)
+    {
+        // 待機中も眠らずにタスクを消化する（対象外のタスクも実行するので、長時間かかるタスクとは混ぜないこと）
+        while (!counter.IsDone())
         {
-            OS::Get()->Sleep(16);
+            if (!RunPendingTask())
+            {
+                std::this_thread::yield();
+            }
         }
     }
 
@@ -127,22 +649,32 @@ namespace Silex
 
 
     uint32 ThreadPool::GetThreadCount()
-    { 
+    {
         return threadCount;
     }
 
     uint32 ThreadPool::GetWorkingThreadCount()
-    { 
+    {
         return workingThreadCount;
     }
 
     uint32 ThreadPool::GetIdleThreadCount()
-    { 
-        return threadCount - workingThreadCount;
+    {
+        return threadCount - std::min(threadCount, workingThreadCount.load());
+    }
+
+    uint32 ThreadPool::GetPendingTaskCount()
+    {
+        return (uint32)std::max<int64>(pendingTaskCount.load(std::memory_order_relaxed), 0);
     }
 
     bool ThreadPool::HasRunningTask()
-    { 
-        return GetIdleThreadCount() != GetThreadCount();
+    {
+        return GetPendingTaskCount() != 0;
+    }
+
+    bool ThreadPool::IsWorkerThread()
+    {
+        return threadID != invalidThreadID;
     }
 }
@@ -1,13 +1,88 @@
-
 #pragma once
 #include "Core/CoreType.h"
+#include "Core/Memory.h"
+#include <atomic>
 #include <functional>
 
 
 namespace Silex
 {
-    using Task = std::function<void()>;
 
+    //=========================================================================
+    // タスクカウンター
+    //-------------------------------------------------------------------------
+    // AddTask で追加したタスクの数を数え、全て完了したかを判定する
+    // ThreadPool::Wait でこのカウンターのタスクのみを待機できる
+    //=========================================================================
+    class TaskCounter
+    {
+    public:
+
+        TaskCounter() = default;
+
+        void Add(uint32 count)
+        {
+            remaining.fetch_add(count, std::memory_order_relaxed);
+        }
+
+        void Done()
+        {
+            remaining.fetch_sub(1, std::memory_order_release);
+        }
+
+        bool IsDone() const
+        {
+            return remaining.load(std::memory_order_acquire) == 0;
+        }
+
+        uint32 GetRemaining() const
+        {
+            return remaining.load(std::memory_order_relaxed);
+        }
+
+    private:
+
+        std::atomic<uint32> remaining = 0;
+
+    private:
+
+        TaskCounter(const TaskCounter&)            = delete;
+        TaskCounter& operator=(const TaskCounter&) = delete;
+    };
+
+
+    //=========================================================================
+    // タスクスロット
+    //-------------------------------------------------------------------------
+    // キャッシュライン 1本分の固定サイズで、関数オブジェクトをそのまま格納する
+    // スロットはスレッドプール内で再利用するので、タスクの追加・実行でヒープ確保は発生しない
+    // 格納できないサイズのキャプチャはコンパイルエラーになる（大きなデータはポインタで渡すこと）
+    //=========================================================================
+    struct SL_CACHE_ALIGN TaskSlot
+    {
+        static constexpr uint64 storageByteSize = SL_CACHE_LINE_SIZE - sizeof(void*) * 2;
+
+        // 呼び出し後に関数オブジェクトを破棄する
+        using ExecuteFunction = void(*)(void* storage);
+
+        ExecuteFunction execute = nullptr;
+        TaskCounter*    counter = nullptr;
+
+        alignas(16) byte storage[storageByteSize];
+    };
+
+    static_assert(sizeof(TaskSlot) == SL_CACHE_LINE_SIZE, "タスクスロットはキャッシュライン 1本分のサイズである必要があります");
+
+
+    //=========================================================================
+    // ワークスティーリング スレッドプール
+    //-------------------------------------------------------------------------
+    // ワーカー毎にタスクの両端キュー（Chase-Lev）を持ち、ワーカー内から追加したタスクは自身のキューに積む
+    // ワーカー外から追加したタスクはロックフリーの共有キューに積み、空いたワーカーが取り出す
+    // 自身のキューと共有キューが空なら、ランダムに選んだ他のワーカーのキューから盗む
+    //
+    // Initialize 前に追加したタスクは共有キューに溜まり、ワーカー起動後に実行される
+    //=========================================================================
     class ThreadPool
     {
     public:
@@ -15,13 +90,62 @@ namespace Silex
         static void Initialize();
         static void Finalize();
 
-        static void AddTask(Task&& task);
+        // 関数オブジェクトはスロットにムーブ（左辺値ならコピー）して格納する
+        template<typename Function>
+        static void AddTask(Function&& function)
+        {
+            AddTask(Traits::Forward<Function>(function), nullptr);
+        }
+
         static void WaitAll();
 
+        // カウンター付きで追加し、そのカウンターのタスクのみを待機する（待機中は他のタスクを実行して手伝う）
+        template<typename Function>
+        static void AddTask(Function&& function, TaskCounter& counter)
+        {
+            AddTask(Traits::Forward<Function>(function), &counter);
+        }
+
+        static void Wait(const TaskCounter& counter);
+
+        // 残っているタスクを 1つ実行する（実行するタスクがなければ false）
+        // ワーカー外で完了を待つ間に、タスクの消化を手伝うために使用する
+        static bool RunPendingTask();
+
         static uint32 GetThreadCount();
         static uint32 GetWorkingThreadCount();
         static uint32 GetIdleThreadCount();
+        static uint32 GetPendingTaskCount();
         static bool   HasRunningTask();
+
+        // 呼び出し元がワーカースレッドかどうか
+        static bool IsWorkerThread();
+
+    private:
+
+        template<typename Function>
+        static void AddTask(Function&& function, TaskCounter* counter)
+        {
+            using FunctionT = std::decay_t<Function>;
+
+            static_assert(sizeof(FunctionT)  <= TaskSlot::storageByteSize, "タスクのキャプチャがスロットのサイズ（48 バイト）を超えています。大きなデータはポインタで渡してください");
+            static_assert(alignof(FunctionT) <= 16,                        "タスクのアライメントが 16 バイトを超えています");
+
+            TaskSlot* slot = AllocateTaskSlot();
+            Memory::Construct<FunctionT>(slot->storage, Traits::Forward<Function>(function));
+
+            slot->execute = [](void* storage)
+            {
+                FunctionT& function = *static_cast<FunctionT*>(storage);
+                std::invoke(function);
+                Memory::Destruct(&function);
+            };
+
+            SubmitTask(slot, counter);
+        }
+
+        static TaskSlot* AllocateTaskSlot();
+        static void      SubmitTask(TaskSlot* slot, TaskCounter* counter);
     };
 }
 
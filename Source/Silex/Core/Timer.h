@@ -2,11 +2,12 @@
 #pragma once
 
 #include "Core/OS.h"
-#include <unordered_map>
 
 
 namespace Silex
 {
+    // 経過時間はナノ秒の整数で保持し、取得時に変換する
+    // （float の秒で保持すると、起動から数時間でマイクロ秒の精度が失われる）
     class Timer
     {
     public:
@@ -18,93 +19,31 @@ namespace Silex
 
         void Reset()
         {
-            start = OS::Get()->GetTickSeconds() / (float)1'000'000;
+            start = OS::Get()->GetTickNanoseconds();
         }
 
-        float Elapsed()
-        {
-            return OS::Get()->GetTickSeconds() / (float)1'000'000 - start;
-        }
-
-        float ElapsedMilli()
+        uint64 ElapsedNano()
         {
-            return Elapsed() * 1000.0f;
+            return OS::Get()->GetTickNanoseconds() - start;
         }
 
-        float ElapsedMicron()
-        {
-            return Elapsed();
-        }
-
-    private:
-
-        float start;
-    };
-
-
-    class PerformanceProfiler
-    {
-    public:
-
-        static PerformanceProfiler& Get()
-        {
-            static PerformanceProfiler profiler;
-            return profiler;
-        }
-
-        void AddProfile(const char* name, float time)
-        {
-            if (!perFrameData.contains(name))
-                perFrameData[name] = 0.0f;
-
-            perFrameData[name] = time;
-        }
-
-        void Reset()
-        {
-            perFrameData.clear();
-        }
-
-        void GetFrameData(std::unordered_map<const char*, float>* outData, bool shouldReset = false)
+        float Elapsed()
         {
-            *outData = perFrameData;
-
-            if (shouldReset)
-            {
-                Reset();
-            }
+            return (float)(ElapsedNano() / 1'000'000'000.0);
         }
 
-    private:
-
-        static inline std::unordered_map<const char*, float> perFrameData;
-    };
-
-
-    // デストラクタを利用した、スコープ寿命のタイマー
-    // 生成されてから破棄されるまでの時間を計測し、プロファイラーに登録する
-    class ScopePerformanceTimer
-    {
-    public:
-
-        ScopePerformanceTimer(const char* name, const PerformanceProfiler& profiler)
-            : name(name)
-            , profiler(profiler)
+        float ElapsedMilli()
         {
+            return (float)(ElapsedNano() / 1'000'000.0);
         }
 
-        ~ScopePerformanceTimer()
+        float ElapsedMicron()
         {
-            float time = timer.ElapsedMilli();
-            profiler.AddProfile(name, time);
+            return (float)(ElapsedNano() / 1'000.0);
         }
 
     private:
 
-        const char*         name;
-        PerformanceProfiler profiler;
-        Timer               timer;
+        uint64 start;
     };
-
-#define SL_SCOPE_PROFILE(name)  ScopePerformanceTimer timer__LINE__(name, PerformanceProfiler::Get());
-}
\ No newline at end of file
+}
@@ -60,6 +60,8 @@ namespace Silex
         std::vector<AssetID>  Assets;
     };
 
+    SL_USE_OBJECT_POOL(DirectoryNode)
+
 
     class AssetBrowserPanel
     {
@@ -5,9 +5,13 @@
 #include "Editor/ConsoleLogger.h"
 #include "Editor/EditorSplashImage.h"
 
-#include "Core/Timer.h"
+#include "Core/Profiler.h"
+#include "Core/FrameStatistics.h"
+#include "Core/Metrics.h"
+#include "Core/HitchDetector.h"
 #include "Core/Random.h"
 #include "Core/Engine.h"
+#include "Core/MainThreadQueue.h"
 #include "Rendering/Renderer.h"
 #include "Serialize/SceneSerializer.h"
 
@@ -18,6 +22,57 @@
 
 namespace Silex
 {
+    // プロファイラーのノードをツリーの 1行として描画し、次に描画するノードのインデックスを返す
+    static uint32 DrawProfileNode(const PoolVector<ProfileNode>& nodes, uint32 index)
+    {
+        const ProfileNode& node = nodes[index];
+        bool isLeaf = node.numDescendants == 0;
+
+        ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_DefaultOpen;
+        if (isLeaf)
+        {
+            flags |= ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+        }
+
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        bool open = ImGui::TreeNodeEx((void*)node.path, flags, "%s", node.name);
+
+        ImGui::TableNextColumn(); ImGui::Text("%d",   node.numCalls);
+        ImGui::TableNextColumn(); ImGui::Text("%.3f", node.totalTime);
+        ImGui::TableNextColumn(); ImGui::Text("%.3f", node.GetAverageTime());
+        ImGui::TableNextColumn(); ImGui::Text("%.3f", node.minTime);
+        ImGui::TableNextColumn(); ImGui::Text("%.3f", node.maxTime);
+
+        uint32 next = index + 1;
+        uint32 end  = index + 1 + node.numDescendants;
+
+        if (open && !isLeaf)
+        {
+            while (next < end)
+            {
+                next = DrawProfileNode(nodes, next);
+            }
+
+            ImGui::TreePop();
+        }
+
+        // 閉じている場合は、サブツリーを飛ばす
+        return end;
+    }
+
+    // フレーム時間の統計を 1行として描画する
+    static void DrawTimeSummary(const char* name, uint32 depth, const FrameTimeSummary& summary)
+    {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn(); ImGui::Text("%*s%s", depth * 2, "", name);
+        ImGui::TableNextColumn(); ImGui::Text("%.3f", summary.p50);
+        ImGui::TableNextColumn(); ImGui::Text("%.3f", summary.p90);
+        ImGui::TableNextColumn(); ImGui::Text("%.3f", summary.p99);
+        ImGui::TableNextColumn(); ImGui::Text("%.3f", summary.p999);
+        ImGui::TableNextColumn(); ImGui::Text("%.3f", summary.max);
+    }
+
     void Editor::Init()
     {
         SL_LOG_TRACE("Editor::Init");
@@ -61,7 +116,15 @@ namespace Silex
     void Editor::Render()
     {
         SL_SCOPE_PROFILE("Render - Editor");
-        Renderer::Get()->SetDefaultFramebuffer();
+
+        if (Renderer::Get()->IsRenderThreadRunning())
+        {
+            SL_ENQUEUE_RENDER_COMMAND("SetDefaultFramebuffer", []() { Renderer::Get()->SetDefaultFramebuffer(); });
+        }
+        else
+        {
+            Renderer::Get()->SetDefaultFramebuffer();
+        }
 
         ImGuiViewport* viewport = ImGui::GetMainViewport();
         ImGui::SetNextWindowPos(viewport->Pos);
@@ -261,11 +324,214 @@ namespace Silex
             ImGui::Text("ShadowDrawCall:   %d", stats.numShadowDrawCall);
             ImGui::Text("NumMesh:          %d", stats.numRenderMesh);
 
+            const TaskQueueStats& queueStats = Renderer::Get()->GetRenderTaskQueue().GetStats();
+            ImGui::Text("RenderCommand:    %d (%.1f KB, Peak: %.1f KB, Chunk: %d)", queueStats.numCommands, queueStats.usedSize / 1024.0, queueStats.peakUsedSize / 1024.0, queueStats.numChunks);
+
+            const MainThreadQueueStats& mainThreadStats = MainThreadQueue::GetStats();
+            ImGui::Text("MainThreadTask:   %d (Pending: %d, %.2f ms, Max: %.2f ms)", mainThreadStats.numExecuted, mainThreadStats.numPending, mainThreadStats.executeTime, mainThreadStats.maxTaskTime);
+
+            ImGui::SeparatorText("");
+
+            // 直近フレームの分布（平均では見えないヒッチを確認する）
+            const FrameTimeSummary& frameSummary = FrameStatistics::GetFrameTimeSummary();
+            ImGui::Text("FrameTime (%d frames): Mean %.2f / p50 %.2f / p90 %.2f / p99 %.2f / p99.9 %.2f / Max %.2f ms",
+                frameSummary.count, frameSummary.mean, frameSummary.p50, frameSummary.p90, frameSummary.p99, frameSummary.p999, frameSummary.max);
+
+            static float recentFrameTimes[240];
+            uint32 numRecentFrames = FrameStatistics::CopyFrameTimes(recentFrameTimes, std::size(recentFrameTimes));
+            ImGui::PlotLines("##FrameTime", recentFrameTimes, numRecentFrames, 0, "FrameTime (ms)", 0.0f, frameSummary.p999 * 1.5f, ImVec2(-1.0f, 60.0f));
+
+            // バケットの下限が 0, 4, 8, 12, 16.7, 20, 25, 33.3, 50, 100 ms のヒストグラム
+            float histogram[FrameStatistics::numBuckets];
+            for (uint32 i = 0; i < FrameStatistics::numBuckets; i++)
+            {
+                histogram[i] = (float)FrameStatistics::GetHistogram()[i];
+            }
+
+            ImGui::PlotHistogram("##FrameTimeHistogram", histogram, FrameStatistics::numBuckets, 0, "Histogram", 0.0f, FLT_MAX, ImVec2(-1.0f, 60.0f));
+
+            if (ImGui::TreeNode("Scope Percentile (ms)"))
+            {
+                if (ImGui::BeginTable("ScopePercentile", 6, ImGuiTableFlags_BordersV | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable))
+                {
+                    ImGui::TableSetupColumn("Scope", ImGuiTableColumnFlags_NoHide);
+                    ImGui::TableSetupColumn("p50");
+                    ImGui::TableSetupColumn("p90");
+                    ImGui::TableSetupColumn("p99");
+                    ImGui::TableSetupColumn("p99.9");
+                    ImGui::TableSetupColumn("Max");
+                    ImGui::TableHeadersRow();
+
+                    DrawTimeSummary("Frame", 0, frameSummary);
+                    for (const ScopeTimeSummary& scope : FrameStatistics::GetScopeSummaries())
+                    {
+                        DrawTimeSummary(scope.name, scope.depth, scope.summary);
+                    }
+
+                    ImGui::EndTable();
+                }
+
+                ImGui::TreePop();
+            }
+
+            // 全サブシステムのメトリクス（Value は直前のフレームの値、Avg / Max は履歴内の値）
+            if (ImGui::TreeNode("Metrics"))
+            {
+                if (ImGui::BeginTable("Metrics", 4, ImGuiTableFlags_BordersV | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable))
+                {
+                    ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_NoHide);
+                    ImGui::TableSetupColumn("Value");
+                    ImGui::TableSetupColumn("Avg");
+                    ImGui::TableSetupColumn("Max");
+                    ImGui::TableHeadersRow();
+
+                    static int64 history[Metrics::historySize];
+                    for (MetricID id = 1; id <= Metrics::GetMetricCount(); id++)
+                    {
+                        uint32 count = Metrics::GetHistory(id, history, Metrics::historySize);
+
+                        double total = 0.0;
+                        int64  max   = 0;
+                        for (uint32 i = 0; i < count; i++)
+                        {
+                            total += (double)history[i];
+                            max    = std::max(max, history[i]);
+                        }
+
+                        ImGui::TableNextRow();
+                        ImGui::TableNextColumn(); ImGui::Text("%s",   Metrics::GetName(id));
+                        ImGui::TableNextColumn(); ImGui::Text("%lld", Metrics::GetValue(id));
+                        ImGui::TableNextColumn(); ImGui::Text("%.1f", count ? total / count : 0.0);
+                        ImGui::TableNextColumn(); ImGui::Text("%lld", max);
+                    }
+
+                    ImGui::EndTable();
+                }
+
+                ImGui::TreePop();
+            }
+
+            // 予算を超えたフレームの記録（新しい順）
+            if (ImGui::TreeNode("Hitches", "Hitches (%llu)", (unsigned long long)HitchDetector::GetTotalHitchCount()))
+            {
+                float budget = HitchDetector::GetBudget();
+                if (ImGui::DragFloat("Budget (ms)", &budget, 0.1f, 1.0f, 1000.0f, "%.1f"))
+                {
+                    HitchDetector::SetBudget(budget);
+                }
+
+                if (ImGui::Button("Clear"))
+                {
+                    HitchDetector::Clear();
+                }
+
+                ImGui::SameLine();
+                if (ImGui::Button("Save Log"))
+                {
+                    std::string filePath = OS::Get()->SaveFile("Text (*.txt)\0*.txt\0", "txt");
+                    if (!filePath.empty())
+                    {
+                        HitchDetector::WriteLog(filePath);
+                    }
+                }
+
+                for (uint32 i = HitchDetector::GetRecordCount(); i > 0; i--)
+                {
+                    const HitchRecord& record = HitchDetector::GetRecord(i - 1);
+
+                    ImGui::PushID((int)record.frame);
+                    if (ImGui::TreeNode("Hitch", "Frame %llu: %.2f ms", (unsigned long long)record.frame, record.frameTime))
+                    {
+                        if (ImGui::BeginTable("HitchScopes", 6, ImGuiTableFlags_BordersV | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable))
+                        {
+                            ImGui::TableSetupColumn("Scope", ImGuiTableColumnFlags_NoHide);
+                            ImGui::TableSetupColumn("Calls");
+                            ImGui::TableSetupColumn("Total");
+                            ImGui::TableSetupColumn("Avg");
+                            ImGui::TableSetupColumn("Min");
+                            ImGui::TableSetupColumn("Max");
+                            ImGui::TableHeadersRow();
+
+                            uint32 index = 0;
+                            while (index < record.scopes.size())
+                            {
+                                index = DrawProfileNode(record.scopes, index);
+                            }
+
+                            ImGui::EndTable();
+                        }
+
+                        for (const AllocationSiteStats& site : record.allocations)
+                        {
+                            std::string typeName(GetReadableTypeName(site.typeName));
+                            ImGui::Text("Alloc: %8llu byte | %6llu | %s", site.bytes, site.count, typeName.c_str());
+                        }
+
+                        for (const HitchMetric& metric : record.metrics)
+                        {
+                            ImGui::Text("%-32s %lld", metric.name, metric.value);
+                        }
+
+                        for (const std::string& event : record.events)
+                        {
+                            ImGui::TextUnformatted(event.c_str());
+                        }
+
+                        ImGui::TreePop();
+                    }
+                    ImGui::PopID();
+                }
+
+                ImGui::TreePop();
+            }
+
             ImGui::SeparatorText("");
 
-            for (const auto& [profile, time] : Engine::Get()->GetPerformanceData())
+            // スコープ毎の計測結果（ms）
+            const PoolVector<ProfileNode>& profileNodes = Profiler::GetFrameNodes();
+            if (ImGui::BeginTable("Profiler", 6, ImGuiTableFlags_BordersV | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable))
             {
-                ImGui::Text("%-*s %.2f ms", 32, profile, time);
+                ImGui::TableSetupColumn("Scope", ImGuiTableColumnFlags_NoHide);
+                ImGui::TableSetupColumn("Calls");
+                ImGui::TableSetupColumn("Total");
+                ImGui::TableSetupColumn("Avg");
+                ImGui::TableSetupColumn("Min");
+                ImGui::TableSetupColumn("Max");
+                ImGui::TableHeadersRow();
+
+                uint32 index = 0;
+                while (index < profileNodes.size())
+                {
+                    index = DrawProfileNode(profileNodes, index);
+                }
+
+                ImGui::EndTable();
+            }
+
+            if (uint64 dropped = Profiler::GetDroppedCount())
+            {
+                ImGui::Text("Profiler Dropped: %llu", (unsigned long long)dropped);
+            }
+
+            // 全スレッドのタイムラインを Chrome Trace 形式で書き出す（chrome://tracing, Perfetto で表示）
+            if (Profiler::IsCapturing())
+            {
+                ImGui::Text("Capturing... (%d frames left)", Profiler::GetCaptureRemainingFrames());
+            }
+            else if (ImGui::Button("Capture Trace (120 frames)"))
+            {
+                std::string filePath = OS::Get()->SaveFile("Chrome Trace (*.json)\0*.json\0", "json");
+                if (!filePath.empty())
+                {
+                    Profiler::StartCapture(120, filePath);
+                }
+            }
+
+            if (Renderer::Get()->IsRenderThreadRunning())
+            {
+                const RenderThread& renderThread = Renderer::Get()->GetRenderThread();
+                ImGui::Text("%-*s %.2f ms", 32, "RenderThread::Execute", renderThread.GetExecuteTime()   / 1000.0);
+                ImGui::Text("%-*s %.2f ms", 32, "RenderThread::Fence",   renderThread.GetFenceWaitTime() / 1000.0);
             }
 
             ImGui::SeparatorText("");
@@ -278,12 +544,38 @@ namespace Silex
 
 
             // メモリー使用量
-            //ImGui::SeparatorText("");
-            //auto status = PoolAllocator::GetStatus();
-            //for (uint32 i = 0; i < status.size(); i++)
-            //{
-            //    ImGui::Text("メモリプール[%4d byte]:%6d / %6d Block", 32 << i, status[i].TotalAllocated / (32 << i), status[i].TotalSize / (32 << i));
-            //}
+            ImGui::SeparatorText("");
+
+            auto poolStatus = PoolAllocator::GetStatus();
+            for (uint32 i = 0; i < poolStatus.size(); i++)
+            {
+                const MemoryPoolStatus& status = poolStatus[i];
+                ImGui::Text("メモリプール[%4d byte]: %6d / %6d Block (Slab: %d, Peak: %d, LargePage: %d KB)", status.chunkSize, status.totalAllocated / status.chunkSize, status.totalSize / status.chunkSize, status.numSlabs, status.peakSlabs, status.largePageSize / 1024);
+            }
+
+            TLSFHeapStatus heapStatus = HeapAllocator::GetStatus();
+            ImGui::Text("ヒープ: %.2f / %.2f MB (%d Allocation)", heapStatus.usedSize / (1024.0 * 1024.0), heapStatus.committedSize / (1024.0 * 1024.0), heapStatus.numAllocations);
+            ImGui::Text("ヒープ断片化: %.1f%% (FreeBlock: %d, Largest: %.2f MB)", heapStatus.fragmentation * 100.0f, heapStatus.numFreeBlocks, heapStatus.largestFreeBlock / (1024.0 * 1024.0));
+
+            std::vector<ObjectPoolStatus> objectPoolStatus;
+            ObjectPoolBase::GetAllStatus(objectPoolStatus);
+            for (const ObjectPoolStatus& status : objectPoolStatus)
+            {
+                std::string typeName(GetReadableTypeName(status.typeName));
+                ImGui::Text("オブジェクトプール[%s]: %d Object (Peak: %d, Slab: %d, %.2f KB)", typeName.c_str(), status.numObjects, status.peakObjects, status.numSlabs, status.committedSize / 1024.0);
+            }
+
+            // サンプリングによる推定値
+            AllocationSiteStats frameAllocation = MemoryTracker::GetFrameTotal();
+            ImGui::Text("フレーム確保量: %.2f KB (%llu 回)", frameAllocation.bytes / 1024.0, frameAllocation.count);
+
+            if (ImGui::Button("確保元をダンプ"))
+                MemoryTracker::DumpTopAllocators();
+
+            ImGui::SameLine();
+
+            if (ImGui::Button("フレーム差分をダンプ"))
+                MemoryTracker::DumpFrameDiff();
 
             ImGui::End();
         }
@@ -104,6 +104,9 @@ namespace Silex
         // Windows OS バージョンを取得
         CheckOSVersion();
 
+        // ラージページの使用にはメモリ内ページのロック権限が必要（ユーザーに権限が付与されていない場合は使用しない）
+        largePageSize = EnableLockMemoryPrivilege() ? ::GetLargePageMinimum() : 0;
+
         // クロックカウンター初期化
         ::timeBeginPeriod(1);
         ::QueryPerformanceFrequency((LARGE_INTEGER*)&tickPerSecond);
@@ -166,11 +169,94 @@ namespace Silex
         return seconds + decimal;
     }
 
+    uint64 WindowsOS::GetTickNanoseconds()
+    {
+        // GetTickSeconds と同様に整数部と小数点部に分けて計算する（プロファイラー用）
+        // 小数点部は (tickPerSecond - 1) * 1,000,000,000 が上限なので、tickPerSecond が 10,000,000 でもオーバーフローしない
+
+        uint64 tick;
+        ::QueryPerformanceCounter((LARGE_INTEGER*)&tick);
+
+        tick -= startTickCount;
+
+        uint64 nsec    = 1'000'000'000;
+        uint64 seconds = (tick / tickPerSecond) * nsec;                 // 整数部
+        uint64 decimal = (tick % tickPerSecond) * nsec / tickPerSecond; // 小数点部
+
+        return seconds + decimal;
+    }
+
     void WindowsOS::Sleep(uint32 millisec)
     {
         ::Sleep(millisec);
     }
 
+    void* WindowsOS::ReserveMemory(uint64 size, void* address)
+    {
+        // アドレス空間のみ予約し、物理メモリは CommitMemory で割り当てる
+        return ::VirtualAlloc(address, size, MEM_RESERVE, PAGE_NOACCESS);
+    }
+
+    bool WindowsOS::CommitMemory(void* ptr, uint64 size)
+    {
+        return ::VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+    }
+
+    void WindowsOS::DecommitMemory(void* ptr, uint64 size)
+    {
+        // 予約状態に戻し、物理メモリを OS に返却する
+        ::VirtualFree(ptr, size, MEM_DECOMMIT);
+    }
+
+    void WindowsOS::ReleaseMemory(void* ptr, uint64 size)
+    {
+        // MEM_RELEASE ではサイズに 0 を指定する必要がある
+        ::VirtualFree(ptr, 0, MEM_RELEASE);
+    }
+
+    uint64 WindowsOS::GetPageSize()
+    {
+        SYSTEM_INFO info;
+        ::GetSystemInfo(&info);
+
+        return info.dwPageSize;
+    }
+
+    void* WindowsOS::AllocateLargePages(uint64 size, void* address)
+    {
+        if (largePageSize == 0)
+            return nullptr;
+
+        // サイズ・アドレスはラージページ サイズの倍数である必要がある
+        return ::VirtualAlloc(address, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+    }
+
+    uint64 WindowsOS::GetLargePageSize()
+    {
+        return largePageSize;
+    }
+
+    bool WindowsOS::EnableLockMemoryPrivilege()
+    {
+        HANDLE token = nullptr;
+        if (!::OpenProcessToken(::GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token))
+            return false;
+
+        TOKEN_PRIVILEGES privileges = {};
+        privileges.PrivilegeCount           = 1;
+        privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+
+        bool enabled = false;
+        if (::LookupPrivilegeValueW(nullptr, SE_LOCK_MEMORY_NAME, &privileges.Privileges[0].Luid))
+        {
+            // 権限が付与されていない場合も成功を返し、ERROR_NOT_ALL_ASSIGNED が設定される
+            enabled = ::AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr) && ::GetLastError() == ERROR_SUCCESS;
+        }
+
+        ::CloseHandle(token);
+        return enabled;
+    }
+
     std::string WindowsOS::OpenFile(const char* filter)
     {
         OPENFILENAMEA ofn;
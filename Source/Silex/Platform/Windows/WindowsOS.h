@@ -21,8 +21,20 @@ namespace Silex
 
         // 時間
         uint64 GetTickSeconds()       override;
+        uint64 GetTickNanoseconds()   override;
         void   Sleep(uint32 millisec) override;
 
+        // 仮想メモリ
+        void*  ReserveMemory(uint64 size, void* address = nullptr) override;
+        bool   CommitMemory(void* ptr, uint64 size)                override;
+        void   DecommitMemory(void* ptr, uint64 size)              override;
+        void   ReleaseMemory(void* ptr, uint64 size)               override;
+        uint64 GetPageSize()                                       override;
+
+        // ラージページ
+        void*  AllocateLargePages(uint64 size, void* address = nullptr) override;
+        uint64 GetLargePageSize()                                       override;
+
         // ファイル
         std::string OpenFile(const char* filter = "All\0*.*\0")                                  override;
         std::string SaveFile(const char* filter = "All\0*.*\0", const char* extention = nullptr) override;
@@ -39,6 +51,7 @@ namespace Silex
 
         HRESULT TrySetWindowCornerStyle(HWND hWnd, bool tryRound);
         void    CheckOSVersion();
+        bool    EnableLockMemoryPrivilege();
 
     private:
 
@@ -55,6 +68,9 @@ namespace Silex
         // 高性能クロックカウンター
         uint64 startTickCount = 0;
         uint64 tickPerSecond  = 0;
+
+        // ラージページ サイズ（SeLockMemoryPrivilege が有効にできなかった場合は 0）
+        uint64 largePageSize = 0;
     };
 
 
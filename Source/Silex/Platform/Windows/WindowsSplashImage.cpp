@@ -70,6 +70,9 @@ namespace Silex
 
     static SplashImageContext context;
 
+    // メッセージループは Hide まで戻らないので、スレッドプールのワーカーを占有しないよう専用スレッドで実行する
+    static std::thread splashThread;
+
 
     int64 CALLBACK SplashScreenWindowProc(HWND hWnd, uint32 message, uint64 wParam, int64 lParam)
     {
@@ -199,19 +202,12 @@ namespace Silex
         ::ShowWindow(context.windowHandle, SW_SHOW);
         ::UpdateWindow(context.windowHandle);
 
+        // 専用スレッドなので、メッセージが届くまで眠って待つ（WM_QUIT で 0 が返る）
         MSG message;
-        while (true)
+        while (::GetMessageW(&message, NULL, 0, 0) > 0)
         {
-            if (::PeekMessageW(&message, NULL, 0, 0, PM_REMOVE))
-            {
-                ::TranslateMessage(&message);
-                ::DispatchMessageW(&message);
-
-                if (message.message == WM_QUIT)
-                {
-                    break;
-                }
-            }
+            ::TranslateMessage(&message);
+            ::DispatchMessageW(&message);
         }
 
         ::DeleteObject(context.backgroundBitmap);
@@ -229,7 +225,7 @@ namespace Silex
         context.text[TextType::StartupProgress] = L"Initialize...";
 
         // SplashScreen スレッド開始
-        ThreadPool::AddTask(&SplashScreenThread);
+        splashThread = std::thread(&SplashScreenThread);
     }
 
     void EditorSplashImage::Hide()
@@ -241,8 +237,13 @@ namespace Silex
             context.windowHandle = NULL;
         }
 
-        // SplashScreen スレッドを含む全スレッドを待機 
-        // エンジンの初期化完了後に呼ばれるはずだが、残っているものがあれば待機する
+        // SplashScreen スレッドの終了を待機
+        if (splashThread.joinable())
+        {
+            splashThread.join();
+        }
+
+        // エンジンの初期化完了後に呼ばれるはずだが、残っているタスクがあれば待機する
         ThreadPool::WaitAll();
     }
 
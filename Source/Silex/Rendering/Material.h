@@ -27,4 +27,6 @@ namespace Silex
         glm::vec2         TextureTiling = { 1.0f, 1.0f };
         ShadingModelType  ShadingModel  = BRDF;
     };
+
+    SL_USE_OBJECT_POOL(Material)
 }
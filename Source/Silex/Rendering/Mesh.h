@@ -73,6 +73,9 @@ namespace Silex
         friend class Mesh;
     };
 
+    // サブメッシュ単位で多数生成され、描画時にまとめて走査するので専用プールに配置する
+    SL_USE_OBJECT_POOL(MeshSource)
+
 
     //===========================================
     // メッシュソースのリスト保持するクラス
@@ -42,6 +42,11 @@ namespace Silex
         return CreateShared<GLTexture2D>(desc, path);
     }
 
+    Shared<Texture2D> Texture2D::Create(const RHI::TextureDesc& desc, const TextureSourceData& source)
+    {
+        return CreateShared<GLTexture2D>(desc, source);
+    }
+
     Texture2DArray* Texture2DArray::Create(const RHI::TextureDesc& desc, uint32 size)
     {
         return Memory::Allocate<GLTexture2DArray>(desc, size);
@@ -2,6 +2,7 @@
 #include "PCH.h"
 
 #include "Core/Engine.h"
+#include "Rendering/Renderer.h"
 #include "Rendering/OpenGL/GLEditorUI.h"
 
 #include <imgui/imgui.h>
@@ -12,6 +13,68 @@
 
 namespace Silex
 {
+    //==================================================================
+    // レンダースレッドに渡す描画データのコピー
+    //------------------------------------------------------------------
+    // ImGui の描画リストは次の NewFrame で書き換えられるので、記録時にコピーする
+    // 実行中のフレームと記録中のフレームで 2つ持ち、バッファの容量はフレームを跨いで再利用する
+    //==================================================================
+    struct ImGuiDrawDataSnapshot
+    {
+        ImDrawData            drawData;
+        ImVector<ImDrawList*> drawLists;
+    };
+
+    static ImGuiDrawDataSnapshot s_DrawDataSnapshots[2];
+    static uint32                s_SnapshotIndex = 0;
+
+    // ImVector の代入は解放してから確保し直すので、容量を残したままコピーする
+    template<typename T>
+    static void CopyBuffer(ImVector<T>& dest, const ImVector<T>& src)
+    {
+        dest.resize(src.Size);
+
+        if (src.Size > 0)
+        {
+            std::memcpy(dest.Data, src.Data, src.size_in_bytes());
+        }
+    }
+
+    static ImDrawData* CopyDrawData(ImGuiDrawDataSnapshot& snapshot, const ImDrawData* src)
+    {
+        while (snapshot.drawLists.Size < src->CmdListsCount)
+        {
+            snapshot.drawLists.push_back(IM_NEW(ImDrawList)(ImGui::GetDrawListSharedData()));
+        }
+
+        ImDrawData& dest = snapshot.drawData;
+        dest.Valid            = src->Valid;
+        dest.CmdListsCount    = src->CmdListsCount;
+        dest.TotalIdxCount    = src->TotalIdxCount;
+        dest.TotalVtxCount    = src->TotalVtxCount;
+        dest.DisplayPos       = src->DisplayPos;
+        dest.DisplaySize      = src->DisplaySize;
+        dest.FramebufferScale = src->FramebufferScale;
+        dest.OwnerViewport    = src->OwnerViewport;
+        dest.CmdLists.resize(src->CmdListsCount);
+
+        for (int32 i = 0; i < src->CmdListsCount; i++)
+        {
+            const ImDrawList* srcList  = src->CmdLists[i];
+            ImDrawList*       destList = snapshot.drawLists[i];
+
+            CopyBuffer(destList->CmdBuffer, srcList->CmdBuffer);
+            CopyBuffer(destList->IdxBuffer, srcList->IdxBuffer);
+            CopyBuffer(destList->VtxBuffer, srcList->VtxBuffer);
+            destList->Flags = srcList->Flags;
+
+            dest.CmdLists[i] = destList;
+        }
+
+        return &dest;
+    }
+
+
     void GLEditorUI::Init()
     {
         SL_LOG_TRACE("GLEditorUI::Init");
@@ -21,6 +84,9 @@ namespace Silex
 
         ImGui_ImplGlfw_InitForOpenGL(window, true);
         ImGui_ImplOpenGL3_Init("#version 450");
+
+        // NewFrame で遅延生成されるシェーダー・フォントテクスチャは、レンダースレッドの開始前に生成しておく
+        ImGui_ImplOpenGL3_CreateDeviceObjects();
     }
 
     void GLEditorUI::Shutdown()
@@ -30,6 +96,17 @@ namespace Silex
         ImGui_ImplOpenGL3_Shutdown();
         ImGui_ImplGlfw_Shutdown();
 
+        for (ImGuiDrawDataSnapshot& snapshot : s_DrawDataSnapshots)
+        {
+            for (ImDrawList* drawList : snapshot.drawLists)
+            {
+                IM_DELETE(drawList);
+            }
+
+            snapshot.drawLists.clear();
+            snapshot.drawData.Clear();
+        }
+
         Super::Shutdown();
     }
 
@@ -38,7 +115,19 @@ namespace Silex
         Super::Render();
 
         ImDrawData* drawData = ImGui::GetDrawData();
-        ImGui_ImplOpenGL3_RenderDrawData(drawData);
+
+        if (Renderer::Get()->IsRenderThreadRunning())
+        {
+            // 2フレーム前のコピーは、前フレームの Submit（フェンス）で実行完了している
+            s_SnapshotIndex ^= 1;
+
+            ImDrawData* snapshot = CopyDrawData(s_DrawDataSnapshots[s_SnapshotIndex], drawData);
+            SL_ENQUEUE_RENDER_COMMAND("ImGui", [snapshot]() { ImGui_ImplOpenGL3_RenderDrawData(snapshot); });
+        }
+        else
+        {
+            ImGui_ImplOpenGL3_RenderDrawData(drawData);
+        }
     }
 
     void GLEditorUI::BeginFrame()
@@ -16,6 +16,8 @@ namespace Silex
         , Height(desc.Height)
         , ClearColorValue(desc.ClearColor)
     { 
+        SL_ASSERT_GL_THREAD();
+
         for (const RHI::FramebufferAttachmentDesc& attachment : Desc.AttachmentDescs)
         {
             AttachmentDescs.emplace_back(attachment);
@@ -64,11 +66,14 @@ namespace Silex
 
     GLFramebuffer::~GLFramebuffer()
     {
+        SL_ASSERT_GL_THREAD();
         glDeleteFramebuffers(1, &ID);
     }
 
     void GLFramebuffer::Resize(uint32 width, uint32 height)
     {
+        SL_ASSERT_GL_THREAD();
+
         if (Width == width && Height == height)
             return;
 
@@ -128,44 +133,56 @@ namespace Silex
 
     void GLFramebuffer::Bind() const
     {
+        SL_ASSERT_GL_THREAD();
+
         glBindFramebuffer(GL_FRAMEBUFFER, ID);
         glViewport(0, 0, Width, Height);
     }
 
     void GLFramebuffer::Unbind() const
     {
+        SL_ASSERT_GL_THREAD();
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
     }
 
     void GLFramebuffer::BindAttachment(uint32 slot, uint32 attachmentIndex) const
     {
+        SL_ASSERT_GL_THREAD();
         glBindTextureUnit(slot, Attachments[attachmentIndex]);
     }
 
     void GLFramebuffer::Clear() const
     {
+        SL_ASSERT_GL_THREAD();
+
         glClearColor(ClearColorValue.r, ClearColorValue.g, ClearColorValue.b, ClearColorValue.a);
         glClear(AttachmentTypeFlagBits);
     }
 
     void GLFramebuffer::ClearColor() const
     {
+        SL_ASSERT_GL_THREAD();
+
         glClearColor(ClearColorValue.r, ClearColorValue.g, ClearColorValue.b, ClearColorValue.a);
         glClear(GL_COLOR_BUFFER_BIT);
     }
 
     void GLFramebuffer::ClearDepth() const
     {
+        SL_ASSERT_GL_THREAD();
         glClear(GL_DEPTH_BUFFER_BIT);
     }
 
     void GLFramebuffer::ClearStencil() const
     {
+        SL_ASSERT_GL_THREAD();
         glClear(GL_STENCIL_BUFFER_BIT);
     }
 
     glm::vec4 GLFramebuffer::ReadPixelFloat(uint32 attachmentIndex, uint32 x, uint32 y)
     {
+        SL_ASSERT_GL_THREAD();
+
         glm::vec4 pixelData;
 
         const auto& desc = AttachmentDescs[attachmentIndex];
@@ -180,6 +197,8 @@ namespace Silex
 
     glm::ivec4 GLFramebuffer::ReadPixelInt(uint32 attachmentIndex, uint32 x, uint32 y)
     {
+        SL_ASSERT_GL_THREAD();
+
         glm::ivec4 pixelData;
 
         const auto& desc = AttachmentDescs[attachmentIndex];
@@ -194,6 +213,8 @@ namespace Silex
 
     void GLFramebuffer::ClearAttachment(uint32 attachmentIndex, glm::vec4 value)
     {
+        SL_ASSERT_GL_THREAD();
+
         const auto& desc = AttachmentDescs[attachmentIndex];
         uint32 type      = OpenGL::GLFormatDataType(desc.Format);
         uint32 format    = OpenGL::GLFormat(desc.Format);
@@ -203,6 +224,8 @@ namespace Silex
 
     void GLFramebuffer::ClearAttachment(uint32 attachmentIndex, glm::ivec4 value)
     {
+        SL_ASSERT_GL_THREAD();
+
         const auto& desc = AttachmentDescs[attachmentIndex];
         uint32 type   = OpenGL::GLFormatDataType(desc.Format);
         uint32 format = OpenGL::GLFormat(desc.Format);
@@ -212,12 +235,16 @@ namespace Silex
 
     void GLFramebuffer::SetAttachmentTexture(uint32 attachmentIndex, uint32 textureID, RHI::AttachmentType type)
     {
+        SL_ASSERT_GL_THREAD();
+
         Attachments[attachmentIndex] = textureID;
         glNamedFramebufferTexture(ID, OpenGL::GLAttachmentType(type), Attachments[attachmentIndex], 0);
     }
 
     void GLFramebuffer::AddAttachment(RHI::FramebufferAttachmentDesc desc, uint32 width, uint32 height, uint32 attachmentIndex)
     {
+        SL_ASSERT_GL_THREAD();
+
         uint32 internalFormat = OpenGL::GLInternalFormat(desc.Format);
         uint32 attachmentType = OpenGL::GLAttachmentType(desc.AttachmentType);
 
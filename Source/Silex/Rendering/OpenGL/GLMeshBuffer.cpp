@@ -15,32 +15,41 @@ namespace Silex
         , Size(size)
         , Data(data)
     {
+        SL_ASSERT_GL_THREAD();
+
         glCreateBuffers(1, &ID);
         glNamedBufferData(ID, Size, Data, GL_STATIC_DRAW);
     }
 
     GLVertexBuffer::~GLVertexBuffer()
     {
+        SL_ASSERT_GL_THREAD();
         glDeleteBuffers(1, &ID);
     }
 
     void GLVertexBuffer::SetData(void* data, uint32 byteSize, uint32 offset)
     {
+        SL_ASSERT_GL_THREAD();
+
         glNamedBufferSubData(ID, offset, byteSize, data);
+        OpenGL::RecordUploadBytes(byteSize);
     }
 
     void GLVertexBuffer::Bind() const
     {
+        SL_ASSERT_GL_THREAD();
         glBindBuffer(GL_ARRAY_BUFFER, ID);
     }
 
     void GLVertexBuffer::BindOffset(uint32 bindingindex, uint32 offset, uint32 stride) const
     {
+        SL_ASSERT_GL_THREAD();
         glBindVertexBuffer(bindingindex, ID, offset, stride);
     }
 
     void GLVertexBuffer::Unbind() const
     {
+        SL_ASSERT_GL_THREAD();
         glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
 
@@ -52,27 +61,35 @@ namespace Silex
         , Size(byteSize)
         , Data(data)
     {
+        SL_ASSERT_GL_THREAD();
+
         glCreateBuffers(1, &ID);
         glNamedBufferData(ID, Size, Data, GL_STATIC_DRAW);
     }
 
     GLIndexBuffer::~GLIndexBuffer()
     {
+        SL_ASSERT_GL_THREAD();
         glDeleteBuffers(1, &ID);
     }
 
     void GLIndexBuffer::SetData(void* data, uint32 byteSize, uint32 offset)
     {
+        SL_ASSERT_GL_THREAD();
+
         glNamedBufferSubData(ID, offset, byteSize, data);
+        OpenGL::RecordUploadBytes(byteSize);
     }
 
     void GLIndexBuffer::Bind() const
     {
+        SL_ASSERT_GL_THREAD();
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ID);
     }
 
     void GLIndexBuffer::Unbind() const
     {
+        SL_ASSERT_GL_THREAD();
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     }
 
@@ -86,17 +103,22 @@ namespace Silex
         , Size(size)
         , Data(data)
     {
+        SL_ASSERT_GL_THREAD();
+
         glCreateBuffers(1, &ID);
         glNamedBufferData(ID, Size, Data, GL_DYNAMIC_DRAW);
     }
 
     GLInstanceBuffer::~GLInstanceBuffer()
     {
+        SL_ASSERT_GL_THREAD();
         glDeleteBuffers(1, &ID);
     }
 
     void GLInstanceBuffer::Resize(void* data, uint32 byteSize)
     {
+        SL_ASSERT_GL_THREAD();
+
         Data = data;
         Size = byteSize;
 
@@ -105,16 +127,21 @@ namespace Silex
 
     void GLInstanceBuffer::SetData(void* data, uint32 byteSize, uint32 offset)
     {
+        SL_ASSERT_GL_THREAD();
+
         glNamedBufferSubData(ID, offset, byteSize, data);
+        OpenGL::RecordUploadBytes(byteSize);
     }
 
     void GLInstanceBuffer::Bind() const
     {
+        SL_ASSERT_GL_THREAD();
         glBindBuffer(GL_ARRAY_BUFFER, ID);
     }
 
     void GLInstanceBuffer::Unbind() const
     {
+        SL_ASSERT_GL_THREAD();
         glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
 #endif
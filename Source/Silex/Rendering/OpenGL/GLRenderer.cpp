@@ -100,12 +100,15 @@ namespace Silex
 
     void GLRenderer::BeginFrame()
     {
+        SL_ASSERT_GL_THREAD();
+
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     }
 
     void GLRenderer::EndFrame()
     {
+        SL_ASSERT_GL_THREAD();
         glfwSwapBuffers(m_Window);
     }
 
@@ -115,36 +118,44 @@ namespace Silex
 
     void GLRenderer::SetDefaultFramebuffer()
     {
+        SL_ASSERT_GL_THREAD();
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
     }
 
     void GLRenderer::SetShaderTexture(uint32 slot, uint32 id)
     {
+        SL_ASSERT_GL_THREAD();
         glBindTextureUnit(slot, id);
     }
 
     void GLRenderer::SetViewport(uint32 width, uint32 height)
     {
+        SL_ASSERT_GL_THREAD();
         glViewport(0, 0, width, height);
     }
 
     void GLRenderer::SetStencilFunc(RHI::StrencilOp op, int32 ref, uint32 mask)
     {
+        SL_ASSERT_GL_THREAD();
         glStencilFunc(OpenGL::GLStencilOp(op), ref, mask);
     }
 
     void GLRenderer::SetCullFace(RHI::CullFace face)
     {
+        SL_ASSERT_GL_THREAD();
         glCullFace(OpenGL::GLCullFace(face));
     }
 
     void GLRenderer::EnableBlend(bool enable)
     {
+        SL_ASSERT_GL_THREAD();
         enable? glEnable(GL_BLEND) : glDisable(GL_BLEND);
     }
 
     void GLRenderer::BlitFramebuffer(const Shared<Framebuffer>& src, const Shared<Framebuffer>& dest, RHI::AttachmentBuffer buffer)
     {
+        SL_ASSERT_GL_THREAD();
+
         uint32 width  = src->GetWidth();
         uint32 height = src->GetHeight();
 
@@ -156,21 +167,25 @@ namespace Silex
 
     void GLRenderer::Draw(RHI::PrimitiveType type, uint64 numVertices)
     {
+        SL_ASSERT_GL_THREAD();
         glDrawArrays(OpenGL::GLPrimitivepeType(type), 0, numVertices);
     }
 
     void GLRenderer::DrawInstance(RHI::PrimitiveType type, uint64 numVertices, uint64 numInstance)
     {
+        SL_ASSERT_GL_THREAD();
         glDrawArraysInstanced(OpenGL::GLPrimitivepeType(type), 0, numVertices, numInstance);
     }
 
     void GLRenderer::DrawIndexed(RHI::PrimitiveType type, uint64 numIndices)
     {
+        SL_ASSERT_GL_THREAD();
         glDrawElements(OpenGL::GLPrimitivepeType(type), numIndices, GL_UNSIGNED_INT, 0);
     }
 
     void GLRenderer::DrawIndexedInstance(RHI::PrimitiveType type, uint64 numIndices, uint64 numInstance)
     {
+        SL_ASSERT_GL_THREAD();
         glDrawElementsInstanced(OpenGL::GLPrimitivepeType(type), numIndices, GL_UNSIGNED_INT, 0, numInstance);
     }
 }
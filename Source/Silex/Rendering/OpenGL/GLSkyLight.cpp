@@ -39,6 +39,8 @@ namespace Silex
 
     GLSkyLight::GLSkyLight(const std::string& filePath)
     {
+        SL_ASSERT_GL_THREAD();
+
         glDisable(GL_CULL_FACE);
 
         uint32 hdrTexture = detail::LoadEnvironmentTexture(filePath);
@@ -243,6 +245,8 @@ namespace Silex
 
     GLSkyLight::~GLSkyLight()
     {
+        SL_ASSERT_GL_THREAD();
+
         glDeleteTextures(1, &CubeMap);
         glDeleteTextures(1, &PrefilterMap);
         glDeleteTextures(1, &BRDF);
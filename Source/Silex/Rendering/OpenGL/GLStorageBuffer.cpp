@@ -2,7 +2,7 @@
 #include "PCH.h"
 
 #include "Rendering/OpenGL/GLStorageBuffer.h"
-#include <glad/glad.h>
+#include "Rendering/OpenGL/OpenGLCore.h"
 
 
 namespace Silex
@@ -19,6 +19,8 @@ namespace Silex
         , Data(data)
         , MappedPtr(nullptr)
     {
+        SL_ASSERT_GL_THREAD();
+
         glCreateBuffers(1, &ID);
         glBindBufferBase(GL_SHADER_STORAGE_BUFFER, slot, ID);
 
@@ -33,6 +35,8 @@ namespace Silex
 
     GLStorageBuffer::~GLStorageBuffer()
     {
+        SL_ASSERT_GL_THREAD();
+
         if (MappedPtr)
             glUnmapNamedBuffer(ID);
 
@@ -41,11 +45,16 @@ namespace Silex
 
     void GLStorageBuffer::SetData(uint32 offset, uint32 size, const void* data)
     {
+        SL_ASSERT_GL_THREAD();
+
         std::memcpy((char*)MappedPtr + offset, data, size);
+        OpenGL::RecordUploadBytes(size);
     }
 
     void GLStorageBuffer::ReCreate(uint32 slot, uint32 size, const void* data)
     {
+        SL_ASSERT_GL_THREAD();
+
         if (MappedPtr)
         {
             glUnmapNamedBuffer(ID);
@@ -70,6 +79,8 @@ namespace Silex
     GLStorageBuffer::GLStorageBuffer(uint32 size, uint32 slot, void* data)
         : ID(0), Size(size), Data(data), MappedPtr(nullptr)
     {
+        SL_ASSERT_GL_THREAD();
+
         glCreateBuffers(1, &ID);
         glBindBufferBase(GL_SHADER_STORAGE_BUFFER, slot, ID);
 
@@ -78,16 +89,22 @@ namespace Silex
 
     GLStorageBuffer::~GLStorageBuffer()
     {
+        SL_ASSERT_GL_THREAD();
         glDeleteBuffers(1, &ID);
     }
 
     void GLStorageBuffer::SetData(uint32 offset, uint32 size, const void* data)
     {
+        SL_ASSERT_GL_THREAD();
+
         glNamedBufferSubData(ID, offset, size, data);
+        OpenGL::RecordUploadBytes(size);
     }
 
     void GLStorageBuffer::ReCreate(uint32 slot, uint32 size, const void* data)
     {
+        SL_ASSERT_GL_THREAD();
+
         glDeleteBuffers(1, &ID);
         glCreateBuffers(1, &ID);
 
@@ -2,8 +2,8 @@
 #include "PCH.h"
 
 #include "Rendering/OpenGL/GLTexture.h"
+#include "Rendering/OpenGL/OpenGLCore.h"
 #include "Asset/TextureReader.h"
-#include <glad/glad.h>
 
 
 namespace Silex
@@ -12,6 +12,8 @@ namespace Silex
         : Desc(desc)
         , ID(0)
     {
+        SL_ASSERT_GL_THREAD();
+
         auto internaFormat = OpenGL::GLInternalFormat(Desc.Format);
         auto wrap          = OpenGL::GLTextureWrap(Desc.Wrap);
         auto minFilter     = OpenGL::GLTextureMinFilter(Desc.Filter, Desc.GenMipmap);
@@ -33,12 +35,30 @@ namespace Silex
         : Desc(desc)
         , ID(0)
     {
+        SL_ASSERT_GL_THREAD();
+
         // テクスチャファイル読み込み
         TextureReader reader;
-        byte* pixels  = reader.Read(filePath.c_str());
-        uint32 width     = reader.Data.Width;
-        uint32 height    = reader.Data.Height;
-        uint32 component = reader.Data.Channels;
+        reader.Read(filePath.c_str());
+
+        Upload(reader.Data);
+    }
+
+    GLTexture2D::GLTexture2D(const RHI::TextureDesc& desc, const TextureSourceData& source)
+        : Desc(desc)
+        , ID(0)
+    {
+        Upload(source);
+    }
+
+    void GLTexture2D::Upload(const TextureSourceData& source)
+    {
+        SL_ASSERT_GL_THREAD();
+
+        byte*  pixels    = source.Pixels;
+        uint32 width     = source.Width;
+        uint32 height    = source.Height;
+        uint32 component = source.Channels;
 
         GLenum format         = 0;
         GLenum internalFormat = 0;
@@ -85,6 +105,7 @@ namespace Silex
         uint32 mipLevel = 0;
         glTextureStorage2D(ID, mipCount, internalFormat, width, height);
         glTextureSubImage2D(ID, mipLevel, 0, 0, width, height, format, dataType, pixels);
+        OpenGL::RecordUploadBytes((uint64)width * height * component);
 
         // ミップマップ生成
         if (Desc.GenMipmap)
@@ -108,16 +129,19 @@ namespace Silex
 
     GLTextureCube::~GLTextureCube()
     {
+        SL_ASSERT_GL_THREAD();
         glDeleteTextures(1, &ID);
     }
 
     GLTexture2D::~GLTexture2D()
     {
+        SL_ASSERT_GL_THREAD();
         glDeleteTextures(1, &ID);
     }
 
     GLTexture2DArray::~GLTexture2DArray()
     {
+        SL_ASSERT_GL_THREAD();
         glDeleteTextures(1, &ID);
     }
 
@@ -126,16 +150,19 @@ namespace Silex
 
     void GLTexture2D::Bind(uint32 slot) const
     {
+        SL_ASSERT_GL_THREAD();
         glBindTextureUnit(slot, ID);
     }
 
     void GLTexture2DArray::Bind(uint32 slot) const
     {
+        SL_ASSERT_GL_THREAD();
         glBindTextureUnit(slot, ID);
     }
 
     void GLTextureCube::Bind(uint32 slot) const
     {
+        SL_ASSERT_GL_THREAD();
         glBindTextureUnit(slot, ID);
     }
 }
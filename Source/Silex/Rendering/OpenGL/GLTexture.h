@@ -18,6 +18,7 @@ namespace Silex
 
         GLTexture2D(const RHI::TextureDesc& desc);
         GLTexture2D(const RHI::TextureDesc& desc, const std::string& filePath);
+        GLTexture2D(const RHI::TextureDesc& desc, const TextureSourceData& source);
         ~GLTexture2D();
 
     public:
@@ -30,12 +31,18 @@ namespace Silex
         uint32            GetID()     const override { return ID;          }
         uint32            GetSize()   const override { return 1;           }
 
+    private:
+
+        void Upload(const TextureSourceData& source);
+
     private:
 
         RHI::TextureDesc  Desc;
         uint32            ID;
     };
 
+    SL_USE_OBJECT_POOL(GLTexture2D)
+
     //==================================================
     // OpenGL テクスチャ2D配列
     //==================================================
@@ -2,7 +2,7 @@
 #include "PCH.h"
 
 #include "Rendering/OpenGL/GLUniformBuffer.h"
-#include <glad/glad.h>
+#include "Rendering/OpenGL/OpenGLCore.h"
 
 
 namespace Silex
@@ -12,6 +12,8 @@ namespace Silex
         , Size(size)
         , Data(data)
     {
+        SL_ASSERT_GL_THREAD();
+
         glCreateBuffers(1, &ID);
         glBindBufferBase(GL_UNIFORM_BUFFER, slot, ID);
         glNamedBufferData(ID, size, data, GL_DYNAMIC_DRAW);
@@ -19,11 +21,15 @@ namespace Silex
 
     GLUniformBuffer::~GLUniformBuffer()
     {
+        SL_ASSERT_GL_THREAD();
         glDeleteBuffers(1, &ID);
     }
 
     void GLUniformBuffer::SetData(uint32 offset, uint32 size, const void* data)
     {
+        SL_ASSERT_GL_THREAD();
+
         glNamedBufferSubData(ID, offset, size, data);
+        OpenGL::RecordUploadBytes(size);
     }
 }
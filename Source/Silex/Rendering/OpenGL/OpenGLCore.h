@@ -3,12 +3,21 @@
 
 #include <glad/glad.h>
 #include "Rendering/RenderDefine.h"
+#include "Rendering/RenderThread.h"
+#include "Core/Metrics.h"
 
 
 namespace Silex
 {
     namespace OpenGL
     {
+        // CPU から GPU へ転送したバイト数を記録する
+        inline void RecordUploadBytes(uint64 byteSize)
+        {
+            static const MetricID metric = Metrics::RegisterCounter("Render/UploadBytes");
+            Metrics::Increment(metric, byteSize);
+        }
+
         inline GLenum GLCullFace(RHI::CullFace face)
         {
             switch (face)
@@ -0,0 +1,143 @@
+
+#include "PCH.h"
+
+#include "Core/Profiler.h"
+#include "Rendering/RenderThread.h"
+
+
+namespace Silex
+{
+    void RenderThread::Start(MakeContextCurrentFunction makeCurrentFunction, void* renderContext)
+    {
+        SL_ASSERT(!running);
+
+        makeCurrent  = makeCurrentFunction;
+        context      = renderContext;
+        pendingQueue = nullptr;
+        stopping     = false;
+        running      = true;
+
+        // GL コンテキストは 1度に 1つのスレッドでしかカレントにできない
+        if (makeCurrent)
+        {
+            makeCurrent(nullptr);
+        }
+
+        thread = std::thread(&RenderThread::ThreadLoop, this);
+
+        // コンテキストを移した場合のみ、以降の GL 命令をレンダースレッドに限定する
+        if (makeCurrent)
+        {
+            glThreadID.store(thread.get_id(), std::memory_order_release);
+        }
+    }
+
+    void RenderThread::Stop()
+    {
+        if (!running)
+            return;
+
+        Wait();
+
+        {
+            std::scoped_lock lock(mutex);
+            stopping = true;
+        }
+
+        condition.notify_all();
+        thread.join();
+
+        running = false;
+
+        if (makeCurrent)
+        {
+            glThreadID.store(std::thread::id(), std::memory_order_release);
+        }
+
+        // 終了処理（リソースの破棄）はメインスレッドで行うので、コンテキストを戻す
+        if (makeCurrent)
+        {
+            makeCurrent(context);
+        }
+    }
+
+    void RenderThread::Submit(TaskQueue* queue)
+    {
+        Wait();
+
+        {
+            std::scoped_lock lock(mutex);
+            pendingQueue = queue;
+        }
+
+        condition.notify_all();
+    }
+
+    void RenderThread::Wait()
+    {
+        uint64 begin = OS::Get()->GetTickSeconds();
+
+        {
+            std::unique_lock lock(mutex);
+            while (pendingQueue != nullptr)
+            {
+                condition.wait(lock);
+            }
+        }
+
+        fenceWaitTime = OS::Get()->GetTickSeconds() - begin;
+    }
+
+    bool RenderThread::IsGLThread()
+    {
+        std::thread::id owner = glThreadID.load(std::memory_order_acquire);
+        return owner == std::thread::id() || owner == std::this_thread::get_id();
+    }
+
+    void RenderThread::ThreadLoop()
+    {
+        if (makeCurrent)
+        {
+            makeCurrent(context);
+        }
+
+        Profiler::SetThreadName("Render Thread");
+
+        while (true)
+        {
+            TaskQueue* queue = nullptr;
+
+            {
+                std::unique_lock lock(mutex);
+                while (!stopping && pendingQueue == nullptr)
+                {
+                    condition.wait(lock);
+                }
+
+                if (pendingQueue == nullptr)
+                    break;
+
+                queue = pendingQueue;
+            }
+
+            // キューの実行中は、メインスレッドがもう一方のキューに記録している
+            SL_SCOPE_PROFILE("RenderThread::Execute");
+
+            uint64 begin = OS::Get()->GetTickSeconds();
+            queue->Execute();
+            executeTime.store(OS::Get()->GetTickSeconds() - begin, std::memory_order_relaxed);
+
+            {
+                std::scoped_lock lock(mutex);
+                pendingQueue = nullptr;
+            }
+
+            condition.notify_all();
+        }
+
+        if (makeCurrent)
+        {
+            makeCurrent(nullptr);
+        }
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Core/TaskQueue.h"
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+
+namespace Silex
+{
+    // コンテキストを呼び出しスレッドでカレントにする（nullptr で解除）
+    using MakeContextCurrentFunction = void(*)(void* context);
+
+
+    //=========================================================================
+    // レンダースレッド
+    //-------------------------------------------------------------------------
+    // GL コンテキストを所有し、メインスレッドが記録したレンダーコマンドのキューを実行する
+    // メインスレッドがフレーム N を記録している間に、フレーム N-1 のキューを実行する
+    //
+    // 起動中はメインスレッドから GL 命令を直接呼び出さないこと（全て SL_ENQUEUE_RENDER_COMMAND 経由）
+    // コンテキストの切り替えは呼び出し側が渡すので、GL 無しでも（テスト・ベンチマーク）動作する
+    //=========================================================================
+    class RenderThread
+    {
+    public:
+
+        // メインスレッドのコンテキストを解除し、レンダースレッドに移す（makeCurrent が nullptr なら切り替えない）
+        void Start(MakeContextCurrentFunction makeCurrent, void* context);
+
+        // 実行中のキューを完了させ、GL コンテキストをメインスレッドに戻す
+        void Stop();
+
+        // 記録済みのキューを渡す（前のキューの実行が完了するまで待機する）
+        void Submit(TaskQueue* queue);
+
+        // 渡したキューの実行完了を待つ（フェンス）
+        void Wait();
+
+        bool IsRunning() const { return running; }
+
+        // 呼び出し元のスレッドから GL 命令を呼び出してよいか
+        // コンテキストを所有するレンダースレッドの起動中はレンダースレッドのみ、それ以外はどのスレッドでも true
+        static bool IsGLThread();
+
+        // 直前のフレームのキュー実行時間と、メインスレッドがフェンスで待機した時間（μs）
+        uint64 GetExecuteTime()   const { return executeTime.load(std::memory_order_relaxed); }
+        uint64 GetFenceWaitTime() const { return fenceWaitTime;                               }
+
+    private:
+
+        void ThreadLoop();
+
+    private:
+
+        std::thread             thread;
+        std::mutex              mutex;
+        std::condition_variable condition;
+
+        MakeContextCurrentFunction makeCurrent = nullptr;
+        void*                      context     = nullptr;
+
+        TaskQueue* pendingQueue = nullptr;
+        bool       stopping     = false;
+        bool       running      = false;
+
+        std::atomic<uint64> executeTime   = 0;
+        uint64              fenceWaitTime = 0;
+
+        // GL コンテキストを所有しているレンダースレッド（未起動なら空の ID）
+        static inline std::atomic<std::thread::id> glThreadID;
+    };
+}
+
+
+// レンダースレッドの起動中に、レンダースレッド以外から GL 命令が呼び出されていないかを検証する
+#define SL_ASSERT_GL_THREAD() SL_ASSERT(::Silex::RenderThread::IsGLThread(), "レンダースレッドの起動中に、レンダースレッド以外から GL 命令が呼び出されました")
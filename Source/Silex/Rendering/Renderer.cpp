@@ -1,7 +1,8 @@
 
 #include "PCH.h"
 
-#include "Core/Timer.h"
+#include "Core/Profiler.h"
+#include "Core/Window.h"
 #include "Rendering/Shader.h"
 #include "Rendering/Texture.h"
 #include "Rendering/Renderer.h"
@@ -14,6 +15,12 @@
 
 namespace Silex
 {
+    // レンダースレッドとメインスレッド間で、ウィンドウの GL コンテキストの所有を移す
+    static void MakeContextCurrent(void* window)
+    {
+        glfwMakeContextCurrent(static_cast<GLFWwindow*>(window));
+    }
+
     static void QueryMonitorInfo()
     {
         int32 monitorCount;
@@ -57,7 +64,8 @@ namespace Silex
     void Renderer::Init()
     {
         // レンダータスクキュー初期化
-        m_TaskQueue.Init();
+        m_TaskQueues[0].Init();
+        m_TaskQueues[1].Init();
 
         // レンダーAPI 初期化
         s_RendererPlatform = RendererPlatform::Create();
@@ -125,24 +133,87 @@ namespace Silex
         m_CheckerboardTexture.Reset();
 
         s_RendererPlatform->Shutdown();
-        m_TaskQueue.Release();
+
+        m_TaskQueues[0].Release();
+        m_TaskQueues[1].Release();
     }
 
     void Renderer::BeginFrame()
     {
         SL_SCOPE_PROFILE("BeginFrame");
-        s_RendererPlatform->BeginFrame();
+
+        if (m_RenderThread.IsRunning())
+        {
+            SL_ENQUEUE_RENDER_COMMAND("BeginFrame", [platform = s_RendererPlatform]() { platform->BeginFrame(); });
+        }
+        else
+        {
+            s_RendererPlatform->BeginFrame();
+        }
     }
 
     void Renderer::EndFrame()
     {
         SL_SCOPE_PROFILE("Present");
-        s_RendererPlatform->EndFrame();
+
+        if (m_RenderThread.IsRunning())
+        {
+            SL_ENQUEUE_RENDER_COMMAND("Present", [platform = s_RendererPlatform]() { platform->EndFrame(); });
+
+            // 前フレームのキューの実行完了を待ってから（フェンス）、このフレームのキューを渡して記録先を入れ替える
+            m_RenderThread.Submit(&m_TaskQueues[m_RecordIndex]);
+            m_RecordIndex ^= 1;
+        }
+        else
+        {
+            m_TaskQueues[m_RecordIndex].Execute();
+            s_RendererPlatform->EndFrame();
+        }
     }
 
     void Renderer::Resize(uint32 width, uint32 height)
     {
-        s_RendererPlatform->Resize(width, height);
+        if (m_RenderThread.IsRunning())
+        {
+            // キャプチャのカンマがマクロ引数の区切りになるので、直接キューに積む
+            GetRenderTaskQueue().Enqueue("Resize", [platform = s_RendererPlatform, width, height]() { platform->Resize(width, height); });
+        }
+        else
+        {
+            s_RendererPlatform->Resize(width, height);
+        }
+    }
+
+    void Renderer::Flush()
+    {
+        if (m_RenderThread.IsRunning())
+        {
+            m_RenderThread.Submit(&m_TaskQueues[m_RecordIndex]);
+            m_RecordIndex ^= 1;
+
+            m_RenderThread.Wait();
+        }
+        else
+        {
+            m_TaskQueues[m_RecordIndex].Execute();
+        }
+    }
+
+    void Renderer::StartRenderThread()
+    {
+        // 初期化中に記録されたコマンドは、コンテキストを移す前に実行しておく
+        m_TaskQueues[m_RecordIndex].Execute();
+        m_RenderThread.Start(&MakeContextCurrent, Window::Get()->GetGLFWWindow());
+    }
+
+    void Renderer::StopRenderThread()
+    {
+        if (!m_RenderThread.IsRunning())
+            return;
+
+        // 記録途中のキューも実行してから停止する
+        m_RenderThread.Submit(&m_TaskQueues[m_RecordIndex]);
+        m_RenderThread.Stop();
     }
 
     void Renderer::EnableBlend(bool enable)
@@ -2,7 +2,11 @@
 
 #include "Core/SharedPointer.h"
 #include "Core/TaskQueue.h"
+#include "Core/MainThreadQueue.h"
 #include "Rendering/RenderDefine.h"
+#include "Rendering/RenderThread.h"
+
+#include <coroutine>
 
 
 namespace Silex
@@ -66,6 +70,22 @@ namespace Silex
         void EndFrame();
         void Resize(uint32 width, uint32 height);
 
+        // レンダースレッド（GL 関連の初期化が全て完了した後に開始し、終了処理の前に停止する）
+        void StartRenderThread();
+        void StopRenderThread();
+        bool IsRenderThreadRunning() const { return m_RenderThread.IsRunning(); }
+
+        // 記録済みのコマンドを全て実行し、完了を待つ（レンダースレッドが無い場合はこのスレッドで実行する）
+        void Flush();
+
+        // コマンドを記録して実行完了まで待つ（リサイズ・ピクセルの読み戻しなど、結果をすぐに使う場合のみ）
+        template<typename Func>
+        void EnqueueAndFlush(const char* commandName, Func&& command)
+        {
+            GetRenderTaskQueue().Enqueue(commandName, Traits::Forward<Func>(command));
+            Flush();
+        }
+
     public:
 
         void SetShaderTexture(uint32 slot, uint32 id);
@@ -93,8 +113,9 @@ namespace Silex
 
     public:
 
-        TaskQueue&             GetRenderTaskQueue()       { return m_TaskQueue;  }
-        const RHI::DeviceInfo& GetDeviceInfo()      const { return m_DeviceInfo; }
+        TaskQueue&             GetRenderTaskQueue()       { return m_TaskQueues[m_RecordIndex]; }
+        const RHI::DeviceInfo& GetDeviceInfo()      const { return m_DeviceInfo;                }
+        const RenderThread&    GetRenderThread()    const { return m_RenderThread;              }
 
         Shared<Mesh>& GetSphereMesh() { return  m_SphereMesh;}
         Shared<Mesh>& GetQuadMesh()   { return  m_QuadMesh;  }
@@ -106,7 +127,10 @@ namespace Silex
 
     private:
 
-        TaskQueue       m_TaskQueue;
+        // 記録用と実行用のダブルバッファ（レンダースレッドが無い場合は記録したフレーム内で実行する）
+        TaskQueue       m_TaskQueues[2];
+        uint32          m_RecordIndex = 0;
+        RenderThread    m_RenderThread;
         RHI::DeviceInfo m_DeviceInfo;
 
         Shared<Mesh>    m_SphereMesh;
@@ -124,4 +148,34 @@ namespace Silex
 
 
 #define SL_ENQUEUE_RENDER_COMMAND(debugCommandName, command) Renderer::Get()->GetRenderTaskQueue().Enqueue(debugCommandName, command);
+
+
+    //=========================================================================
+    // co_await SwitchToRenderThread() : 以降の処理を GL コンテキストのスレッドで再開する
+    //-------------------------------------------------------------------------
+    // レンダーキューに再開コマンドを記録するので、メインスレッドから呼び出すこと
+    // レンダースレッドが無い場合は、そのままメインスレッドで続行する
+    //=========================================================================
+    inline auto SwitchToRenderThread(const char* name = "Coroutine")
+    {
+        struct Awaiter
+        {
+            const char* name;
+
+            bool await_ready() const noexcept
+            {
+                return !Renderer::Get()->IsRenderThreadRunning();
+            }
+
+            void await_suspend(std::coroutine_handle<> handle) const
+            {
+                SL_ASSERT(MainThreadQueue::IsMainThread());
+                Renderer::Get()->GetRenderTaskQueue().Enqueue(name, [handle]() { handle.resume(); });
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        return Awaiter{ name };
+    }
 }
@@ -2,6 +2,7 @@
 #pragma once
 
 #include "Core/Core.h"
+#include "Rendering/RenderThread.h"
 
 #include <glad/glad.h>
 #include <iostream>
@@ -39,6 +40,8 @@ namespace Silex
             std::string rawCode = ReadShaderFile(filePath);
             std::unordered_map<GLenum, std::string> codes = SplitPerShaderStage(rawCode);
 
+            SL_ASSERT_GL_THREAD();
+
             m_ID = glCreateProgram();
 
             // シェーダーステージごとに 生成・コンパイル
@@ -190,6 +193,7 @@ namespace Silex
 
         void Bind() const
         {
+            SL_ASSERT_GL_THREAD();
             glUseProgram(m_ID);
         }
 
@@ -8,6 +8,8 @@
 
 namespace Silex
 {
+    struct TextureSourceData;
+
     //==================================================
     // テクスチャ 基底クラス
     //==================================================
@@ -39,6 +41,9 @@ namespace Silex
 
         static Texture2D*        Create(const RHI::TextureDesc& desc);
         static Shared<Texture2D> Create(const RHI::TextureDesc& desc, const std::string& path);
+
+        // デコード済みのデータから生成する（GL コンテキストのスレッドで呼び出すこと）
+        static Shared<Texture2D> Create(const RHI::TextureDesc& desc, const TextureSourceData& source);
     };
 
 
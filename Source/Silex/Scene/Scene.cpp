@@ -2,7 +2,8 @@
 #include "PCH.h"
 
 #include "Core/Random.h"
-#include "Core/Timer.h"
+#include "Core/Profiler.h"
+#include "Core/Parallel.h"
 #include "Scene/Scene.h"
 #include "Scene/SceneRenderer.h"
 #include "Scene/Entity.h"
@@ -64,6 +65,47 @@ namespace Silex
         return {};
     }
 
+    //============================================================================
+    // システムのアクセス対象（シーンレンダラーの状態）
+    //----------------------------------------------------------------------------
+    // 各システムはレンダラーの異なるメンバーに書き込むので、状態毎に分けて宣言し並列に実行できるようにする
+    //============================================================================
+    struct SkyLightState         {};
+    struct DirectionalLightState {};
+    struct RenderOptionState     {};
+    struct MeshDrawListState     {};
+
+
+    Scene::Scene()
+    {
+        // グループの初回生成は registry を変更するので、システムが並列に参照する前に生成しておく
+        registry.group<SkyLightComponent>(entt::get<TransformComponent, InstanceComponent>);
+        registry.group<DirectionalLightComponent>(entt::get<TransformComponent, InstanceComponent>);
+        registry.group<MeshComponent>(entt::get<TransformComponent, InstanceComponent>);
+        registry.group<PostProcessComponent>(entt::get<TransformComponent, InstanceComponent>);
+
+        RegisterSystems();
+    }
+
+    void Scene::RegisterSystems()
+    {
+        systemScheduler.AddSystem("System - SkyLight",
+            SystemAccess().Read<SkyLightComponent, InstanceComponent>().Write<SkyLightState>(),
+            [this](const SceneSystemContext& context) { UpdateSkyLight(context); });
+
+        systemScheduler.AddSystem("System - PostProcess",
+            SystemAccess().Read<PostProcessComponent, InstanceComponent>().Write<RenderOptionState>(),
+            [this](const SceneSystemContext& context) { UpdatePostProcess(context); });
+
+        systemScheduler.AddSystem("System - DirectionalLight",
+            SystemAccess().Read<TransformComponent, InstanceComponent>().Write<DirectionalLightComponent, DirectionalLightState>(),
+            [this](const SceneSystemContext& context) { UpdateDirectionalLight(context); });
+
+        systemScheduler.AddSystem("System - Mesh",
+            SystemAccess().Read<TransformComponent, MeshComponent, InstanceComponent>().Write<MeshDrawListState>(),
+            [this](const SceneSystemContext& context) { UpdateMeshes(context); });
+    }
+
     void Scene::Update(float deltaTime, Camera& camera, SceneRenderer* renderer)
     {
         // 描画データ更新
@@ -72,73 +114,103 @@ namespace Silex
         {
             SL_SCOPE_PROFILE("Update - Scene");
 
-            const auto& sky         = registry.group<SkyLightComponent>(entt::get<TransformComponent, InstanceComponent>);
-            const auto& directional = registry.group<DirectionalLightComponent>(entt::get<TransformComponent, InstanceComponent>);
-            const auto& meshes      = registry.group<MeshComponent>(entt::get<TransformComponent, InstanceComponent>);
-            const auto& postProcess = registry.group<PostProcessComponent>(entt::get<TransformComponent, InstanceComponent>);
+            SceneSystemContext context;
+            context.scene     = this;
+            context.renderer  = renderer;
+            context.camera    = &camera;
+            context.deltaTime = deltaTime;
 
-            // スカイライト
-            for (auto entity : sky)
+            systemScheduler.Execute(context);
+        }
+
+        // 描画パス実行
+        renderer->EndFrame();
+    }
+
+    void Scene::UpdateSkyLight(const SceneSystemContext& context)
+    {
+        const auto& sky = registry.group<SkyLightComponent>(entt::get<TransformComponent, InstanceComponent>);
+
+        for (auto entity : sky)
+        {
+            auto [sc, ic] = sky.get<SkyLightComponent, InstanceComponent>(entity);
+            if (ic.active)
             {
-                auto [sc, ic] = sky.get<SkyLightComponent, InstanceComponent>(entity);
-                if (ic.active)
-                {
-                    renderer->SetSkyLight(sc);
-                }
-
-                // 1つしか存在しないから、Unity/Environment ように別で管理する方が良いか？
-                break;
+                context.renderer->SetSkyLight(sc);
             }
 
-            // ポストプロセス
-            for (entt::entity entity : postProcess)
+            // 1つしか存在しないから、Unity/Environment ように別で管理する方が良いか？
+            break;
+        }
+    }
+
+    void Scene::UpdatePostProcess(const SceneSystemContext& context)
+    {
+        const auto& postProcess = registry.group<PostProcessComponent>(entt::get<TransformComponent, InstanceComponent>);
+
+        for (entt::entity entity : postProcess)
+        {
+            auto [pc, ic] = postProcess.get<PostProcessComponent, InstanceComponent>(entity);
+            if (ic.active)
+            {
+                auto& option = context.renderer->GetRenderOption();
+                option.postProcess = pc;
+            }
+
+            // 現状1つのみ受け付ける
+            break;
+        }
+    }
+
+    void Scene::UpdateDirectionalLight(const SceneSystemContext& context)
+    {
+        const auto& directional = registry.group<DirectionalLightComponent>(entt::get<TransformComponent, InstanceComponent>);
+
+        for (auto entity : directional)
+        {
+            // シーンレンダラーの平行光源リストへ追加（現状 1個のみ）
+            auto [tc, dc, ic] = directional.get<TransformComponent, DirectionalLightComponent, InstanceComponent>(entity);
+            if (ic.active)
             {
-                auto [pc, ic] = postProcess.get<PostProcessComponent, InstanceComponent>(entity);
-                if (ic.active)
-                {
-                    auto& option = renderer->GetRenderOption();
-                    option.postProcess = pc;
-                }
-
-                // 現状1つのみ受け付ける
-                break;
+                // (0, 0, 1)ベクトル を基準（0°）として回転させた値を適応
+                dc.direction = -glm::mat3(tc.GetTransform()) * glm::vec3(0.0f, 0.0f, 1.0f);
+                context.renderer->SetDirectionalLight(dc);
             }
 
-            // ディレクショナルライト
-            for (auto entity : directional)
+            // 現状1つのみ受け付ける
+            break;
+        }
+    }
+
+    void Scene::UpdateMeshes(const SceneSystemContext& context)
+    {
+        const auto& meshes = registry.group<MeshComponent>(entt::get<TransformComponent, InstanceComponent>);
+
+        // 変換行列の計算は並列に行い、描画リストへは元の順番で追加する
+        FrameVector<MeshDrawData> meshDrawData(meshes.size());
+
+        ParallelForEach(meshes, [&](uint64 index, entt::entity entity)
+        {
+            auto [tc, mc, ic] = meshes.get<TransformComponent, MeshComponent, InstanceComponent>(entity);
+
+            MeshDrawData& data = meshDrawData[index];
+            data.mesh = nullptr;
+
+            if (ic.active)
             {
-                // シーンレンダラーの平行光源リストへ追加（現状 1個のみ）
-                auto [tc, dc, ic] = directional.get<TransformComponent, DirectionalLightComponent, InstanceComponent>(entity);
-                if (ic.active)
-                {
-                    // (0, 0, 1)ベクトル を基準（0°）として回転させた値を適応
-                    dc.direction = -glm::mat3(tc.GetTransform()) * glm::vec3(0.0f, 0.0f, 1.0f);
-                    renderer->SetDirectionalLight(dc);
-                }
-
-                // 現状1つのみ受け付ける
-                break;
+                data.mesh      = &mc;
+                data.transform = tc.GetTransform();
+                data.entityID  = (int32)entity;
             }
+        }, 256);
 
-            // メッシュ
-            for (entt::entity entity : meshes)
+        for (const MeshDrawData& data : meshDrawData)
+        {
+            // シーンレンダラーの描画リストへ追加
+            if (data.mesh)
             {
-                auto [tc, mc, ic] = meshes.get<TransformComponent, MeshComponent, InstanceComponent>(entity);
-
-                if (ic.active)
-                {
-                    MeshDrawData data;
-                    data.mesh      = mc;
-                    data.transform = tc.GetTransform();
-                    data.entityID  = (int32)entity;
-
-                    // シーンレンダラーの描画リストへ追加
-                    renderer->AddMeshDrawList(data);
-                }
+                context.renderer->AddMeshDrawList(data);
             }
         }
-
-        // 描画パス実行
-        renderer->EndFrame();
     }
 }
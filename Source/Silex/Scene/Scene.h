@@ -4,6 +4,7 @@
 #include "Core/SharedPointer.h"
 #include "Rendering/Camera.h"
 #include "Scene/Components.h"
+#include "Scene/SceneSystem.h"
 #include <entt/entt.hpp>
 
 
@@ -13,11 +14,12 @@ namespace Silex
     class SceneRenderer;
     class Entity;
 
+    // コンポーネントはフレーム内で破棄されないので、コピーせずに参照する
     struct MeshDrawData
     {
-        MeshComponent mesh;
-        int32         entityID;
-        glm::mat4     transform;
+        const MeshComponent* mesh;
+        int32                entityID;
+        glm::mat4            transform;
     };
 
     class Scene : public Object
@@ -26,7 +28,7 @@ namespace Silex
 
     public:
 
-        Scene()  = default;
+        Scene();
         ~Scene() = default;
 
         Entity CreateEntity(const std::string& name = std::string(), bool active = true);
@@ -38,10 +40,23 @@ namespace Silex
 
         void Update(float deltaTime, Camera& camera, SceneRenderer* renderer);
 
+        const SceneSystemScheduler& GetSystemScheduler() const { return systemScheduler; }
+
+    private:
+
+        void RegisterSystems();
+
+        // システム（SceneSystemScheduler で並列に実行する）
+        void UpdateSkyLight(const SceneSystemContext& context);
+        void UpdatePostProcess(const SceneSystemContext& context);
+        void UpdateDirectionalLight(const SceneSystemContext& context);
+        void UpdateMeshes(const SceneSystemContext& context);
+
     private:
 
         entt::registry                           registry;
         std::unordered_map<uint64, entt::entity> entityMap;
+        SceneSystemScheduler                     systemScheduler;
 
     private:
 
@@ -2,7 +2,8 @@
 #include "PCH.h"
 
 #include "Asset/Asset.h"
-#include "Core/Timer.h"
+#include "Core/Profiler.h"
+#include "Core/Metrics.h"
 #include "Core/Engine.h"
 #include "Editor/EditorSplashImage.h"
 #include "Rendering/Framebuffer.h"
@@ -21,10 +22,86 @@
 
 namespace Silex
 {
+    static MetricID geometryDrawCallMetric = Metrics::invalidMetric;
+    static MetricID shadowDrawCallMetric   = Metrics::invalidMetric;
+    static MetricID instanceMetric         = Metrics::invalidMetric;
+    static MetricID meshMetric             = Metrics::invalidMetric;
+
+    // 読み込み済みの全メッシュソースの頂点数（メッシュ毎のリストをたどらず、専用プールを走査する）
+    static int64 SampleResidentVertices()
+    {
+        int64 numVertices = 0;
+        ObjectPool<MeshSource>::Get().ForEach([&](MeshSource& source)
+        {
+            numVertices += source.GetVertexCount();
+        });
+
+        return numVertices;
+    }
+
+
+    //==================================================================
+    // フレームアリーナ上のコンテナを空の状態で作り直す
+    //------------------------------------------------------------------
+    // clear() ではバケット配列などが前フレームのアリーナに残り、デストラクタも
+    // 再利用済みのメモリに触れる可能性があるので、破棄せずに上書きで構築する
+    // (要素はアリーナ外のリソースを保持しないので、リークは発生しない)
+    //==================================================================
+    static void ResetFrameData(SceneFrameData& frame)
+    {
+        Memory::Construct<FrameVector<MeshDrawData>>(&frame.meshDrawList);
+
+        // シャドウインスタンスデータ
+        Memory::Construct<FrameHashMap<InstancingUnitID, InstancingUnitData>>(&frame.shadowDrawData);
+        Memory::Construct<FrameHashMap<InstancingUnitID, InstancingUnitParameter>>(&frame.ShadowParameterData);
+
+        // メッシュインスタンスデータ
+        Memory::Construct<FrameHashMap<InstancingUnitID, InstancingUnitData>>(&frame.meshDrawData);
+        Memory::Construct<FrameHashMap<InstancingUnitID, InstancingUnitParameter>>(&frame.meshParameterData);
+
+        frame.shadowParameters    = nullptr;
+        frame.numShadowParameters = 0;
+        frame.meshParameters      = nullptr;
+        frame.numMeshParameters   = 0;
+    }
+
+    // インスタンスごとの描画データを、シェーダーで扱うデータに整列する
+    static MeshParameter* AlignMeshParameters(FrameHashMap<InstancingUnitID, InstancingUnitParameter>& parameterData, uint32& numParameters)
+    {
+        numParameters = 0;
+        for (auto& [id, param] : parameterData)
+        {
+            numParameters += param.parameters.size();
+        }
+
+        MeshParameter* parameters = (MeshParameter*)FrameArena::Allocate(numParameters * sizeof(MeshParameter), alignof(MeshParameter));
+
+        uint32 offset = 0;
+        for (auto& [id, param] : parameterData)
+        {
+            param.offset = offset;
+            for (const auto& param : param.parameters)
+            {
+                parameters[offset] = param;
+                offset++;
+            }
+        }
+
+        return parameters;
+    }
+
+
     void SceneRenderer::Init()
     {
         context = Memory::Allocate<SceneRenderingContext>();
 
+        // 全シーンレンダラーの合計（同名の登録は同じ ID を返す）
+        geometryDrawCallMetric = Metrics::RegisterCounter("Render/GeometryDrawCall");
+        shadowDrawCallMetric   = Metrics::RegisterCounter("Render/ShadowDrawCall");
+        instanceMetric         = Metrics::RegisterCounter("Render/Instances");
+        meshMetric             = Metrics::RegisterCounter("Render/Mesh");
+        Metrics::RegisterGauge("Render/ResidentVertices", SampleResidentVertices);
+
         //============================================
         // シェーダー
         //============================================
@@ -205,20 +282,21 @@ namespace Silex
         //============================================
         // インスタンシング用トランスフォーム
         //============================================
-        context->meshParameters   = new MeshParameter[context->numMaxInstancing];
         context->meshParameterSBO = StorageBuffer::Create(context->numMaxInstancing * sizeof(MeshParameter), 0, nullptr);
     }
 
     void SceneRenderer::Shutdown()
     {
-        delete[] context->meshParameters;
-
         for (int i = 0; i < context->bloomTextures.size(); i++)
         {
             Memory::Deallocate(context->bloomTextures[i]);
         }
 
         Memory::Deallocate(context->preDownSamplingTexture);
+
+        // 最後に描画したフレームのアリーナは再利用されている可能性があるので、破棄前に作り直す
+        ResetFrameData(context->frames[0]);
+        ResetFrameData(context->frames[1]);
         Memory::Deallocate(context);
     }
 
@@ -228,184 +306,280 @@ namespace Silex
         context->renderScene = scene;
         context->sceneCamera = camera;
 
+        // 2フレーム前に記録したデータは、前フレームの Submit（フェンス）で実行完了している
+        context->recordIndex ^= 1;
+        SceneFrameData& frame = context->frames[context->recordIndex];
+
         // 統計をリセット
-        context->stats.numRenderMesh       = 0;
-        context->stats.numGeometryDrawCall = 0;
-        context->stats.numShadowDrawCall   = 0;
+        frame.stats.numRenderMesh       = 0;
+        frame.stats.numGeometryDrawCall = 0;
+        frame.stats.numShadowDrawCall   = 0;
 
         // ステートをリセット
-        context->shouldRenderShadow   = false;
-        context->shouldRenderGeometry = false;
+        frame.shouldRenderShadow   = false;
+        frame.shouldRenderGeometry = false;
 
         // ポストプロセスのクリア
-        context->option.postProcess = {};
+        frame.option.postProcess = {};
 
         // ライトのリセット
-        context->skyLight.enableIBL = false;
-        context->skyLight.renderSky = false;
-        context->directionalLight = {};
+        frame.skyLight.enableIBL = false;
+        frame.skyLight.renderSky = false;
+        frame.directionalLight = {};
 
-        // 描画リストリセット
-        context->meshDrawList.clear();
+        // 描画リスト・インスタンスデータのリセット
+        ResetFrameData(frame);
+    }
 
-        // シャドウインスタンスデータクリア
-        context->shadowDrawData.clear();
-        context->ShadowParameterData.clear();
+    void SceneRenderer::EndFrame()
+    {
+        SceneFrameData* frame = &context->frames[context->recordIndex];
+        frame->camera = *context->sceneCamera;
 
-        // メッシュインスタンスデータクリア
-        context->meshDrawData.clear();
-        context->meshParameterData.clear();
+        // コンポーネントを参照する処理はここで済ませ、描画パスには記録したデータだけを渡す
+        BuildShadowInstancing(*frame);
+        BuildGeometryInstancing(*frame);
+
+        if (Renderer::Get()->IsRenderThreadRunning())
+        {
+            // キャプチャのカンマがマクロ引数の区切りになるので、直接キューに積む
+            Renderer::Get()->GetRenderTaskQueue().Enqueue("SceneRenderer", [this, frame]() { ExecutePasses(*frame); });
+        }
+        else
+        {
+            ExecutePasses(*frame);
+        }
     }
 
-    void SceneRenderer::EndFrame()
+    void SceneRenderer::ExecutePasses(const SceneFrameData& frame)
     {
-        ShadowMapPass();
-        GeometryPass();
+        ShadowMapPass(frame);
+        GeometryPass(frame);
 
-        DeferredLightinglPass();
-      //ForwardLightinglPass();
+        DeferredLightinglPass(frame);
+      //ForwardLightinglPass(frame);
 
-        SkyboxPass();
-        PostProcessPass();
+        SkyboxPass(frame);
+        PostProcessPass(frame);
     }
 
     void SceneRenderer::SetSkyLight(const SkyLightComponent& data)
     {
-        context->skyLight = data;
+        context->frames[context->recordIndex].skyLight = data;
     }
 
     void SceneRenderer::SetDirectionalLight(const DirectionalLightComponent& data)
     {
-        context->directionalLight = data;
-        context->shouldRenderShadow = true;
+        SceneFrameData& frame = context->frames[context->recordIndex];
+        frame.directionalLight   = data;
+        frame.shouldRenderShadow = true;
     }
 
     void SceneRenderer::AddMeshDrawList(const MeshDrawData& data)
     {
-        context->meshDrawList.emplace_back(data);
-        context->shouldRenderGeometry = true;
-        context->stats.numRenderMesh++;
+        SceneFrameData& frame = context->frames[context->recordIndex];
+        frame.meshDrawList.emplace_back(data);
+        frame.shouldRenderGeometry = true;
+        frame.stats.numRenderMesh++;
+
+        Metrics::Increment(meshMetric);
     }
 
     void SceneRenderer::SetViewportSize(uint32 width, uint32 height)
     {
+        // viewportSize とフレームバッファは GL スレッドでのみ書き換え、完了を待つので、以降はメインスレッドから新しい ID を参照できる
         if (context->viewportSize.x != width || context->viewportSize.y != height)
         {
-            context->viewportSize.x = width;
-            context->viewportSize.y = height;
+            Renderer::Get()->EnqueueAndFlush("SceneRenderer Resize", [this, width, height]() { ResizeFramebuffers(width, height); });
+        }
+    }
 
-            // フレームバッファのリサイズ
-            context->gBufferFB->Resize(width, height);
-            context->deferredFB->Resize(width, height);
-            context->finalPassFB->Resize(width, height);
-            context->temporaryFB->Resize(width, height);
+    void SceneRenderer::ResizeFramebuffers(uint32 width, uint32 height)
+    {
+        context->viewportSize.x = width;
+        context->viewportSize.y = height;
 
-            // ブルームサンプリングテクスチャ
-            {
-                // テクスチャのリサイズ
-                RHI::TextureDesc bloomTextureDesc = {};
-                bloomTextureDesc.Format = RHI::RenderFormat::RGBA16F;
-                bloomTextureDesc.Type   = RHI::TextureType::Texture2D;
-                bloomTextureDesc.Filter = RHI::TextureFilter::Linear;
-                bloomTextureDesc.Wrap   = RHI::TextureWrap::ClampEdge;
-                bloomTextureDesc.Size   = 1;
+        // フレームバッファのリサイズ
+        context->gBufferFB->Resize(width, height);
+        context->deferredFB->Resize(width, height);
+        context->finalPassFB->Resize(width, height);
+        context->temporaryFB->Resize(width, height);
 
-                context->bloomResolutions = CalculateBloomMipSize(width, height);
+        // ブルームサンプリングテクスチャ
+        {
+            // テクスチャのリサイズ
+            RHI::TextureDesc bloomTextureDesc = {};
+            bloomTextureDesc.Format = RHI::RenderFormat::RGBA16F;
+            bloomTextureDesc.Type   = RHI::TextureType::Texture2D;
+            bloomTextureDesc.Filter = RHI::TextureFilter::Linear;
+            bloomTextureDesc.Wrap   = RHI::TextureWrap::ClampEdge;
+            bloomTextureDesc.Size   = 1;
 
-                for (int i = 0; i < context->bloomResolutions.size(); i++)
-                {
-                    Memory::Deallocate(context->bloomTextures[i]);
+            context->bloomResolutions = CalculateBloomMipSize(width, height);
 
-                    bloomTextureDesc.Width     = context->bloomResolutions[i].x;
-                    bloomTextureDesc.Height    = context->bloomResolutions[i].y;
-                    context->bloomTextures[i] = Texture2D::Create(bloomTextureDesc);
-                }
+            for (int i = 0; i < context->bloomResolutions.size(); i++)
+            {
+                Memory::Deallocate(context->bloomTextures[i]);
 
-                Memory::Deallocate(context->preDownSamplingTexture);
-                bloomTextureDesc.Width  = width;
-                bloomTextureDesc.Height = height;
-                context->preDownSamplingTexture = Texture2D::Create(bloomTextureDesc);
+                bloomTextureDesc.Width     = context->bloomResolutions[i].x;
+                bloomTextureDesc.Height    = context->bloomResolutions[i].y;
+                context->bloomTextures[i] = Texture2D::Create(bloomTextureDesc);
             }
+
+            Memory::Deallocate(context->preDownSamplingTexture);
+            bloomTextureDesc.Width  = width;
+            bloomTextureDesc.Height = height;
+            context->preDownSamplingTexture = Texture2D::Create(bloomTextureDesc);
         }
     }
 
 
     //==================================
-    // シャドウマップパス
+    // インスタンシングデータ構築
     //==================================
-    void SceneRenderer::ShadowMapPass()
+    void SceneRenderer::BuildShadowInstancing(SceneFrameData& frame)
     {
-        context->shadowMapFB->Bind();
-        context->shadowMapFB->Clear();
+        if (!frame.shouldRenderShadow || !frame.shouldRenderGeometry || frame.stats.numRenderMesh == 0)
+            return;
 
-        if (context->shouldRenderShadow && context->shouldRenderGeometry && context->stats.numRenderMesh > 0)
-        {
-            SL_SCOPE_PROFILE("ShadowPass");
+        SL_SCOPE_PROFILE("Build ShadowInstancing");
 
-            context->shadowShader->Bind();
+        // カスケードデータ
+        frame.lightMatrices = GetLightSpaceMatrices(frame.directionalLight.direction, frame.camera);
 
-            // カスケードデータ
-            const std::array<glm::mat4, context->numCascadeLevel> lightMatrices = GetLightSpaceMatrices(context->directionalLight.direction, *context->sceneCamera);
-            context->cascadeUBO->SetData(0, sizeof(glm::mat4) * 4, &lightMatrices[0]);
-
-            // 描画リストに積まれたメッシュを描画
-            for (auto& data : context->meshDrawList)
+        // 描画リストに積まれたメッシュを描画
+        for (auto& data : frame.meshDrawList)
+        {
+            const Shared<Mesh>& mesh = data.mesh->mesh;
+            if (mesh && data.mesh->castShadow)
             {
-                Shared<Mesh> mesh = data.mesh.mesh;
-                if (mesh && data.mesh.castShadow)
+                uint32 sourceIndex = 0;
+                for (MeshSource* meshSource : mesh->GetMeshSources())
                 {
-                    uint32 sourceIndex = 0;
-                    for (MeshSource* meshSource : mesh->GetMeshSources())
-                    {
-                        // メッシュのアセットIDから新規・既存メッシュを判定する
-                        InstancingUnitID unit = { mesh->GetAssetID(), sourceIndex, (AssetID)0 };
-
-                        // インスタンスユニットごとのトランスフォームデータ
-                        glm::mat4 ts = data.transform * meshSource->GetTransform();
-                        auto& param = context->ShadowParameterData[unit].parameters.emplace_back();
-                        param.transform = ts;
-
-                        // インスタンスユニットごとの描画データ
-                        InstancingUnitData& unitdata = context->shadowDrawData[unit];
-                        unitdata.instanceCount++;
-                        unitdata.indexCount  = meshSource->HasIndex() ? meshSource->GetIndexCount() : 0;
-                        unitdata.vertexCount = meshSource->GetVertexCount();
-                        unitdata.meshAsset   = mesh.Get();
-                        unitdata.source      = meshSource;
-                        unitdata.material    = nullptr;
-
-                        sourceIndex++;
-                    }
+                    // メッシュのアセットIDから新規・既存メッシュを判定する
+                    InstancingUnitID unit = { mesh->GetAssetID(), sourceIndex, (AssetID)0 };
+
+                    // インスタンスユニットごとのトランスフォームデータ
+                    glm::mat4 ts = data.transform * meshSource->GetTransform();
+                    auto& param = frame.ShadowParameterData[unit].parameters.emplace_back();
+                    param.transform = ts;
+
+                    // インスタンスユニットごとの描画データ
+                    InstancingUnitData& unitdata = frame.shadowDrawData[unit];
+                    unitdata.instanceCount++;
+                    unitdata.indexCount  = meshSource->HasIndex() ? meshSource->GetIndexCount() : 0;
+                    unitdata.vertexCount = meshSource->GetVertexCount();
+                    unitdata.meshAsset   = mesh.Get();
+                    unitdata.source      = meshSource;
+
+                    sourceIndex++;
                 }
             }
+        }
+
+        frame.shadowParameters        = AlignMeshParameters(frame.ShadowParameterData, frame.numShadowParameters);
+        frame.stats.numShadowDrawCall = frame.shadowDrawData.size();
+
+        Metrics::Increment(shadowDrawCallMetric, frame.shadowDrawData.size());
+    }
+
+    void SceneRenderer::BuildGeometryInstancing(SceneFrameData& frame)
+    {
+        if (!frame.shouldRenderGeometry)
+            return;
+
+        SL_SCOPE_PROFILE("Calculate MeshParameter");
 
-            // インスタンスごとの描画データをシェーダーで扱うデータに整列する
-            uint32 offset = 0;
-            for (auto& [id, param] : context->ShadowParameterData)
+        for (auto& data : frame.meshDrawList)
+        {
+            const Shared<Mesh>& mesh          = data.mesh->mesh;
+            const auto&         materialTable = data.mesh->materials;
+
+            if (mesh)
             {
-                param.offset = offset;
-                for (const auto& param : param.parameters)
+                uint32 sourceIndex = 0;
+                for (MeshSource* meshSource : mesh->GetMeshSources())
                 {
-                    context->meshParameters[offset].transform = param.transform;
-                    offset++;
+                    glm::mat4 ts       = data.transform * meshSource->GetTransform();
+                    Material* material = materialTable[meshSource->GetMaterialIndex()].Get();
+
+                    if (!material)
+                        material = Renderer::Get()->GetDefaultMaterial().Get();
+
+                    // メッシュのアセットIDから新規・既存メッシュを判定する
+                    InstancingUnitID unit = { mesh->GetAssetID(), sourceIndex, material->GetAssetID() };
+
+                    // インスタンス毎のデータ
+                    auto& param        = frame.meshParameterData[unit].parameters.emplace_back();
+                    param.transform    = ts;
+                    param.normalMatrix = glm::mat4(glm::transpose(glm::inverse(glm::mat3(ts))));
+                    param.pixelID[0]   = data.entityID;
+                    param.pixelID[1]   = material->ShadingModel;
+
+                    // メッシュ毎の描画データ
+                    InstancingUnitData& unitdata = frame.meshDrawData[unit];
+                    unitdata.instanceCount++;
+                    unitdata.indexCount  = meshSource->HasIndex() ? meshSource->GetIndexCount() : 0;
+                    unitdata.vertexCount = meshSource->GetVertexCount();
+                    unitdata.meshAsset   = mesh.Get();
+                    unitdata.source      = meshSource;
+
+                    unitdata.material.albedo        = material->Albedo;
+                    unitdata.material.emission      = material->Emission;
+                    unitdata.material.metallic      = material->Metallic;
+                    unitdata.material.roughness     = material->Roughness;
+                    unitdata.material.textureTiling = material->TextureTiling;
+                    unitdata.albedoMapID            = material->AlbedoMap ? material->AlbedoMap->GetID() : 1;
+
+                    sourceIndex++;
                 }
             }
+        }
+
+        frame.meshParameters            = AlignMeshParameters(frame.meshParameterData, frame.numMeshParameters);
+        frame.stats.numGeometryDrawCall = frame.meshDrawData.size();
+
+        uint64 numInstances = 0;
+        for (auto& [id, data] : frame.meshDrawData)
+        {
+            numInstances += data.instanceCount;
+        }
+
+        Metrics::Increment(geometryDrawCallMetric, frame.meshDrawData.size());
+        Metrics::Increment(instanceMetric, numInstances);
+    }
+
+
+    //==================================
+    // シャドウマップパス
+    //==================================
+    void SceneRenderer::ShadowMapPass(const SceneFrameData& frame)
+    {
+        context->shadowMapFB->Bind();
+        context->shadowMapFB->Clear();
+
+        if (frame.shouldRenderShadow && frame.shouldRenderGeometry && frame.stats.numRenderMesh > 0)
+        {
+            SL_SCOPE_PROFILE("ShadowPass");
+
+            context->shadowShader->Bind();
+
+            // カスケードデータ
+            context->cascadeUBO->SetData(0, sizeof(glm::mat4) * 4, &frame.lightMatrices[0]);
 
             // 全データを転送
-            context->meshParameterSBO->SetData(0, sizeof(MeshParameter) * offset, context->meshParameters);
+            context->meshParameterSBO->SetData(0, sizeof(MeshParameter) * frame.numShadowParameters, frame.shadowParameters);
 
             glPolygonOffset(2, 0);
 
             // インスタンシング描画
-            for (auto& [id, data] : context->shadowDrawData)
+            for (auto& [id, data] : frame.shadowDrawData)
             {
                 // ストレージバッファデータのインスタンスオフセットを指定する
-                context->shadowShader->Set("instanceOffset", context->ShadowParameterData[id].offset);
+                context->shadowShader->Set("instanceOffset", frame.ShadowParameterData.at(id).offset);
 
                 data.source->Bind();
                 Renderer::Get()->DrawIndexedInstance(data.meshAsset->GetPrimitiveType(), data.indexCount, data.instanceCount);
-
-                context->stats.numShadowDrawCall++;
             }
 
             glPolygonOffset(0, 0);
@@ -415,7 +589,7 @@ namespace Silex
     //==================================
     // Gバッファーパス
     //==================================
-    void SceneRenderer::GeometryPass()
+    void SceneRenderer::GeometryPass(const SceneFrameData& frame)
     {
         context->gBufferFB->Bind();
         context->gBufferFB->Clear();
@@ -423,110 +597,40 @@ namespace Silex
 
         Renderer::Get()->SetStencilFunc(RHI::StrencilOp::Always, 1, 0xFF);
         
-        if (context->shouldRenderGeometry)
+        if (frame.shouldRenderGeometry)
         {
             SL_SCOPE_PROFILE("GBufferPass");
 
-            uint32 offset = 0;
-
-            {
-                SL_SCOPE_PROFILE("Calculate MeshParameter");
-
-                for (auto& data : context->meshDrawList)
-                {
-                    Shared<Mesh> mesh   = data.mesh.mesh;
-                    auto& materialTable = data.mesh.materials;
-
-                    if (mesh)
-                    {
-                        uint32 sourceIndex = 0;
-                        for (MeshSource* meshSource : mesh->GetMeshSources())
-                        {
-                            glm::mat4 ts   = data.transform * meshSource->GetTransform();
-                            auto& material = materialTable[meshSource->GetMaterialIndex()];
-
-                            if (!material)
-                                material = Renderer::Get()->GetDefaultMaterial();
-
-                            // メッシュのアセットIDから新規・既存メッシュを判定する
-                            InstancingUnitID unit = { mesh->GetAssetID(), sourceIndex, material->GetAssetID() };
-
-                            // インスタンス毎のデータ
-                            auto& param        = context->meshParameterData[unit].parameters.emplace_back();
-                            param.transform    = ts;
-                            param.normalMatrix = glm::mat4(glm::transpose(glm::inverse(glm::mat3(ts))));
-                            param.pixelID[0]   = data.entityID;
-                            param.pixelID[1]   = material->ShadingModel;
-
-                            // メッシュ毎の描画データ
-                            InstancingUnitData& unitdata = context->meshDrawData[unit];
-                            unitdata.instanceCount++;
-                            unitdata.indexCount  = meshSource->HasIndex() ? meshSource->GetIndexCount() : 0;
-                            unitdata.vertexCount = meshSource->GetVertexCount();
-                            unitdata.meshAsset   = mesh.Get();
-                            unitdata.material    = material.Get();
-                            unitdata.source      = meshSource;
-
-                            sourceIndex++;
-                        }
-                    }
-                }
-
-                // インスタンスごとの描画データをシェーダーで扱うデータに整列する
-                for (auto& [id, param] : context->meshParameterData)
-                {
-                    param.offset = offset;
-                    for (const auto& param : param.parameters)
-                    {
-                        context->meshParameters[offset].transform    = param.transform;
-                        context->meshParameters[offset].pixelID.x    = param.pixelID.x;
-                        context->meshParameters[offset].pixelID.y    = param.pixelID.y;
-                        context->meshParameters[offset].normalMatrix = param.normalMatrix;
-                        offset++;
-                    }
-                }
-            }
-
             // 全データを転送
-            context->meshParameterSBO->SetData(0, sizeof(MeshParameter) * offset, context->meshParameters);
+            context->meshParameterSBO->SetData(0, sizeof(MeshParameter) * frame.numMeshParameters, frame.meshParameters);
 
             // 座標変換 uniform
             context->gBufferShader->Bind();
-            context->gBufferShader->Set("projection", context->sceneCamera->GetProjectionMatrix());
-            context->gBufferShader->Set("view",       context->sceneCamera->GetViewMatrix());
+            context->gBufferShader->Set("projection", frame.camera.GetProjectionMatrix());
+            context->gBufferShader->Set("view",       frame.camera.GetViewMatrix());
             context->gBufferShader->Set("albedoMap",  0);
 
             // インスタンシング描画
-            for (auto& [id, data] : context->meshDrawData)
+            for (auto& [id, data] : frame.meshDrawData)
             {
                 const auto& material = data.material;
 
                 // ストレージバッファデータのインスタンスオフセットを指定する
-                context->gBufferShader->Set("instanceOffset", context->meshParameterData[id].offset);
+                context->gBufferShader->Set("instanceOffset", frame.meshParameterData.at(id).offset);
 #if 1
-                context->gBufferShader->Set("albedo",        material->Albedo);
-                context->gBufferShader->Set("emission",      material->Emission);
-                context->gBufferShader->Set("metallic",      material->Metallic);
-                context->gBufferShader->Set("roughness",     material->Roughness);
-                context->gBufferShader->Set("textureTiling", material->TextureTiling);
+                context->gBufferShader->Set("albedo",        material.albedo);
+                context->gBufferShader->Set("emission",      material.emission);
+                context->gBufferShader->Set("metallic",      material.metallic);
+                context->gBufferShader->Set("roughness",     material.roughness);
+                context->gBufferShader->Set("textureTiling", material.textureTiling);
 #else
-                MaterialUBO ubo;
-                ubo.albedo        = material->albedo;
-                ubo.emission      = material->emission;
-                ubo.metallic      = material->metallic;
-                ubo.roughness     = material->roughness;
-                ubo.textureTiling = material->textureTiling;
-
-                m_Context->MaterialUBO->SetData(0, sizeof(MaterialUBO), &ubo);
+                context->materialUBO->SetData(0, sizeof(MaterialUBO), &material);
 #endif
 
-                uint32 albedoID = material->AlbedoMap ? material->AlbedoMap->GetID() : 1;
-                Renderer::Get()->SetShaderTexture(0, albedoID);
+                Renderer::Get()->SetShaderTexture(0, data.albedoMapID);
 
                 data.source->Bind();
                 Renderer::Get()->DrawIndexedInstance(data.meshAsset->GetPrimitiveType(), data.indexCount, data.instanceCount);
-
-                context->stats.numGeometryDrawCall++;
             }
         }
     }
@@ -534,7 +638,7 @@ namespace Silex
     //==================================
     // ライティングパス
     //==================================
-    void SceneRenderer::DeferredLightinglPass()
+    void SceneRenderer::DeferredLightinglPass(const SceneFrameData& frame)
     {
         context->deferredFB->Bind();
         context->deferredFB->Clear();
@@ -546,24 +650,24 @@ namespace Silex
         Renderer::Get()->SetStencilFunc(RHI::StrencilOp::Equal, 1, 0xFF);
 
         // ジオメトリ
-        if (context->shouldRenderGeometry)
+        if (frame.shouldRenderGeometry)
         {
             SL_SCOPE_PROFILE("DeferredLightingPass");
 
             // ライティング情報
             int32 numCascades = context->shadowCascadeLevels.size();
             context->deferredLightingShader->Bind();
-            context->deferredLightingShader->Set("view",                  context->sceneCamera->GetViewMatrix());
-            context->deferredLightingShader->Set("camPos",                context->sceneCamera->GetPosition());
-            context->deferredLightingShader->Set("lightDir",              context->directionalLight.direction);
-            context->deferredLightingShader->Set("lightColor",            context->directionalLight.color * context->directionalLight.intencity * context->intencityMultiplication);
-            context->deferredLightingShader->Set("shadowDepthBias",       context->directionalLight.shadowDepthBias);
-            context->deferredLightingShader->Set("enableSoftShadow",      context->directionalLight.enableSoftShadow);
-            context->deferredLightingShader->Set("farPlane",              context->sceneCamera->GetFarPlane());
+            context->deferredLightingShader->Set("view",                  frame.camera.GetViewMatrix());
+            context->deferredLightingShader->Set("camPos",                frame.camera.GetPosition());
+            context->deferredLightingShader->Set("lightDir",              frame.directionalLight.direction);
+            context->deferredLightingShader->Set("lightColor",            frame.directionalLight.color * frame.directionalLight.intencity * context->intencityMultiplication);
+            context->deferredLightingShader->Set("shadowDepthBias",       frame.directionalLight.shadowDepthBias);
+            context->deferredLightingShader->Set("enableSoftShadow",      frame.directionalLight.enableSoftShadow);
+            context->deferredLightingShader->Set("farPlane",              frame.camera.GetFarPlane());
             context->deferredLightingShader->Set("cascadeCount",          numCascades);
-            context->deferredLightingShader->Set("showCascade",           context->directionalLight.showCascade);
+            context->deferredLightingShader->Set("showCascade",           frame.directionalLight.showCascade);
             context->deferredLightingShader->Set("cascadePlaneDistances", context->shadowCascadeLevels.data(), numCascades);
-            context->deferredLightingShader->Set("iblIntencity",          context->skyLight.intencity);
+            context->deferredLightingShader->Set("iblIntencity",          frame.skyLight.intencity);
 
             // Gバッファのカラー情報をバインド
             context->deferredLightingShader->Set("irradianceMap",    0); // irradiance
@@ -576,11 +680,11 @@ namespace Silex
             context->deferredLightingShader->Set("emissionMap",      7); // エミッション
             context->deferredLightingShader->Set("idMap",            8); // マテリアルID
 
-            if (context->skyLight.enableIBL && context->skyLight.sky)
+            if (frame.skyLight.enableIBL && frame.skyLight.sky)
             {
-                Renderer::Get()->SetShaderTexture(0, context->skyLight.sky->GetIrradianceMap());
-                Renderer::Get()->SetShaderTexture(1, context->skyLight.sky->GetPrefilterMap());
-                Renderer::Get()->SetShaderTexture(2, context->skyLight.sky->GetBRDF());
+                Renderer::Get()->SetShaderTexture(0, frame.skyLight.sky->GetIrradianceMap());
+                Renderer::Get()->SetShaderTexture(1, frame.skyLight.sky->GetPrefilterMap());
+                Renderer::Get()->SetShaderTexture(2, frame.skyLight.sky->GetBRDF());
             }
             else
             {
@@ -603,24 +707,24 @@ namespace Silex
     //==================================
     // スカイボックス
     //==================================
-    void SceneRenderer::SkyboxPass()
+    void SceneRenderer::SkyboxPass(const SceneFrameData& frame)
     {
         // ステンシル値が0の場所にのみ描画を許可
         Renderer::Get()->SetStencilFunc(RHI::StrencilOp::Equal, 0, 0xFF);
 
         // スカイボックスパス
-        if (context->skyLight.renderSky)
+        if (frame.skyLight.renderSky)
         {
             SL_SCOPE_PROFILE("SkyboxPass");
 
             Renderer::Get()->SetCullFace(RHI::CullFace::Front);
 
             context->skyShader->Bind();
-            context->skyShader->Set("view",           glm::mat4(glm::mat3(context->sceneCamera->GetViewMatrix())));
-            context->skyShader->Set("projection",     context->sceneCamera->GetProjectionMatrix());
+            context->skyShader->Set("view",           glm::mat4(glm::mat3(frame.camera.GetViewMatrix())));
+            context->skyShader->Set("projection",     frame.camera.GetProjectionMatrix());
             context->skyShader->Set("environmentMap", 0);
 
-            Renderer::Get()->SetShaderTexture(0, context->skyLight.sky ? context->skyLight.sky->GetCubeMap() : 0);
+            Renderer::Get()->SetShaderTexture(0, frame.skyLight.sky ? frame.skyLight.sky->GetCubeMap() : 0);
             Renderer::Get()->DrawCube();
 
             Renderer::Get()->SetCullFace(RHI::CullFace::Back);
@@ -630,7 +734,7 @@ namespace Silex
     //==================================
     // フォワードパス
     //==================================
-    void SceneRenderer::ForwardLightinglPass()
+    void SceneRenderer::ForwardLightinglPass(const SceneFrameData& frame)
     {
 
     }
@@ -638,18 +742,18 @@ namespace Silex
     //==================================
     // ポストプロセス
     //==================================
-    void SceneRenderer::PostProcessPass()
+    void SceneRenderer::PostProcessPass(const SceneFrameData& frame)
     {
         if (context->enablePostProcess)
         {
             Renderer::Get()->BlitFramebuffer(context->deferredFB, context->temporaryFB, RHI::AttachmentBuffer::Color);
             Renderer::Get()->BlitFramebuffer(context->deferredFB, context->finalPassFB, RHI::AttachmentBuffer::Color);
 
-            SceneRenderOption option = context->option;
+            const SceneRenderOption& option = frame.option;
 
             // Outline
             if (option.postProcess.enableOutline)
-                OutlinePass();
+                OutlinePass(option);
 
             // 色縮差
             if (option.postProcess.enableChromaticAberration)
@@ -657,7 +761,7 @@ namespace Silex
 
             // ブルーム
             if (option.postProcess.enableBloom)
-                BloomPass();
+                BloomPass(option);
 
             // FXAA
             if (option.postProcess.enableFXAA)
@@ -665,23 +769,22 @@ namespace Silex
 
             // トーンマッピング
             if (option.postProcess.enableTonemap)
-                TonemapPass();
+                TonemapPass(option);
         }
     }
 
     //==================================
     // ブルームパス
     //==================================
-    void SceneRenderer::BloomPass()
+    void SceneRenderer::BloomPass(const SceneRenderOption& option)
     {
         SL_SCOPE_PROFILE("BloomPass");
 
-        SceneRenderOption option = context->option;
         context->bloomFB->Bind();
         context->bloomFB->Clear();
 
         // プリフィルター（明度のしきい値を適応）
-        BloomPreFiltering();
+        BloomPreFiltering(option);
 
         // ダウンサンプリング
         BloomDownSampling();
@@ -703,10 +806,8 @@ namespace Silex
         Renderer::Get()->BlitFramebuffer(context->finalPassFB, context->temporaryFB, RHI::AttachmentBuffer::Color);
     }
 
-    void SceneRenderer::BloomPreFiltering()
+    void SceneRenderer::BloomPreFiltering(const SceneRenderOption& option)
     {
-        SceneRenderOption option = context->option;
-
         // シェーダー
         context->preDownSamplingShader->Bind();
         context->preDownSamplingShader->Set("threshold", option.postProcess.bloomThreshold);
@@ -791,11 +892,10 @@ namespace Silex
     //==================================
     //　アウトラインパス
     //==================================
-    void SceneRenderer::OutlinePass()
+    void SceneRenderer::OutlinePass(const SceneRenderOption& option)
     {
         SL_SCOPE_PROFILE("OutlinePass");
 
-        SceneRenderOption option = context->option;
         context->outlineShader->Bind();
         context->outlineShader->Set("screenTexture", 0);
         context->outlineShader->Set("normalTexture", 1);
@@ -830,11 +930,10 @@ namespace Silex
     //==================================
     // トーンマップパス
     //==================================
-    void SceneRenderer::TonemapPass()
+    void SceneRenderer::TonemapPass(const SceneRenderOption& option)
     {
         SL_SCOPE_PROFILE("TonemapPass");
 
-        SceneRenderOption option = context->option;
         context->tonemapShader->Bind();
         context->tonemapShader->Set("exposure",        option.postProcess.exposure);
         context->tonemapShader->Set("gammaCorrection", option.postProcess.gammaCorrection);
@@ -859,10 +958,15 @@ namespace Silex
 
     int32 SceneRenderer::ReadEntityIDFromPixcel(uint32 x, uint32 y)
     {
-        float height = context->viewportSize.y - y; // OpenGL: 上下反転
+        // 選択操作時のみなので、GL スレッドでの読み戻しの完了を待って結果を受け取る
+        glm::ivec4 p;
+        Renderer::Get()->EnqueueAndFlush("ReadEntityID", [this, x, y, &p]()
+        {
+            float height = context->viewportSize.y - y; // OpenGL: 上下反転
 
-        context->gBufferFB->Bind();
-        glm::ivec4 p = context->gBufferFB->ReadPixelInt(4, x, height);
+            context->gBufferFB->Bind();
+            p = context->gBufferFB->ReadPixelInt(4, x, height);
+        });
 
         return p.g;
     }
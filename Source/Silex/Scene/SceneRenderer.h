@@ -21,16 +21,26 @@ namespace Silex
     // 描画パラメータのインスタンシングデータ
     struct InstancingUnitParameter
     {
-        std::vector<MeshParameter> parameters;
+        FrameVector<MeshParameter> parameters;
         int32                      offset = 0;
     };
 
+    struct MaterialUBO
+    {
+        glm::vec3 albedo;
+        float     metallic;
+        glm::vec3 emission;
+        float     roughness;
+        glm::vec2 textureTiling;
+    };
+
     // メッシュのインスタンシングデータ
     struct InstancingUnitData
     {
         Mesh*        meshAsset     = nullptr; // メッシュデータ
         MeshSource*  source        = nullptr; // メッシュの頂点データ
-        Material*    material      = nullptr; // マテリアル
+        MaterialUBO  material      = {};      // マテリアルパラメータ（エディターから変更されるので記録時にコピーする）
+        uint32       albedoMapID   = 0;       // アルベドテクスチャ
         uint32       instanceCount = 0;       // インスタンス数
         uint32       indexCount    = 0;       // 合計頂点インデックス数
         uint32       vertexCount   = 0;       // 合計頂点数
@@ -99,13 +109,44 @@ namespace Silex
         uint64 numShadowDrawCall   = 0;
     };
 
-    struct MaterialUBO
+    //--------------------------------------------------------
+    // フレーム毎に記録する描画データ
+    //--------------------------------------------------------
+    // メインスレッドが記録し、描画パスはこのデータだけを参照する（シーンのコンポーネントには触れない）
+    // レンダースレッドが前フレームを実行している間に次のフレームを記録するので、2つ持つ
+    // コンテナはフレームアリーナから確保し、BeginFrame で作り直す
+    //--------------------------------------------------------
+    struct SceneFrameData
     {
-        glm::vec3 albedo;
-        float     metallic;
-        glm::vec3 emission;
-        float     roughness;
-        glm::vec2 textureTiling;
+        // ライト
+        SkyLightComponent         skyLight;
+        DirectionalLightComponent directionalLight;
+
+        // EndFrame 時点のカメラのコピー
+        Camera camera;
+
+        // 描画要求されたメッシュコンポーネントリスト
+        FrameVector<MeshDrawData> meshDrawList;
+
+        // シャドウインスタンシングデータ
+        FrameHashMap<InstancingUnitID, InstancingUnitData>      shadowDrawData;
+        FrameHashMap<InstancingUnitID, InstancingUnitParameter> ShadowParameterData;
+        MeshParameter*                                          shadowParameters    = nullptr;
+        uint32                                                  numShadowParameters = 0;
+        std::array<glm::mat4, 4>                                lightMatrices       = {};
+
+        // ジオメトリインスタンシングデータ
+        FrameHashMap<InstancingUnitID, InstancingUnitData>      meshDrawData;
+        FrameHashMap<InstancingUnitID, InstancingUnitParameter> meshParameterData;
+        MeshParameter*                                          meshParameters    = nullptr;
+        uint32                                                  numMeshParameters = 0;
+
+        // 描画フラグ
+        bool shouldRenderShadow   = false;
+        bool shouldRenderGeometry = false;
+
+        SceneRenderStats  stats;
+        SceneRenderOption option;
     };
 
     struct SceneRenderingContext
@@ -114,12 +155,6 @@ namespace Silex
         static inline const int32 numBloomSampling = 6;
         static inline const int32 numMaxInstancing = 8192;
 
-        //========================================================
-        // ライト
-        //========================================================
-        SkyLightComponent         skyLight;
-        DirectionalLightComponent directionalLight;
-
         // シーン情報
         glm::vec2 viewportSize = { 1280.f, 720.f };
         Scene*    renderScene  = nullptr;
@@ -157,21 +192,13 @@ namespace Silex
         // 描画データ
         //========================================================
 
-        // 描画要求されたメッシュコンポーネントリスト
-        std::vector<MeshDrawData> meshDrawList;
+        // 記録中のフレームは frames[recordIndex]、もう一方はレンダースレッドが実行中
+        std::array<SceneFrameData, 2> frames;
+        uint32                        recordIndex = 0;
 
         // インスタンシング用トランスフォーム
-        MeshParameter*        meshParameters = nullptr;
         Shared<StorageBuffer> meshParameterSBO;
 
-        // シャドウインスタンシングデータ
-        std::unordered_map<InstancingUnitID, InstancingUnitData>      shadowDrawData;
-        std::unordered_map<InstancingUnitID, InstancingUnitParameter> ShadowParameterData;
-
-        // ジオメトリインスタンシングデータ
-        std::unordered_map<InstancingUnitID, InstancingUnitData>      meshDrawData;
-        std::unordered_map<InstancingUnitID, InstancingUnitParameter> meshParameterData;
-
         //========================================================
         // シェーダー
         //========================================================
@@ -197,12 +224,7 @@ namespace Silex
         float intencityMultiplication = 10.0;
 
         // 描画フラグ
-        bool enablePostProcess    = true;
-        bool shouldRenderShadow   = false;
-        bool shouldRenderGeometry = false;
-
-        SceneRenderStats  stats;
-        SceneRenderOption option;
+        bool enablePostProcess = true;
     };
 
 
@@ -237,28 +259,39 @@ namespace Silex
 
     public:
 
-        SceneRenderStats   GetRenderStats()  { return context->stats;  }
-        SceneRenderOption& GetRenderOption() { return context->option; }
+        // 記録中のフレームの統計・オプション（統計は記録時に確定する）
+        SceneRenderStats   GetRenderStats()  { return context->frames[context->recordIndex].stats;  }
+        SceneRenderOption& GetRenderOption() { return context->frames[context->recordIndex].option; }
+
+    private:
+
+        // インスタンシングデータの構築（メインスレッド）
+        void BuildShadowInstancing(SceneFrameData& frame);
+        void BuildGeometryInstancing(SceneFrameData& frame);
+
+        // 描画パスの実行（GL スレッド）
+        void ExecutePasses(const SceneFrameData& frame);
+        void ResizeFramebuffers(uint32 width, uint32 height);
 
     private:
 
-        void ShadowMapPass();
-        void GeometryPass();
-        void SkyboxPass();
-        void DeferredLightinglPass();
-        void ForwardLightinglPass();
-        void PostProcessPass();
+        void ShadowMapPass(const SceneFrameData& frame);
+        void GeometryPass(const SceneFrameData& frame);
+        void SkyboxPass(const SceneFrameData& frame);
+        void DeferredLightinglPass(const SceneFrameData& frame);
+        void ForwardLightinglPass(const SceneFrameData& frame);
+        void PostProcessPass(const SceneFrameData& frame);
 
     private:
 
-        void BloomPass();
-        void BloomPreFiltering();
+        void BloomPass(const SceneRenderOption& option);
+        void BloomPreFiltering(const SceneRenderOption& option);
         void BloomDownSampling();
         void BloomUpSampling();
         void FXAAPass();
-        void OutlinePass();
+        void OutlinePass(const SceneRenderOption& option);
         void ChromaticAberrationPass();
-        void TonemapPass();
+        void TonemapPass(const SceneRenderOption& option);
 
     private:
 
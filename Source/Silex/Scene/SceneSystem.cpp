@@ -0,0 +1,125 @@
+
+#include "PCH.h"
+
+#include "Core/OS.h"
+#include "Core/Profiler.h"
+#include "Scene/SceneSystem.h"
+
+
+namespace Silex
+{
+    uint32 Internal::NextSystemAccessIndex()
+    {
+        static std::atomic<uint32> nextIndex = 0;
+        return nextIndex.fetch_add(1, std::memory_order_relaxed);
+    }
+
+
+    SceneSystemScheduler::~SceneSystemScheduler()
+    {
+        for (SystemNode* node : systems)
+        {
+            Memory::Deallocate(node);
+        }
+    }
+
+    void SceneSystemScheduler::Build()
+    {
+        for (SystemNode* node : systems)
+        {
+            node->dependents.clear();
+            node->numDependencies = 0;
+        }
+
+        // 先に登録された競合するシステムの完了を待つ（登録順が実行順の基準になる）
+        // 推移的に到達できる依存も辺として残るが、システム数は少ないので省略しない
+        for (uint64 i = 0; i < systems.size(); i++)
+        {
+            for (uint64 j = 0; j < i; j++)
+            {
+                if (systems[i]->access.ConflictsWith(systems[j]->access))
+                {
+                    systems[j]->dependents.push_back(systems[i]);
+                    systems[i]->numDependencies++;
+                }
+            }
+        }
+
+        stats.resize(systems.size());
+        isDirty = false;
+    }
+
+    void SceneSystemScheduler::Execute(const SceneSystemContext& context)
+    {
+        if (isDirty)
+        {
+            Build();
+        }
+
+        // ワーカーが無ければ登録順に直列で実行する
+        if (ThreadPool::GetThreadCount() == 0)
+        {
+            for (SystemNode* node : systems)
+            {
+                Run(node, context);
+            }
+        }
+        else
+        {
+            // ワーカーで実行したシステムも、呼び出し元のスコープの子として計測する
+            ExecuteState state = { &context, Profiler::GetCurrentScope() };
+
+            for (SystemNode* node : systems)
+            {
+                node->remaining.store(node->numDependencies, std::memory_order_relaxed);
+            }
+
+            for (SystemNode* node : systems)
+            {
+                if (node->numDependencies == 0)
+                {
+                    Submit(node, &state);
+                }
+            }
+
+            // 後続のシステムは完了したタスク内から同じカウンターで追加されるので、全て完了するまで戻らない
+            ThreadPool::Wait(state.counter);
+        }
+
+        for (uint64 i = 0; i < systems.size(); i++)
+        {
+            SystemNode* node = systems[i];
+
+            SceneSystemStats& stat = stats[i];
+            stat.name            = node->name;
+            stat.time            = node->time / 1000.0f;
+            stat.numDependencies = node->numDependencies;
+        }
+    }
+
+    void SceneSystemScheduler::Submit(SystemNode* node, ExecuteState* state)
+    {
+        ThreadPool::AddTask([node, state]()
+        {
+            ProfileParentScope parentScope(state->parent);
+            Run(node, *state->context);
+
+            for (SystemNode* dependent : node->dependents)
+            {
+                if (dependent->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    Submit(dependent, state);
+                }
+            }
+        }, state->counter);
+    }
+
+    void SceneSystemScheduler::Run(SystemNode* node, const SceneSystemContext& context)
+    {
+        SL_SCOPE_PROFILE(node->name);
+
+        uint64 begin = OS::Get()->GetTickSeconds();
+        node->function.Execute(context);
+        node->time = OS::Get()->GetTickSeconds() - begin;
+    }
+}
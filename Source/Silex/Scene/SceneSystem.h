@@ -0,0 +1,187 @@
+#pragma once
+
+#include "Core/CoreType.h"
+#include "Core/Delegate.h"
+#include "Core/Memory.h"
+#include "Core/Parallel.h"
+#include "Core/Profiler.h"
+#include "Core/ThreadPool.h"
+#include <atomic>
+#include <entt/entt.hpp>
+
+
+namespace Silex
+{
+    class Scene;
+    class Camera;
+    class SceneRenderer;
+
+    namespace Internal
+    {
+        // アクセス対象の型毎に 0 から順に割り当てる番号（マスクのビット位置）
+        uint32 NextSystemAccessIndex();
+
+        template<typename T>
+        uint32 GetSystemAccessIndex()
+        {
+            static const uint32 index = NextSystemAccessIndex();
+            return index;
+        }
+    }
+
+
+    //=========================================================================
+    // システムのアクセス宣言
+    //-------------------------------------------------------------------------
+    // システムが読み込む・書き込む型（コンポーネント、またはレンダラーの状態などの共有リソース）を宣言する
+    // 同じ型に対して、一方が書き込むシステム同士は競合し、登録順に直列で実行される
+    //=========================================================================
+    struct SystemAccess
+    {
+        uint64 read  = 0;
+        uint64 write = 0;
+
+        template<typename... T>
+        SystemAccess& Read()
+        {
+            read |= (GetBit<T>() | ...);
+            return *this;
+        }
+
+        template<typename... T>
+        SystemAccess& Write()
+        {
+            write |= (GetBit<T>() | ...);
+            return *this;
+        }
+
+        bool ConflictsWith(const SystemAccess& other) const
+        {
+            return (write & (other.read | other.write)) || (other.write & read);
+        }
+
+    private:
+
+        template<typename T>
+        static uint64 GetBit()
+        {
+            uint32 index = Internal::GetSystemAccessIndex<std::decay_t<T>>();
+            SL_ASSERT(index < 64, "システムのアクセス対象の型は 64種類までです");
+
+            return 1ull << index;
+        }
+    };
+
+
+    // システムに渡すフレームの情報
+    struct SceneSystemContext
+    {
+        Scene*         scene     = nullptr;
+        SceneRenderer* renderer  = nullptr;
+        Camera*        camera    = nullptr;
+        float          deltaTime = 0.0f;
+    };
+
+    // 直前のフレームの実行結果
+    struct SceneSystemStats
+    {
+        const char* name            = nullptr;
+        float       time            = 0.0f; // 実行時間（ms）
+        uint32      numDependencies = 0;    // 完了を待つシステム数
+    };
+
+    using SceneSystemFunction = Function<void(const SceneSystemContext&), 16>;
+
+
+    //=========================================================================
+    // シーンシステムスケジューラー
+    //-------------------------------------------------------------------------
+    // 登録順に、先に登録された競合するシステムへの依存を辺とする DAG を構築する
+    // 依存が無いシステムから ThreadPool で実行し、完了したシステムが依存の解決したシステムを追加する
+    // 呼び出しスレッドも待機中にタスクを実行し、全て完了すると戻る
+    //
+    // システム内で registry の構造（エンティティ・コンポーネントの追加や削除、グループの初回生成）を
+    // 変更しないこと。使用するグループはシステムの登録前に生成しておく
+    //=========================================================================
+    class SceneSystemScheduler
+    {
+    public:
+
+        SceneSystemScheduler() = default;
+        ~SceneSystemScheduler();
+
+        // name はプロファイラーのキーとして保持するので、文字列リテラルを渡すこと
+        template<typename F>
+        void AddSystem(const char* name, const SystemAccess& access, F&& function)
+        {
+            SystemNode* node = Memory::Allocate<SystemNode>();
+            node->name   = name;
+            node->access = access;
+            node->function.Bind(Traits::Forward<F>(function));
+
+            systems.push_back(node);
+            isDirty = true;
+        }
+
+        // 全てのシステムを実行する（システム毎に、呼び出し元のスコープの子としてプロファイラーで計測する）
+        void Execute(const SceneSystemContext& context);
+
+        const PoolVector<SceneSystemStats>& GetStats() const { return stats; }
+
+    private:
+
+        struct SystemNode
+        {
+            const char*         name = nullptr;
+            SystemAccess        access;
+            SceneSystemFunction function;
+
+            PoolVector<SystemNode*> dependents;
+            uint32                  numDependencies = 0;
+
+            std::atomic<uint32> remaining = 0;
+            uint64              time      = 0;
+        };
+
+        struct ExecuteState
+        {
+            const SceneSystemContext* context;
+            ProfileLink               parent;
+            TaskCounter               counter;
+        };
+
+        void Build();
+
+        static void Submit(SystemNode* node, ExecuteState* state);
+        static void Run(SystemNode* node, const SceneSystemContext& context);
+
+        PoolVector<SystemNode*>      systems;
+        PoolVector<SceneSystemStats> stats;
+        bool                         isDirty = false;
+
+    private:
+
+        SceneSystemScheduler(const SceneSystemScheduler&)            = delete;
+        SceneSystemScheduler& operator=(const SceneSystemScheduler&) = delete;
+    };
+
+
+    //=========================================================================
+    // エンティティの並列走査
+    //-------------------------------------------------------------------------
+    // グループ（またはインデックスでアクセスできる単一コンポーネントのビュー）を grainSize 毎に分割し、
+    // ワーカーで走査する。システム内から呼んだ場合も、待機中のスレッドが分割範囲を処理する
+    // function(index, entity)
+    //=========================================================================
+    template<typename Group, typename Function>
+    void ParallelForEach(const Group& group, Function&& function, uint64 grainSize = 0)
+    {
+        ParallelForRange(0, group.size(), [&](uint64 begin, uint64 end)
+        {
+            for (uint64 i = begin; i < end; i++)
+            {
+                function(i, group[i]);
+            }
+        }, grainSize);
+    }
+}
@@ -5,14 +5,14 @@
 
 namespace Silex
 {
-    extern bool LaunchEngine();
+    extern bool LaunchEngine(const char* commandLine);
     extern void ShutdownEngine();
 
-    int32 Main()
+    int32 Main(const char* commandLine)
     {
         WindowsOS os;
 
-        bool result = LaunchEngine();
+        bool result = LaunchEngine(commandLine);
         if (result)
         {
             os.Run();
@@ -25,5 +25,5 @@ namespace Silex
 
 int32 WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _In_ char* lpCmdLine, _In_ int32 nCmdShow)
 {
-    return Silex::Main();
+    return Silex::Main(lpCmdLine);
 }
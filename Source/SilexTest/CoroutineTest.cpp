@@ -0,0 +1,77 @@
+#include "PCH.h"
+
+#include "Test.h"
+#include "Core/Coroutine.h"
+
+
+namespace Silex
+{
+    // ワーカーで値を計算し、メインスレッドに戻ってから返す（テクスチャ読み込みと同じ流れ）
+    static Task<uint64> ComputeOnWorker(uint64 value)
+    {
+        co_await SwitchToWorker();
+        uint64 result = value * 2;
+
+        co_await SwitchToMainThread();
+        co_return result + (MainThreadQueue::IsMainThread() ? 1 : 0);
+    }
+
+    static Task<uint64> ComputeAll()
+    {
+        std::vector<Task<uint64>> tasks;
+        for (uint64 i = 0; i < 16; i++)
+        {
+            tasks.push_back(ComputeOnWorker(i));
+        }
+
+        co_await WhenAll(tasks);
+
+        uint64 sum = 0;
+        for (Task<uint64>& task : tasks)
+        {
+            sum += task.GetResult();
+        }
+
+        co_return sum;
+    }
+
+
+    //==================================================================
+    // テスト
+    //==================================================================
+    SL_TEST(Coroutine_SyncWaitBlockedWorkers)
+    {
+        // 全てのワーカーが長時間のタスク（スプラッシュのメッセージループなど）で塞がっていても、
+        // SyncWait が待機中にタスクを実行して完了すること
+        uint32              numWorkers = ThreadPool::GetThreadCount();
+        std::atomic<uint32> blocked    = 0;
+        std::atomic<bool>   release    = false;
+
+        for (uint32 i = 0; i < numWorkers; i++)
+        {
+            ThreadPool::AddTask([&]()
+            {
+                blocked.fetch_add(1);
+                while (!release.load())
+                {
+                    std::this_thread::yield();
+                }
+            });
+        }
+
+        // 塞ぐタスクを SyncWait 側で拾わないように、全て開始されるまで待つ
+        while (blocked.load() != numWorkers)
+        {
+            std::this_thread::yield();
+        }
+
+        Task<uint64> task = ComputeAll();
+        uint64 sum = SyncWait(task);
+
+        // sum(i * 2 + 1), i = 0..15
+        SL_EXPECT(sum == 256);
+
+        release = true;
+        ThreadPool::WaitAll();
+    }
+}
@@ -0,0 +1,252 @@
+
+#include "PCH.h"
+
+#include "Test.h"
+#include "Core/LockFreeQueue.h"
+
+#include <deque>
+#include <mutex>
+
+
+namespace Silex
+{
+    //==================================================================
+    // 比較用 ミューテックス + std::deque
+    //==================================================================
+    template<typename T>
+    class MutexQueue
+    {
+    public:
+
+        bool Push(const T& value)
+        {
+            std::scoped_lock lock(mutex);
+            queue.push_back(value);
+            return true;
+        }
+
+        bool Pop(T& out)
+        {
+            std::scoped_lock lock(mutex);
+            if (queue.empty())
+                return false;
+
+            out = queue.front();
+            queue.pop_front();
+            return true;
+        }
+
+    private:
+
+        std::mutex    mutex;
+        std::deque<T> queue;
+    };
+
+
+    // 各プロデューサーが (番号 << 32 | 連番) を numItems 個追加し、コンシューマーが全て取り出すまで回す
+    // 取り出した値は、プロデューサー毎に連番が増加していること（FIFO）と、合計が一致することを確認する
+    template<typename Queue>
+    static bool RunProducerConsumer(Queue& queue, uint32 numProducers, uint32 numConsumers, uint64 numItems)
+    {
+        std::atomic<uint64> consumedCount = 0;
+        std::atomic<uint64> consumedSum   = 0;
+        std::atomic<bool>   ordered       = true;
+
+        std::vector<std::thread> threads;
+
+        for (uint32 p = 0; p < numProducers; p++)
+        {
+            threads.emplace_back([&, p]()
+            {
+                for (uint64 i = 0; i < numItems; i++)
+                {
+                    uint64 value = (uint64)p << 32 | i;
+                    while (!queue.Push(value))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        for (uint32 c = 0; c < numConsumers; c++)
+        {
+            threads.emplace_back([&]()
+            {
+                std::vector<int64> lastIndex(numProducers, -1);
+                uint64 sum = 0;
+
+                while (consumedCount.load(std::memory_order_relaxed) < numItems * numProducers)
+                {
+                    uint64 value;
+                    if (!queue.Pop(value))
+                    {
+                        std::this_thread::yield();
+                        continue;
+                    }
+
+                    uint32 producer = (uint32)(value >> 32);
+                    int64  index    = (int64)(value & 0xffffffff);
+
+                    if (index <= lastIndex[producer])
+                        ordered = false;
+
+                    lastIndex[producer] = index;
+                    sum += value & 0xffffffff;
+
+                    consumedCount.fetch_add(1, std::memory_order_relaxed);
+                }
+
+                consumedSum.fetch_add(sum, std::memory_order_relaxed);
+            });
+        }
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        uint64 expectedSum = numItems * (numItems - 1) / 2 * numProducers;
+        return ordered && consumedCount == numItems * numProducers && consumedSum == expectedSum;
+    }
+
+
+    //==================================================================
+    // テスト（ThreadSanitizer でビルドした場合は、データ競合も検出される）
+    //==================================================================
+    SL_TEST(SPSCQueue_SingleThread)
+    {
+        auto queue = std::make_unique<SPSCQueue<std::string, 4>>();
+
+        // 周回させて、満杯・空の判定を確認する
+        for (uint32 round = 0; round < 3; round++)
+        {
+            SL_EXPECT(queue->IsEmpty());
+
+            for (uint32 i = 0; i < 4; i++)
+            {
+                SL_EXPECT(queue->Push(std::to_string(round * 4 + i)));
+            }
+
+            SL_EXPECT(!queue->Push(std::string("full")));
+            SL_EXPECT(queue->GetSize() == 4);
+
+            for (uint32 i = 0; i < 4; i++)
+            {
+                std::string value;
+                SL_EXPECT(queue->Pop(value));
+                SL_EXPECT(value == std::to_string(round * 4 + i));
+            }
+
+            std::string value;
+            SL_EXPECT(!queue->Pop(value));
+        }
+
+        // 残った要素はデストラクタで破棄される
+        queue->Push(std::string("left in queue, longer than small string buffer"));
+    }
+
+    SL_TEST(SPSCQueue_Concurrent)
+    {
+        auto queue = std::make_unique<SPSCQueue<uint64, 1024>>();
+        SL_EXPECT(RunProducerConsumer(*queue, 1, 1, 1'000'000));
+        SL_EXPECT(queue->IsEmpty());
+    }
+
+    SL_TEST(MPMCQueue_SingleThread)
+    {
+        auto queue = std::make_unique<MPMCQueue<std::string, 4>>();
+
+        for (uint32 round = 0; round < 3; round++)
+        {
+            for (uint32 i = 0; i < 4; i++)
+            {
+                SL_EXPECT(queue->Push(std::to_string(round * 4 + i)));
+            }
+
+            SL_EXPECT(!queue->Push(std::string("full")));
+
+            for (uint32 i = 0; i < 4; i++)
+            {
+                std::string value;
+                SL_EXPECT(queue->Pop(value));
+                SL_EXPECT(value == std::to_string(round * 4 + i));
+            }
+
+            std::string value;
+            SL_EXPECT(!queue->Pop(value));
+        }
+
+        queue->Push(std::string("left in queue, longer than small string buffer"));
+        queue->Clear();
+        SL_EXPECT(queue->GetSize() == 0);
+    }
+
+    SL_TEST(MPMCQueue_Concurrent)
+    {
+        auto queue = std::make_unique<MPMCQueue<uint64, 1024>>();
+        SL_EXPECT(RunProducerConsumer(*queue, 4, 4, 200'000));
+        SL_EXPECT(queue->GetSize() == 0);
+    }
+
+    SL_TEST(MPMCQueue_ManyProducersSmallCapacity)
+    {
+        // 容量が小さく満杯・空が頻繁に起きる状況
+        auto queue = std::make_unique<MPMCQueue<uint64, 8>>();
+        SL_EXPECT(RunProducerConsumer(*queue, 8, 2, 20'000));
+    }
+
+
+    //==================================================================
+    // ベンチマーク: ミューテックス + std::deque との比較
+    //==================================================================
+    SL_BENCHMARK(LockFreeQueue_Throughput)
+    {
+        static constexpr uint64 numItems = 1'000'000;
+
+        {
+            double mutexTime = Test::MeasureBest(3, [&]()
+            {
+                MutexQueue<uint64> queue;
+                RunProducerConsumer(queue, 1, 1, numItems);
+            });
+
+            double spscTime = Test::MeasureBest(3, [&]()
+            {
+                auto queue = std::make_unique<SPSCQueue<uint64, 4096>>();
+                RunProducerConsumer(*queue, 1, 1, numItems);
+            });
+
+            double mpmcTime = Test::MeasureBest(3, [&]()
+            {
+                auto queue = std::make_unique<MPMCQueue<uint64, 4096>>();
+                RunProducerConsumer(*queue, 1, 1, numItems);
+            });
+
+            Test::ReportBenchmark("1P/1C mutex + deque", mutexTime, numItems);
+            Test::ReportBenchmark("1P/1C SPSCQueue",     spscTime,  numItems, mutexTime);
+            Test::ReportBenchmark("1P/1C MPMCQueue",     mpmcTime,  numItems, mutexTime);
+        }
+
+        for (uint32 numThreads : { 2u, 4u })
+        {
+            uint64 perProducer = numItems / numThreads;
+
+            double mutexTime = Test::MeasureBest(3, [&]()
+            {
+                MutexQueue<uint64> queue;
+                RunProducerConsumer(queue, numThreads, numThreads, perProducer);
+            });
+
+            double mpmcTime = Test::MeasureBest(3, [&]()
+            {
+                auto queue = std::make_unique<MPMCQueue<uint64, 4096>>();
+                RunProducerConsumer(*queue, numThreads, numThreads, perProducer);
+            });
+
+            std::string label = std::to_string(numThreads) + "P/" + std::to_string(numThreads) + "C ";
+            Test::ReportBenchmark((label + "mutex + deque").c_str(), mutexTime, perProducer * numThreads);
+            Test::ReportBenchmark((label + "MPMCQueue").c_str(),     mpmcTime,  perProducer * numThreads, mutexTime);
+        }
+    }
+}
@@ -0,0 +1,383 @@
+
+#include "PCH.h"
+
+#include "Test.h"
+#include "TestPlatform.h"
+
+#include <cstring>
+
+
+namespace Silex
+{
+    // スレッド毎に決まった列になる簡易乱数（サイズの選択用）
+    static uint32 NextRandom(uint32& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    // numThreads 本のスレッドで同時に関数を実行し、全員が揃ってから開始する
+    template<typename Function>
+    static double RunThreads(uint32 numThreads, Function&& function)
+    {
+        std::atomic<uint32>      ready = 0;
+        std::atomic<bool>        start = false;
+        std::vector<std::thread> threads;
+
+        for (uint32 i = 0; i < numThreads; i++)
+        {
+            threads.emplace_back([&, i]()
+            {
+                ready.fetch_add(1);
+                while (!start.load())
+                {
+                    std::this_thread::yield();
+                }
+
+                function(i);
+            });
+        }
+
+        while (ready.load() != numThreads)
+        {
+            std::this_thread::yield();
+        }
+
+        return Test::MeasureMilliseconds([&]()
+        {
+            start = true;
+            for (std::thread& thread : threads)
+            {
+                thread.join();
+            }
+        });
+    }
+
+    // 32 ～ 1024 バイトの確保・解放を、生存数を一定に保ちながら繰り返す
+    template<typename Allocate, typename Deallocate>
+    static void AllocationWorkload(uint32 seed, uint32 numIterations, Allocate&& allocate, Deallocate&& deallocate)
+    {
+        static constexpr uint32 numLive = 256;
+
+        void*  live[numLive] = {};
+        uint32 state         = seed * 2654435761u + 1;
+
+        for (uint32 i = 0; i < numIterations; i++)
+        {
+            uint32 slot = NextRandom(state) % numLive;
+            if (live[slot])
+            {
+                deallocate(live[slot]);
+            }
+
+            uint64 size = 32ull << (NextRandom(state) % 6);
+            live[slot] = allocate(size);
+
+            // 書き込んで、他のスレッドとブロックを共有していないことを確認できるようにする
+            std::memset(live[slot], (int)(seed & 0xff), 32);
+        }
+
+        for (void* pointer : live)
+        {
+            if (pointer)
+            {
+                deallocate(pointer);
+            }
+        }
+    }
+
+
+    //==================================================================
+    // テスト
+    //==================================================================
+    SL_TEST(PoolAllocator_CrossThreadFree)
+    {
+        // 別のスレッドで確保したブロックを解放しても、内容が壊れず再利用されること
+        static constexpr uint32 numBlocks = 20'000;
+
+        std::vector<void*> blocks(numBlocks);
+        std::thread producer([&]()
+        {
+            for (uint32 i = 0; i < numBlocks; i++)
+            {
+                blocks[i] = Memory::AllocateBytes(64);
+                std::memset(blocks[i], (int)(i & 0xff), 64);
+            }
+        });
+        producer.join();
+
+        bool intact = true;
+        std::thread consumer([&]()
+        {
+            for (uint32 i = 0; i < numBlocks; i++)
+            {
+                const byte* data = static_cast<const byte*>(blocks[i]);
+                intact &= data[0] == (byte)(i & 0xff) && data[63] == (byte)(i & 0xff);
+
+                Memory::DeallocateBytes(blocks[i]);
+            }
+        });
+        consumer.join();
+
+        SL_EXPECT(intact);
+    }
+
+    SL_TEST(PoolAllocator_Concurrent)
+    {
+        std::atomic<bool> corrupted = false;
+
+        RunThreads(8, [&](uint32 thread)
+        {
+            AllocationWorkload(thread + 1, 100'000,
+                [&](uint64 size)
+                {
+                    return Memory::AllocateBytes(size);
+                },
+                [&](void* pointer)
+                {
+                    // 自身が書き込んだ値が他のスレッドに上書きされていないこと
+                    if (*static_cast<byte*>(pointer) != (byte)((thread + 1) & 0xff))
+                        corrupted = true;
+
+                    Memory::DeallocateBytes(pointer);
+                });
+        });
+
+        SL_EXPECT(!corrupted);
+    }
+
+
+    SL_TEST(MemoryPool_MultipleInstances)
+    {
+        // 同じスレッドで複数のプールを交互に使用しても、ブロックが他のプールに渡らないこと
+        static constexpr uint32 numBlocks = 1'000;
+
+        MemoryPool poolA;
+        MemoryPool poolB;
+        poolA.Initialize();
+        poolB.Initialize();
+
+        std::vector<void*> blocksA;
+        std::vector<void*> blocksB;
+
+        bool separated = true;
+        for (uint32 round = 0; round < 3; round++)
+        {
+            for (uint32 i = 0; i < numBlocks; i++)
+            {
+                blocksA.push_back(poolA.AllocateFromPool(i % MemoryPool::numPools));
+                blocksB.push_back(poolB.AllocateFromPool(i % MemoryPool::numPools));
+            }
+
+            // 確保と逆のプールの順で解放し、キャッシュの所有者を切り替え続ける
+            for (uint32 i = 0; i < numBlocks; i++)
+            {
+                separated &= poolA.Contains(blocksA[i]) && !poolB.Contains(blocksA[i]);
+                separated &= poolB.Contains(blocksB[i]) && !poolA.Contains(blocksB[i]);
+
+                poolB.DeallocateToPool(blocksB[i], i % MemoryPool::numPools);
+                poolA.DeallocateToPool(blocksA[i], i % MemoryPool::numPools);
+            }
+
+            blocksA.clear();
+            blocksB.clear();
+        }
+
+        SL_EXPECT(separated);
+
+        // 切り替え時に統計も元のプールへ引き継がれること
+        for (const MemoryPoolStatus& status : poolA.GetStatus()) SL_EXPECT(status.totalAllocated == 0);
+        for (const MemoryPoolStatus& status : poolB.GetStatus()) SL_EXPECT(status.totalAllocated == 0);
+
+        // 他のスレッドのキャッシュが所有したままプールを終了しても、次に使用するプールで空になること
+        std::atomic<uint32> step        = 0;
+        bool                otherPooled = false;
+
+        std::thread other([&]()
+        {
+            poolB.DeallocateToPool(poolB.AllocateFromPool(0), 0);
+
+            step = 1;
+            while (step.load() != 2)
+            {
+                std::this_thread::yield();
+            }
+
+            void* pointer = Memory::AllocateBytes(32);
+            otherPooled = PoolAllocator::Contains(pointer);
+            Memory::DeallocateBytes(pointer);
+        });
+
+        while (step.load() != 1)
+        {
+            std::this_thread::yield();
+        }
+
+        poolA.Finalize();
+        poolB.Finalize();
+
+        step = 2;
+        other.join();
+
+        void* pooled = Memory::AllocateBytes(32);
+        SL_EXPECT(PoolAllocator::Contains(pooled));
+        SL_EXPECT(otherPooled);
+        Memory::DeallocateBytes(pooled);
+    }
+
+
+    //==================================================================
+    // ベンチマーク: 1 / 4 / 16 スレッドで同時に確保・解放した場合の malloc との比較
+    //==================================================================
+    SL_BENCHMARK(PoolAllocator_Contention)
+    {
+        static constexpr uint32 numIterations = 500'000;
+
+        for (uint32 numThreads : { 1u, 4u, 16u })
+        {
+            double mallocTime = RunThreads(numThreads, [&](uint32 thread)
+            {
+                AllocationWorkload(thread + 1, numIterations, [](uint64 size) { return std::malloc(size); }, [](void* pointer) { std::free(pointer); });
+            });
+
+            double poolTime = RunThreads(numThreads, [&](uint32 thread)
+            {
+                AllocationWorkload(thread + 1, numIterations, [](uint64 size) { return Memory::AllocateBytes(size); }, [](void* pointer) { Memory::DeallocateBytes(pointer); });
+            });
+
+            std::string label = std::to_string(numThreads) + " threads ";
+            Test::ReportBenchmark((label + "malloc / free").c_str(),                    mallocTime, (uint64)numIterations * numThreads);
+            Test::ReportBenchmark((label + "AllocateBytes / DeallocateBytes").c_str(), poolTime,   (uint64)numIterations * numThreads, mallocTime);
+        }
+    }
+
+    SL_TEST(MemoryPool_LargePageClasses)
+    {
+        // 指定したサイズクラスのみラージページで確保され、常駐量として報告されること
+        TestOS* os       = static_cast<TestOS*>(OS::Get());
+        bool    enabled  = os->EnableLargePages(true);
+
+        MemoryPool pool;
+        pool.Initialize(1u << 1);
+
+        uint64 largeSize = pool.GetLargePageByteSize();
+        auto   status    = pool.GetStatus();
+
+        SL_EXPECT(status[0].largePageSize == 0);
+        SL_EXPECT(status[1].largePageSize == largeSize);
+        SL_EXPECT(enabled == (largeSize != 0));
+
+        // ラージページのクラスと通常のクラスの両方から確保・解放できること
+        void* small = pool.AllocateFromPool(0);
+        void* large = pool.AllocateFromPool(1);
+        SL_EXPECT(pool.Contains(small) && pool.Contains(large));
+
+        std::memset(small, 0, 32);
+        std::memset(large, 0, 64);
+
+        pool.DeallocateToPool(small, 0);
+        pool.DeallocateToPool(large, 1);
+
+        pool.Finalize();
+        os->EnableLargePages(false);
+    }
+
+
+    //==================================================================
+    // ベンチマーク: ラージページの有無によるランダムアクセスの比較
+    //------------------------------------------------------------------
+    // 64 バイトのブロックをラージページの領域（4MB）に収まるだけ確保し、ランダムな順序で
+    // 連結したリストを辿る（シーン抽出でのコンポーネント走査に近い、TLB に依存するアクセス）
+    //==================================================================
+    SL_BENCHMARK(MemoryPool_LargePages)
+    {
+        static constexpr uint32 numBlocks = 60'000;
+        static constexpr uint32 numPasses = 50;
+
+        struct Node
+        {
+            Node*  next;
+            uint64 value;
+        };
+
+        TestOS* os = static_cast<TestOS*>(OS::Get());
+
+        double normalTime = 0.0;
+        for (bool largePages : { false, true })
+        {
+            if (largePages && !os->EnableLargePages(true))
+            {
+                SL_LOG_INFO("  ラージページが使用できないため省略します");
+                break;
+            }
+
+            MemoryPool pool;
+            pool.Initialize(largePages ? 1u << 1 : 0);
+
+            double allocateTime = 0.0;
+            double traverseTime = 0.0;
+
+            RunThreads(1, [&](uint32)
+            {
+                std::vector<Node*> nodes(numBlocks);
+                allocateTime = Test::MeasureMilliseconds([&]()
+                {
+                    for (Node*& node : nodes)
+                    {
+                        node = static_cast<Node*>(pool.AllocateFromPool(1));
+                    }
+                });
+
+                // 確保順（アドレス順）ではなくランダムな順序で連結する
+                std::vector<Node*> order = nodes;
+                uint32 state = 12345;
+                for (uint32 i = numBlocks - 1; i > 0; i--)
+                {
+                    std::swap(order[i], order[NextRandom(state) % (i + 1)]);
+                }
+
+                for (uint32 i = 0; i < numBlocks; i++)
+                {
+                    order[i]->next  = order[(i + 1) % numBlocks];
+                    order[i]->value = i;
+                }
+
+                uint64 sum = 0;
+                traverseTime = Test::MeasureBest(5, [&]()
+                {
+                    Node* node = order[0];
+                    for (uint32 i = 0; i < numBlocks * numPasses; i++)
+                    {
+                        sum += node->value;
+                        node = node->next;
+                    }
+                });
+
+                SL_EXPECT(sum != 0);
+
+                for (Node* node : nodes)
+                {
+                    pool.DeallocateToPool(node, 1);
+                }
+            });
+
+            uint64 resident = pool.GetLargePageByteSize();
+            pool.Finalize();
+
+            const char* label = largePages ? "large pages" : "normal pages";
+            Test::ReportBenchmark((std::string(label) + " allocate").c_str(), allocateTime, numBlocks);
+            Test::ReportBenchmark((std::string(label) + " random traverse").c_str(), traverseTime, (uint64)numBlocks * numPasses, largePages ? normalTime : 0.0);
+
+            if (largePages)
+            {
+                SL_LOG_INFO("  常駐するラージページ領域: {} KB", resident / 1024);
+            }
+
+            normalTime = traverseTime;
+        }
+
+        os->EnableLargePages(false);
+    }
+}
@@ -0,0 +1,167 @@
+
+#include "PCH.h"
+
+#include "Test.h"
+#include "Core/Memory.h"
+#include "Core/MemoryTracker.h"
+
+
+namespace Silex
+{
+    // 確保元として使うアドレス（実際の確保は行わず、記録のみを呼び出す）
+    static const char trackerSiteA = 0;
+    static const char trackerSiteB = 0;
+    static const char trackerSiteC = 0;
+
+    static AllocationSiteStats FindFrameSite(const void* callSite)
+    {
+        for (const AllocationSiteStats& site : MemoryTracker::GetFrameTopAllocators(~0u))
+        {
+            if (site.callSite == callSite)
+                return site;
+        }
+
+        return {};
+    }
+
+    static bool IsNear(uint64 estimated, uint64 actual, double tolerance)
+    {
+        return std::abs((double)estimated - (double)actual) <= (double)actual * tolerance;
+    }
+
+
+    //==================================================================
+    // テスト
+    //==================================================================
+    SL_TEST(MemoryTracker_PeriodicPattern)
+    {
+        // 確保の周期がサンプリング間隔と一致していても、小さい確保元が推定から消えないこと
+        // （固定間隔のカウントダウンでは、全てのサンプルが周期内の同じ位置の確保元に集中する）
+        static constexpr uint64 interval      = 64 * 1024;
+        static constexpr uint64 numIterations = 400'000;
+        static constexpr uint64 smallSize     = 256;
+        static constexpr uint64 largeSize     = interval - smallSize;
+
+        uint64 previousInterval = MemoryTracker::GetSamplingInterval();
+        MemoryTracker::SetSamplingInterval(interval);
+        MemoryTracker::NextFrame();
+
+        std::thread thread([]()
+        {
+            for (uint64 i = 0; i < numIterations; i++)
+            {
+                MemoryTracker::RecordAllocate(smallSize, "small", &trackerSiteA);
+                MemoryTracker::RecordAllocate(largeSize, "large", &trackerSiteB);
+            }
+        });
+        thread.join();
+
+        MemoryTracker::NextFrame();
+
+        AllocationSiteStats small = FindFrameSite(&trackerSiteA);
+        AllocationSiteStats large = FindFrameSite(&trackerSiteB);
+
+        SL_EXPECT(IsNear(small.bytes, smallSize * numIterations, 0.15));
+        SL_EXPECT(IsNear(small.count, numIterations,             0.15));
+        SL_EXPECT(IsNear(large.bytes, largeSize * numIterations, 0.05));
+        SL_EXPECT(IsNear(large.count, numIterations,             0.05));
+
+        // 次のフレームは増分のみ（記録が無ければ空）
+        MemoryTracker::NextFrame();
+        SL_EXPECT(MemoryTracker::GetFrameTotal().count == 0);
+
+        MemoryTracker::SetSamplingInterval(previousInterval);
+    }
+
+    SL_TEST(MemoryTracker_FirstAllocation)
+    {
+        // スレッドの最初の確保が必ず記録されないこと（小さな確保 1回のスレッドを多数起動する）
+        static constexpr uint64 interval   = 64 * 1024;
+        static constexpr uint32 numThreads = 256;
+
+        uint64 previousInterval = MemoryTracker::GetSamplingInterval();
+        MemoryTracker::SetSamplingInterval(interval);
+        MemoryTracker::NextFrame();
+
+        for (uint32 i = 0; i < numThreads; i++)
+        {
+            std::thread([]() { MemoryTracker::RecordAllocate(32, "first", &trackerSiteC); }).join();
+        }
+
+        MemoryTracker::NextFrame();
+
+        // 記録される確率は 1 回あたり約 1/2048 なので、1サンプル（約 2048 回分）を超えることはほぼない
+        // 最初の確保が常に記録される場合は numThreads サンプル分になる
+        AllocationSiteStats first = FindFrameSite(&trackerSiteC);
+        SL_EXPECT(first.count <= 4 * interval / 32);
+
+        MemoryTracker::SetSamplingInterval(previousInterval);
+    }
+
+
+    //==================================================================
+    // ベンチマーク: サンプリング間隔毎の記録のオーバーヘッド
+    //------------------------------------------------------------------
+    // 記録を通らない PoolAllocator からの直接の確保を基準に、
+    // Memory::AllocateBytes（確保元の取得 + 記録）の間隔毎の時間を比較する（解放はどちらも DeallocateBytes）
+    //==================================================================
+    SL_BENCHMARK(MemoryTracker_Overhead)
+    {
+        static constexpr uint32 numLive       = 256;
+        static constexpr uint32 numIterations = 2'000'000;
+
+        void*  live[numLive] = {};
+        uint32 state         = 1;
+
+        // 32 ～ 1024 バイトの確保・解放を、生存数を一定に保ちながら繰り返す
+        auto workload = [&](auto&& allocate, auto&& deallocate)
+        {
+            for (uint32 i = 0; i < numIterations; i++)
+            {
+                state = state * 1664525u + 1013904223u;
+
+                uint32 slot = (state >> 8) % numLive;
+                if (live[slot])
+                {
+                    deallocate(live[slot]);
+                }
+
+                live[slot] = allocate(32ull << ((state >> 20) % 6));
+            }
+
+            for (void*& pointer : live)
+            {
+                if (pointer)
+                {
+                    deallocate(pointer);
+                    pointer = nullptr;
+                }
+            }
+        };
+
+        uint64 previousInterval = MemoryTracker::GetSamplingInterval();
+
+        double baselineTime = Test::MeasureBest(10, [&]()
+        {
+            workload([](uint64 size) { return PoolAllocator::Allocate(size); }, [](void* pointer) { Memory::DeallocateBytes(pointer); });
+        });
+
+        Test::ReportBenchmark("PoolAllocator (untracked)", baselineTime, numIterations);
+
+        for (uint64 interval : { 0ull, 1024ull * 1024, 64ull * 1024, 4ull * 1024 })
+        {
+            MemoryTracker::SetSamplingInterval(interval);
+
+            double trackedTime = Test::MeasureBest(10, [&]()
+            {
+                workload([](uint64 size) { return Memory::AllocateBytes(size); }, [](void* pointer) { Memory::DeallocateBytes(pointer); });
+            });
+
+            std::string label = interval == 0 ? std::string("AllocateBytes (sampling off)") : "AllocateBytes (interval " + std::to_string(interval / 1024) + " KB)";
+            Test::ReportBenchmark(label.c_str(), trackedTime, numIterations, baselineTime);
+        }
+
+        MemoryTracker::SetSamplingInterval(previousInterval);
+        MemoryTracker::NextFrame();
+    }
+}
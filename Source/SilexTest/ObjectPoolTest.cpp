@@ -0,0 +1,130 @@
+
+#include "PCH.h"
+
+#include "Test.h"
+
+
+namespace Silex
+{
+    // 専用プールから確保される型
+    struct PooledObject
+    {
+        PooledObject(uint64 value) : value(value) {}
+
+        uint64 value;
+        uint64 padding[3] = {};
+    };
+
+    SL_USE_OBJECT_POOL(PooledObject)
+
+
+    //==================================================================
+    // テスト
+    //==================================================================
+    SL_TEST(ObjectPool_ForEach)
+    {
+        ObjectPool<PooledObject>& pool = ObjectPool<PooledObject>::Get();
+
+        std::vector<PooledObject*> objects;
+        for (uint64 i = 0; i < 1000; i++)
+        {
+            objects.push_back(Memory::Allocate<PooledObject>(i));
+        }
+
+        uint64 count = 0;
+        uint64 sum   = 0;
+        pool.ForEach([&](PooledObject& object) { count++; sum += object.value; });
+
+        SL_EXPECT(count == 1000);
+        SL_EXPECT(sum   == 1000 * 999 / 2);
+
+        // 半分を解放すると、残りのみ走査される
+        for (uint64 i = 0; i < 1000; i += 2)
+        {
+            Memory::Deallocate(objects[i]);
+        }
+
+        count = 0;
+        pool.ForEach([&](PooledObject& object) { count++; SL_EXPECT(object.value % 2 == 1); });
+        SL_EXPECT(count == 500);
+
+        for (uint64 i = 1; i < 1000; i += 2)
+        {
+            Memory::Deallocate(objects[i]);
+        }
+
+        SL_EXPECT(pool.GetStatus().numObjects == 0);
+    }
+
+    SL_TEST(ObjectPool_ForeignObject)
+    {
+        // プール外に構築されたオブジェクトを Memory::Deallocate しても、プールに触れずに確保元へ返すこと
+        ObjectPool<PooledObject>& pool = ObjectPool<PooledObject>::Get();
+
+        PooledObject* pooled = Memory::Allocate<PooledObject>(1);
+
+        void*         storage = Memory::AllocateBytes(sizeof(PooledObject), alignof(PooledObject));
+        PooledObject* foreign = Memory::Construct<PooledObject>(storage, 2);
+        SL_EXPECT(!ObjectPoolBase::Contains(foreign));
+
+        Memory::Deallocate(foreign);
+
+        uint64 count = 0;
+        pool.ForEach([&](PooledObject& object) { count++; SL_EXPECT(object.value == 1); });
+
+        SL_EXPECT(count == 1);
+        SL_EXPECT(pool.GetStatus().numObjects == 1);
+
+        Memory::Deallocate(pooled);
+        SL_EXPECT(pool.GetStatus().numObjects == 0);
+    }
+
+    SL_TEST(ObjectPool_ConcurrentForEach)
+    {
+        // 他のスレッドの確保・解放と並行して走査しても、構築済みのオブジェクトのみが見えること
+        static constexpr uint64 magic = 0x5111'e700'0000'0000ull;
+
+        ObjectPool<PooledObject>& pool = ObjectPool<PooledObject>::Get();
+
+        std::atomic<bool>        running = true;
+        std::vector<std::thread> threads;
+
+        for (uint32 t = 0; t < 4; t++)
+        {
+            threads.emplace_back([&running, t]()
+            {
+                std::vector<PooledObject*> objects;
+                for (uint32 i = 0; running.load(std::memory_order_relaxed) || i < 1000; i++)
+                {
+                    objects.push_back(Memory::Allocate<PooledObject>(magic | t));
+                    if (objects.size() > 64)
+                    {
+                        Memory::Deallocate(objects[i % objects.size()]);
+                        objects[i % objects.size()] = objects.back();
+                        objects.pop_back();
+                    }
+                }
+
+                for (PooledObject* object : objects)
+                {
+                    Memory::Deallocate(object);
+                }
+            });
+        }
+
+        bool constructed = true;
+        for (uint32 i = 0; i < 200; i++)
+        {
+            pool.ForEach([&](PooledObject& object) { constructed &= (object.value & ~0xffull) == magic; });
+        }
+
+        running = false;
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        SL_EXPECT(constructed);
+        SL_EXPECT(pool.GetStatus().numObjects == 0);
+    }
+}
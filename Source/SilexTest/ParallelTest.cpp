@@ -0,0 +1,239 @@
+
+#include "PCH.h"
+
+#include "Test.h"
+#include "Core/Parallel.h"
+
+#include <numeric>
+#include <random>
+
+
+namespace Silex
+{
+    //==================================================================
+    // テスト
+    //==================================================================
+    SL_TEST(Parallel_ForReduceScan)
+    {
+        std::mt19937_64 random(1);
+
+        for (uint64 count : { 0ull, 1ull, 1000ull, 100'000ull })
+        {
+            std::vector<uint64> values(count);
+            for (uint64& value : values)
+            {
+                value = random() % 1000;
+            }
+
+            std::vector<uint64> squared(count);
+            ParallelFor(0, count, [&](uint64 i) { squared[i] = values[i] * values[i]; });
+
+            bool forMatched = true;
+            for (uint64 i = 0; i < count; i++)
+            {
+                forMatched &= squared[i] == values[i] * values[i];
+            }
+
+            SL_EXPECT(forMatched);
+
+            uint64 sum = ParallelReduce<uint64>(0, count, 0, [&](uint64 i) { return values[i]; }, std::plus<uint64>());
+            SL_EXPECT(sum == std::accumulate(values.begin(), values.end(), 0ull));
+
+            std::vector<uint64> scanned(count);
+            std::vector<uint64> expected(count);
+            ParallelExclusiveScan(values.data(), scanned.data(), count, (uint64)5);
+            std::exclusive_scan(values.begin(), values.end(), expected.begin(), (uint64)5);
+            SL_EXPECT(scanned == expected);
+        }
+    }
+
+    SL_TEST(Parallel_RadixSort)
+    {
+        std::mt19937_64 random(2);
+
+        for (uint64 count : { 0ull, 1ull, 7ull, 1000ull, 4097ull, 100'000ull })
+        {
+            // 32bit キー + ペイロード
+            std::vector<uint32> keys(count);
+            std::vector<uint32> payload(count);
+            for (uint64 i = 0; i < count; i++)
+            {
+                keys[i]    = (uint32)random();
+                payload[i] = (uint32)i;
+            }
+
+            std::vector<uint32> original = keys;
+            ParallelRadixSort(keys.data(), payload.data(), count);
+
+            bool sorted = true;
+            for (uint64 i = 0; i < count; i++)
+            {
+                sorted &= original[payload[i]] == keys[i];
+                sorted &= i == 0 || keys[i - 1] <= keys[i];
+            }
+
+            SL_EXPECT(sorted);
+
+            // 上位の桁のみが異なる 64bit キー（下位の桁のパスは飛ばされる）で、安定であること
+            std::vector<uint64> wideKeys(count);
+            for (uint64 i = 0; i < count; i++)
+            {
+                wideKeys[i] = (random() % 16) << 40;
+                payload[i]  = (uint32)i;
+            }
+
+            ParallelRadixSort(wideKeys.data(), payload.data(), count);
+
+            bool stable = true;
+            for (uint64 i = 1; i < count; i++)
+            {
+                stable &= wideKeys[i - 1] <= wideKeys[i];
+                stable &= wideKeys[i - 1] != wideKeys[i] || payload[i - 1] < payload[i];
+            }
+
+            SL_EXPECT(stable);
+        }
+    }
+
+
+    //==================================================================
+    // ベンチマーク: For / Reduce / ExclusiveScan（1k / 100k / 1M）と直列の比較
+    //==================================================================
+    static std::string MakeCountLabel(uint64 count, const char* name)
+    {
+        return std::to_string(count) + " elements " + name;
+    }
+
+    SL_BENCHMARK(Parallel_ForReduceScan)
+    {
+        std::mt19937_64 random(4);
+
+        for (uint64 count : { 1'000ull, 100'000ull, 1'000'000ull })
+        {
+            std::vector<float> values(count);
+            for (float& value : values)
+            {
+                value = (float)(random() % 1000) * 0.01f;
+            }
+
+            std::vector<float> output(count);
+
+            // For: 要素毎の独立した計算
+            double serialForTime = Test::MeasureBest(5, [&]()
+            {
+                for (uint64 i = 0; i < count; i++)
+                {
+                    output[i] = std::sqrt(values[i]) * values[i] + 1.0f;
+                }
+            });
+
+            double parallelForTime = Test::MeasureBest(5, [&]()
+            {
+                ParallelFor(0, count, [&](uint64 i) { output[i] = std::sqrt(values[i]) * values[i] + 1.0f; });
+            });
+
+            SL_EXPECT(count == 0 || output[count - 1] == std::sqrt(values[count - 1]) * values[count - 1] + 1.0f);
+
+            Test::ReportBenchmark(MakeCountLabel(count, "serial for").c_str(),  serialForTime,   count);
+            Test::ReportBenchmark(MakeCountLabel(count, "ParallelFor").c_str(), parallelForTime, count, serialForTime);
+
+            // Reduce: 合計（浮動小数点の結合順で結果が変わらないよう、整数で集計する）
+            uint64 serialSum   = 0;
+            uint64 parallelSum = 0;
+
+            double accumulateTime = Test::MeasureBest(5, [&]()
+            {
+                serialSum = std::accumulate(values.begin(), values.end(), 0ull, [](uint64 sum, float value) { return sum + (uint64)(value * 100.0f); });
+            });
+
+            double parallelReduceTime = Test::MeasureBest(5, [&]()
+            {
+                parallelSum = ParallelReduce<uint64>(0, count, 0, [&](uint64 i) { return (uint64)(values[i] * 100.0f); }, std::plus<uint64>());
+            });
+
+            SL_EXPECT(serialSum == parallelSum);
+
+            Test::ReportBenchmark(MakeCountLabel(count, "std::accumulate").c_str(), accumulateTime,     count);
+            Test::ReportBenchmark(MakeCountLabel(count, "ParallelReduce").c_str(),  parallelReduceTime, count, accumulateTime);
+
+            // ExclusiveScan: 接頭辞和
+            std::vector<uint64> integers(count);
+            for (uint64 i = 0; i < count; i++)
+            {
+                integers[i] = (uint64)(values[i] * 100.0f);
+            }
+
+            std::vector<uint64> serialScan(count);
+            std::vector<uint64> parallelScan(count);
+
+            double exclusiveScanTime = Test::MeasureBest(5, [&]()
+            {
+                std::exclusive_scan(integers.begin(), integers.end(), serialScan.begin(), 0ull);
+            });
+
+            double parallelScanTime = Test::MeasureBest(5, [&]()
+            {
+                ParallelExclusiveScan(integers.data(), parallelScan.data(), count, (uint64)0);
+            });
+
+            SL_EXPECT(serialScan == parallelScan);
+
+            Test::ReportBenchmark(MakeCountLabel(count, "std::exclusive_scan").c_str(),   exclusiveScanTime, count);
+            Test::ReportBenchmark(MakeCountLabel(count, "ParallelExclusiveScan").c_str(), parallelScanTime,  count, exclusiveScanTime);
+        }
+    }
+
+
+    //==================================================================
+    // ベンチマーク: 基数ソート（1k / 100k / 1M）と std::sort（直列）の比較
+    //==================================================================
+    template<typename Key>
+    static void MeasureRadixSort(const char* keyName, uint64 count, Key keyMask)
+    {
+        std::mt19937_64  random(3);
+        std::vector<Key> source(count);
+        for (Key& key : source)
+        {
+            key = (Key)random() & keyMask;
+        }
+
+        std::vector<Key> keys;
+
+        double serialTime = Test::MeasureBest(5, [&]()
+        {
+            keys = source;
+            std::sort(keys.begin(), keys.end());
+        });
+
+        double copyTime = Test::MeasureBest(5, [&]()
+        {
+            keys = source;
+        });
+
+        double parallelTime = Test::MeasureBest(5, [&]()
+        {
+            keys = source;
+            ParallelRadixSort(keys.data(), count);
+        });
+
+        // 入力のコピーは両方に含まれるので差し引く
+        serialTime   = std::max(serialTime   - copyTime, 0.0001);
+        parallelTime = std::max(parallelTime - copyTime, 0.0001);
+
+        std::string label = std::string(keyName) + " " + std::to_string(count) + " keys ";
+        Test::ReportBenchmark((label + "std::sort").c_str(),         serialTime,   count);
+        Test::ReportBenchmark((label + "ParallelRadixSort").c_str(), parallelTime, count, serialTime);
+    }
+
+    SL_BENCHMARK(Parallel_RadixSort)
+    {
+        for (uint64 count : { 1'000ull, 100'000ull, 1'000'000ull })
+        {
+            MeasureRadixSort<uint32>("uint32", count, ~0u);
+            MeasureRadixSort<uint64>("uint64", count, ~0ull);
+        }
+
+        // 同じ値の桁が多いキー（ソートキーの上位ビットが未使用の場合など）
+        MeasureRadixSort<uint64>("uint64 (16bit range)", 1'000'000, 0xffff);
+    }
+}
@@ -0,0 +1,191 @@
+#include "PCH.h"
+
+#include "Test.h"
+#include "Rendering/RenderThread.h"
+
+
+namespace Silex
+{
+    // 一定量の計算を行う（シミュレーション・GL 発行の代わり）
+    // 終了時刻まで待つのではなく計算量を固定し、CPU を奪い合った場合はその分遅くなるようにする
+    static uint64 Spin(uint64 numIterations)
+    {
+        volatile uint64 value = 1;
+        for (uint64 i = 0; i < numIterations; i++)
+        {
+            value = value * 6364136223846793005ull + 1442695040888963407ull;
+        }
+
+        return value;
+    }
+
+    // 1μs あたりの反復回数（初回に計測する）
+    static uint64 GetIterationsPerMicrosecond()
+    {
+        static uint64 iterations = []()
+        {
+            static constexpr uint64 numIterations = 10'000'000;
+            double milliseconds = Test::MeasureBest(3, []() { Spin(numIterations); });
+            return std::max<uint64>((uint64)(numIterations / (milliseconds * 1000.0)), 1);
+        }();
+
+        return iterations;
+    }
+
+    static void BusyWork(uint64 microseconds)
+    {
+        Spin(microseconds * GetIterationsPerMicrosecond());
+    }
+
+
+    //==================================================================
+    // テスト
+    //==================================================================
+    SL_TEST(RenderThread_DoubleBuffer)
+    {
+        // 記録先を入れ替えながら送っても、全フレームのコマンドが記録順に 1度ずつ実行されること
+        static constexpr uint32 numFrames   = 200;
+        static constexpr uint32 numCommands = 100;
+
+        TaskQueue queues[2];
+        queues[0].Init();
+        queues[1].Init();
+
+        // レンダースレッドのみが書き込む
+        std::vector<uint32> executed;
+        executed.reserve(numFrames * numCommands);
+
+        RenderThread renderThread;
+        renderThread.Start(nullptr, nullptr);
+
+        uint32 recordIndex = 0;
+        for (uint32 frame = 0; frame < numFrames; frame++)
+        {
+            for (uint32 i = 0; i < numCommands; i++)
+            {
+                queues[recordIndex].Enqueue("command", [&executed, value = frame * numCommands + i]() { executed.push_back(value); });
+            }
+
+            renderThread.Submit(&queues[recordIndex]);
+            recordIndex ^= 1;
+        }
+
+        renderThread.Stop();
+
+        bool inOrder = executed.size() == numFrames * numCommands;
+        for (uint32 i = 0; inOrder && i < executed.size(); i++)
+        {
+            inOrder = executed[i] == i;
+        }
+
+        SL_EXPECT(inOrder);
+        SL_EXPECT(!renderThread.IsRunning());
+
+        queues[0].Release();
+        queues[1].Release();
+    }
+
+    SL_TEST(RenderThread_GLThreadOwnership)
+    {
+        // コンテキストを移している間は、レンダースレッドだけが GL スレッドとして扱われること
+        TaskQueue queue;
+        queue.Init();
+
+        std::atomic<bool> renderThreadIsGL = false;
+        queue.Enqueue("check", [&renderThreadIsGL]() { renderThreadIsGL = RenderThread::IsGLThread(); });
+
+        SL_EXPECT(RenderThread::IsGLThread());
+
+        RenderThread renderThread;
+        renderThread.Start([](void*) {}, nullptr);
+
+        SL_EXPECT(!RenderThread::IsGLThread());
+
+        renderThread.Submit(&queue);
+        renderThread.Stop();
+
+        SL_EXPECT(renderThreadIsGL);
+        SL_EXPECT(RenderThread::IsGLThread());
+
+        queue.Release();
+    }
+
+
+    //==================================================================
+    // ベンチマーク: シミュレーションとレンダーコマンド実行の重ね合わせ
+    //------------------------------------------------------------------
+    // 1フレーム = シミュレーション（メインスレッド）+ レンダーコマンドの記録・実行
+    // 同一スレッドで実行すると フレーム時間 = sim + render、レンダースレッドで
+    // 前フレームのキューを実行すると max(sim, render) に近づく
+    //==================================================================
+    static void MeasureOverlap(uint64 simMicroseconds, uint64 renderMicroseconds)
+    {
+        static constexpr uint32 numFrames   = 60;
+        static constexpr uint32 numCommands = 64;
+
+        TaskQueue queues[2];
+        queues[0].Init();
+        queues[1].Init();
+
+        uint64 commandMicroseconds = renderMicroseconds / numCommands;
+
+        auto recordFrame = [&](TaskQueue& queue)
+        {
+            BusyWork(simMicroseconds);
+
+            for (uint32 i = 0; i < numCommands; i++)
+            {
+                queue.Enqueue("draw", [commandMicroseconds]() { BusyWork(commandMicroseconds); });
+            }
+        };
+
+        double serialTime = Test::MeasureBest(3, [&]()
+        {
+            for (uint32 frame = 0; frame < numFrames; frame++)
+            {
+                recordFrame(queues[0]);
+                queues[0].Execute();
+            }
+        });
+
+        RenderThread renderThread;
+        uint64       fenceWaitTime = 0;
+
+        double threadedTime = Test::MeasureBest(3, [&]()
+        {
+            renderThread.Start(nullptr, nullptr);
+
+            uint32 recordIndex = 0;
+            fenceWaitTime      = 0;
+
+            for (uint32 frame = 0; frame < numFrames; frame++)
+            {
+                recordFrame(queues[recordIndex]);
+
+                // 前フレームの実行完了を待ってから（フェンス）渡し、記録先を入れ替える
+                renderThread.Submit(&queues[recordIndex]);
+                recordIndex ^= 1;
+
+                fenceWaitTime += renderThread.GetFenceWaitTime();
+            }
+
+            renderThread.Stop();
+        });
+
+        queues[0].Release();
+        queues[1].Release();
+
+        std::string label = "sim " + std::to_string(simMicroseconds / 1000) + " ms + render " + std::to_string(renderMicroseconds / 1000) + " ms ";
+        Test::ReportBenchmark((label + "single thread (per frame)").c_str(), serialTime,   numFrames);
+        Test::ReportBenchmark((label + "render thread (per frame)").c_str(), threadedTime, numFrames, serialTime);
+
+        SL_LOG_INFO("  理想値 max(sim, render): {} ms / フェンス待機: {} ms/frame", std::max(simMicroseconds, renderMicroseconds) / 1000.0, fenceWaitTime / 1000.0 / numFrames);
+    }
+
+    SL_BENCHMARK(RenderThread_Overlap)
+    {
+        MeasureOverlap(4'000, 4'000);
+        MeasureOverlap(2'000, 6'000);
+        MeasureOverlap(6'000, 2'000);
+    }
+}
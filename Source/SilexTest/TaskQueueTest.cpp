@@ -0,0 +1,147 @@
+
+#include "PCH.h"
+
+#include "Test.h"
+#include "Core/TaskQueue.h"
+
+
+namespace Silex
+{
+    // 破棄された回数を数える（実行後にキャプチャが破棄されることの確認用）
+    struct DestructionCounter
+    {
+        DestructionCounter(uint32* counter) : counter(counter) {}
+        DestructionCounter(DestructionCounter&& other) noexcept : counter(other.counter) { other.counter = nullptr; }
+        ~DestructionCounter() { if (counter) (*counter)++; }
+
+        uint32* counter;
+    };
+
+    struct alignas(64) AlignedPayload
+    {
+        uint64 value = 0;
+    };
+
+
+    //==================================================================
+    // テスト
+    //==================================================================
+    SL_TEST(TaskQueue_Replay)
+    {
+        TaskQueue queue;
+        queue.Init();
+
+        std::vector<uint32> order;
+        uint32              destroyed = 0;
+        bool                aligned   = true;
+        uint32              numChunks = 0;
+
+        for (uint32 frame = 0; frame < 3; frame++)
+        {
+            order.clear();
+            destroyed = 0;
+
+            for (uint32 i = 0; i < 10'000; i++)
+            {
+                // キャプチャのサイズ・アライメントを混ぜる
+                switch (i % 4)
+                {
+                    case 0: queue.Enqueue("small", [&order, i]() { order.push_back(i); }); break;
+                    case 1: queue.Enqueue("destroy", [&order, i, counter = DestructionCounter(&destroyed)]() { order.push_back(i); }); break;
+                    case 2:
+                    {
+                        std::array<uint64, 32> large = {};
+                        large[31] = i;
+                        queue.Enqueue("large", [&order, large]() { order.push_back((uint32)large[31]); });
+                        break;
+                    }
+                    case 3:
+                    {
+                        AlignedPayload payload;
+                        payload.value = i;
+                        queue.Enqueue("aligned", [&order, &aligned, payload]()
+                        {
+                            aligned &= (reinterpret_cast<uint64>(&payload) & 63) == 0;
+                            order.push_back((uint32)payload.value);
+                        });
+                        break;
+                    }
+                }
+            }
+
+            // ムーブのみ可能なキャプチャ
+            auto moveOnly = std::make_unique<uint32>(10'001);
+            queue.Enqueue("move only", [&order, moveOnly = std::move(moveOnly)]() { order.push_back(*moveOnly); });
+
+            queue.Execute();
+
+            bool inOrder = order.size() == 10'001;
+            for (uint32 i = 0; inOrder && i < 10'000; i++)
+            {
+                inOrder = order[i] == i;
+            }
+
+            SL_EXPECT(inOrder && order.back() == 10'001);
+            SL_EXPECT(destroyed == 2'500);
+            SL_EXPECT(queue.GetStats().numCommands == 10'001);
+
+            // 2フレーム目以降はチャンクを再利用し、増えないこと
+            if (frame == 1) numChunks = queue.GetStats().numChunks;
+            if (frame == 2) SL_EXPECT(queue.GetStats().numChunks == numChunks);
+        }
+
+        SL_EXPECT(aligned);
+        queue.Release();
+    }
+
+
+    //==================================================================
+    // ベンチマーク: コマンドの記録と再生（std::vector<std::function> との比較）
+    //==================================================================
+    SL_BENCHMARK(TaskQueue_Replay)
+    {
+        static constexpr uint32 numCommands = 100'000;
+
+        uint64 sum = 0;
+        std::array<uint64, 4> payload = { 1, 2, 3, 4 };
+
+        std::vector<std::function<void()>> functions;
+        functions.reserve(numCommands);
+
+        double functionTime = Test::MeasureBest(5, [&]()
+        {
+            for (uint32 i = 0; i < numCommands; i++)
+            {
+                functions.push_back([&sum, payload, i]() { sum += payload[i & 3]; });
+            }
+
+            for (auto& function : functions)
+            {
+                function();
+            }
+
+            functions.clear();
+        });
+
+        TaskQueue queue;
+        queue.Init();
+
+        double queueTime = Test::MeasureBest(5, [&]()
+        {
+            for (uint32 i = 0; i < numCommands; i++)
+            {
+                queue.Enqueue("command", [&sum, payload, i]() { sum += payload[i & 3]; });
+            }
+
+            queue.Execute();
+        });
+
+        queue.Release();
+
+        Test::ReportBenchmark("100k commands std::vector<std::function>", functionTime, numCommands);
+        Test::ReportBenchmark("100k commands TaskQueue",                  queueTime,    numCommands, functionTime);
+
+        // 最適化で消えないように結果を使う
+        SL_EXPECT(sum != 0);
+    }
+}
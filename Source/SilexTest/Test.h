@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Core/CoreType.h"
+#include "Core/Macros.h"
+
+#include <chrono>
+
+
+//==================================================================
+// テスト・ベンチマーク ハーネス
+//------------------------------------------------------------------
+// SL_TEST / SL_BENCHMARK で定義した関数は、静的初期化時に登録される
+// テストは常に実行し、ベンチマークは -bench を指定した場合のみ実行する
+// SL_EXPECT は失敗を記録してテストを継続する（終了コードは失敗したテストの数）
+//==================================================================
+namespace Silex::Test
+{
+    using TestFunction = void(*)();
+
+    enum class TestKind
+    {
+        Test,
+        Benchmark,
+    };
+
+    struct TestRegistrar
+    {
+        TestRegistrar(const char* name, TestKind kind, TestFunction function);
+    };
+
+    void ReportFailure(const char* expression, const char* file, int32 line);
+
+    // 1回あたりの時間（ns）と、baseline を指定した場合はその何倍速いかを出力する
+    void ReportBenchmark(const char* label, double milliseconds, uint64 numOperations, double baselineMilliseconds = 0.0);
+
+    template<typename Function>
+    double MeasureMilliseconds(Function&& function)
+    {
+        auto begin = std::chrono::steady_clock::now();
+        function();
+        auto end = std::chrono::steady_clock::now();
+
+        return std::chrono::duration<double, std::milli>(end - begin).count();
+    }
+
+    // 初回のキャッシュ・ページフォルトの影響を除くため、複数回計測して最小値を返す
+    template<typename Function>
+    double MeasureBest(uint32 numRuns, Function&& function)
+    {
+        double best = MeasureMilliseconds(function);
+        for (uint32 i = 1; i < numRuns; i++)
+        {
+            double time = MeasureMilliseconds(function);
+            best = time < best ? time : best;
+        }
+
+        return best;
+    }
+}
+
+
+#define SL_TEST_DEFINE(prefix, name, kind)                                                                                            \
+    static void SL_COMBINE(prefix, name)();                                                                                           \
+    static ::Silex::Test::TestRegistrar SL_COMBINE(SL_COMBINE(prefix, Registrar_), name)(#name, kind, &SL_COMBINE(prefix, name));    \
+    static void SL_COMBINE(prefix, name)()
+
+// テストとベンチマークは同じ名前を付けられる
+#define SL_TEST(name)      SL_TEST_DEFINE(SilexTest_,      name, ::Silex::Test::TestKind::Test)
+#define SL_BENCHMARK(name) SL_TEST_DEFINE(SilexBenchmark_, name, ::Silex::Test::TestKind::Benchmark)
+
+#define SL_EXPECT(expression)                                                    \
+    do                                                                           \
+    {                                                                            \
+        if (!(expression))                                                       \
+            ::Silex::Test::ReportFailure(#expression, __FILE__, __LINE__);       \
+    }                                                                            \
+    while (0)
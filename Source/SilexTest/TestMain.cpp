@@ -0,0 +1,132 @@
+
+#include "PCH.h"
+
+#include "Test.h"
+#include "TestPlatform.h"
+#include "Core/MainThreadQueue.h"
+#include "Core/Metrics.h"
+#include "Core/Profiler.h"
+#include "Core/ThreadPool.h"
+
+#include <cstdio>
+#include <cstring>
+
+
+namespace Silex::Test
+{
+    struct TestEntry
+    {
+        const char*  name;
+        TestKind     kind;
+        TestFunction function;
+    };
+
+    // 静的初期化の順序に依存しないよう、関数内の静的変数に置く
+    static std::vector<TestEntry>& GetEntries()
+    {
+        static std::vector<TestEntry> entries;
+        return entries;
+    }
+
+    static uint32 numFailures = 0;
+
+
+    TestRegistrar::TestRegistrar(const char* name, TestKind kind, TestFunction function)
+    {
+        GetEntries().push_back({ name, kind, function });
+    }
+
+    void ReportFailure(const char* expression, const char* file, int32 line)
+    {
+        std::printf("    FAILED: %s (%s:%d)\n", expression, file, line);
+        numFailures++;
+    }
+
+    void ReportBenchmark(const char* label, double milliseconds, uint64 numOperations, double baselineMilliseconds)
+    {
+        double nanosecondsPerOperation = milliseconds * 1'000'000.0 / (double)std::max<uint64>(numOperations, 1);
+
+        if (baselineMilliseconds > 0.0)
+        {
+            std::printf("    %-52s %10.3f ms %10.1f ns/op  x%.2f\n", label, milliseconds, nanosecondsPerOperation, baselineMilliseconds / milliseconds);
+        }
+        else
+        {
+            std::printf("    %-52s %10.3f ms %10.1f ns/op\n", label, milliseconds, nanosecondsPerOperation);
+        }
+    }
+}
+
+
+//==================================================================
+// SilexTest [-bench] [名前の一部 ...]
+//------------------------------------------------------------------
+// 名前を指定した場合は、いずれかを含むテスト・ベンチマークのみ実行する
+//==================================================================
+int main(int argc, char** argv)
+{
+    using namespace Silex;
+    using namespace Silex::Test;
+
+    bool                     runBenchmarks = false;
+    std::vector<const char*> filters;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "-bench") == 0) runBenchmarks = true;
+        else                                     filters.push_back(argv[i]);
+    }
+
+    TestOS os;
+    os.Initialize();
+
+    Memory::Initialize();
+    MainThreadQueue::Initialize();
+    Profiler::Initialize();
+    Metrics::Initialize();
+    ThreadPool::Initialize();
+
+    std::printf("threads: %u workers\n", ThreadPool::GetThreadCount());
+
+    uint32 numRun        = 0;
+    uint32 numFailedTest = 0;
+
+    for (const TestEntry& entry : GetEntries())
+    {
+        if (entry.kind == TestKind::Benchmark && !runBenchmarks)
+            continue;
+
+        bool matched = filters.empty();
+        for (const char* filter : filters)
+        {
+            matched |= std::strstr(entry.name, filter) != nullptr;
+        }
+
+        if (!matched)
+            continue;
+
+        std::printf("[ RUN    ] %s\n", entry.name);
+        std::fflush(stdout);
+
+        uint32 failuresBefore = numFailures;
+        double time           = MeasureMilliseconds(entry.function);
+        bool   passed         = numFailures == failuresBefore;
+
+        std::printf("[ %s ] %s (%.1f ms)\n", passed ? "    OK" : "FAILED", entry.name, time);
+        std::fflush(stdout);
+
+        numFailedTest += passed ? 0 : 1;
+        numRun++;
+    }
+
+    ThreadPool::Finalize();
+    Metrics::Finalize();
+    Profiler::Finalize();
+    MainThreadQueue::Finalize();
+    Memory::Finalize();
+
+    os.Finalize();
+
+    std::printf("%u run, %u failed\n", numRun, numFailedTest);
+    return (int)numFailedTest;
+}
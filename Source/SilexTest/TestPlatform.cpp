@@ -0,0 +1,226 @@
+
+#include "PCH.h"
+
+#include "TestPlatform.h"
+
+#include <cstdio>
+#include <cstring>
+
+#ifndef SL_PLATFORM_WINDOWS
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+
+namespace Silex
+{
+    //==================================================================
+    // ロガー
+    //------------------------------------------------------------------
+    // Core/Logger.cpp はエディターのコンソールに依存するので、テストでは標準出力に出す
+    //==================================================================
+    void Logger::Initialize()
+    {
+    }
+
+    void Logger::Finalize()
+    {
+    }
+
+    void Logger::SetLogLevel(LogLevel level)
+    {
+        logFilter = level;
+    }
+
+    void Logger::Log(LogLevel level, const std::string& message)
+    {
+        static const char* prefixes[] = { "[FATAL] ", "[ERROR] ", "[WARN ] ", "[INFO ] ", "[TRACE] ", "[DEBUG] " };
+
+        if (level <= logFilter && level < LogLevel::Count)
+        {
+            OS::Get()->OutputConsole((uint8)level, prefixes[(uint32)level] + message + "\n");
+        }
+    }
+
+
+    //==================================================================
+    // テスト用 OS
+    //==================================================================
+    void TestOS::Initialize()
+    {
+        startTickNanoseconds = 0;
+        startTickNanoseconds = GetTickNanoseconds();
+    }
+
+    void TestOS::Finalize()
+    {
+    }
+
+    uint64 TestOS::GetLargePageSize()
+    {
+        return largePageSize;
+    }
+
+    uint64 TestOS::GetTickSeconds()
+    {
+        return GetTickNanoseconds() / 1'000;
+    }
+
+    uint64 TestOS::GetTickNanoseconds()
+    {
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        return (uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(now).count() - startTickNanoseconds;
+    }
+
+    void TestOS::Sleep(uint32 millisec)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(millisec));
+    }
+
+    void TestOS::OutputConsole(uint8 color, const std::string& message)
+    {
+        std::fputs(message.c_str(), stdout);
+    }
+
+    void TestOS::OutputDebugConsole(const std::string& message)
+    {
+        std::fputs(message.c_str(), stdout);
+    }
+
+#ifdef SL_PLATFORM_WINDOWS
+
+    void* TestOS::ReserveMemory(uint64 size, void* address)
+    {
+        return ::VirtualAlloc(address, size, MEM_RESERVE, PAGE_NOACCESS);
+    }
+
+    bool TestOS::CommitMemory(void* ptr, uint64 size)
+    {
+        return ::VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+    }
+
+    void TestOS::DecommitMemory(void* ptr, uint64 size)
+    {
+        ::VirtualFree(ptr, size, MEM_DECOMMIT);
+    }
+
+    void TestOS::ReleaseMemory(void* ptr, uint64 size)
+    {
+        ::VirtualFree(ptr, 0, MEM_RELEASE);
+    }
+
+    uint64 TestOS::GetPageSize()
+    {
+        SYSTEM_INFO info;
+        ::GetSystemInfo(&info);
+
+        return info.dwPageSize;
+    }
+
+    void* TestOS::AllocateLargePages(uint64 size, void* address)
+    {
+        if (largePageSize == 0)
+            return nullptr;
+
+        // SeLockMemoryPrivilege が無い場合は失敗する（呼び出し側は通常のページにフォールバックする）
+        return ::VirtualAlloc(address, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+    }
+
+    bool TestOS::EnableLargePages(bool enable)
+    {
+        largePageSize = enable ? ::GetLargePageMinimum() : 0;
+        return largePageSize != 0;
+    }
+
+#else
+
+    void* TestOS::ReserveMemory(uint64 size, void* address)
+    {
+        static constexpr uint64 granularity = 64 * 1024;
+        static constexpr int32  flags       = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+
+        // VirtualAlloc と同様に、アドレスを指定した場合はその位置に予約できなければ失敗する
+        if (address)
+        {
+            void* result = ::mmap(address, size, PROT_NONE, flags | MAP_FIXED_NOREPLACE, -1, 0);
+            return result == MAP_FAILED ? nullptr : result;
+        }
+
+        // VirtualAlloc の割り当て粒度（64KB）に揃えるため、余分に予約して前後を返却する
+        byte* region = static_cast<byte*>(::mmap(nullptr, size + granularity, PROT_NONE, flags, -1, 0));
+        if (region == MAP_FAILED)
+            return nullptr;
+
+        byte*  aligned = reinterpret_cast<byte*>((reinterpret_cast<uint64>(region) + granularity - 1) & ~(granularity - 1));
+        uint64 head    = aligned - region;
+
+        if (head)               ::munmap(region, head);
+        if (granularity - head) ::munmap(aligned + size, granularity - head);
+
+        return aligned;
+    }
+
+    bool TestOS::CommitMemory(void* ptr, uint64 size)
+    {
+        return ::mprotect(ptr, size, PROT_READ | PROT_WRITE) == 0;
+    }
+
+    void TestOS::DecommitMemory(void* ptr, uint64 size)
+    {
+        ::madvise(ptr, size, MADV_DONTNEED);
+        ::mprotect(ptr, size, PROT_NONE);
+    }
+
+    void TestOS::ReleaseMemory(void* ptr, uint64 size)
+    {
+        ::munmap(ptr, size);
+    }
+
+    uint64 TestOS::GetPageSize()
+    {
+        return (uint64)::sysconf(_SC_PAGESIZE);
+    }
+
+    void* TestOS::AllocateLargePages(uint64 size, void* address)
+    {
+        if (largePageSize == 0)
+            return nullptr;
+
+        int32 flags  = MAP_PRIVATE | MAP_ANONYMOUS | (address ? MAP_FIXED_NOREPLACE : 0);
+        void* result = ::mmap(address, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (result == MAP_FAILED)
+            return nullptr;
+
+        // MEM_LARGE_PAGES と同様に確保時点で物理メモリを割り当てる（ページ毎に 1度書き込んで Huge Page を確定させる）
+        ::madvise(result, size, MADV_HUGEPAGE);
+        for (uint64 offset = 0; offset < size; offset += largePageSize)
+        {
+            static_cast<volatile byte*>(result)[offset] = 0;
+        }
+
+        return result;
+    }
+
+    bool TestOS::EnableLargePages(bool enable)
+    {
+        // Transparent Huge Pages が madvise で使用できる場合のみ（ページサイズは x86-64 の 2MB）
+        largePageSize = 0;
+        if (enable)
+        {
+            FILE* file = std::fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+            if (file)
+            {
+                char mode[128] = {};
+                std::fgets(mode, sizeof(mode), file);
+                std::fclose(file);
+
+                if (std::strstr(mode, "[never]") == nullptr)
+                    largePageSize = 2 * 1024 * 1024;
+            }
+        }
+
+        return largePageSize != 0;
+    }
+
+#endif
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Core/OS.h"
+
+
+namespace Silex
+{
+    //==================================================================
+    // テスト用 OS
+    //------------------------------------------------------------------
+    // ウィンドウ・DLL を使わず、Core が必要とする時間と仮想メモリのみ実装する
+    // ThreadSanitizer でビルドできるように、Windows 以外（POSIX）にも対応する
+    //==================================================================
+    class TestOS : public OS
+    {
+    public:
+
+        void Initialize() override;
+        void Finalize()   override;
+        void Run()        override {}
+
+        // 時間
+        uint64 GetTickSeconds()       override;
+        uint64 GetTickNanoseconds()   override;
+        void   Sleep(uint32 millisec) override;
+
+        // 仮想メモリ
+        void*  ReserveMemory(uint64 size, void* address = nullptr) override;
+        bool   CommitMemory(void* ptr, uint64 size)                override;
+        void   DecommitMemory(void* ptr, uint64 size)              override;
+        void   ReleaseMemory(void* ptr, uint64 size)               override;
+        uint64 GetPageSize()                                       override;
+
+        // ラージページは EnableLargePages で有効にした間のみ使用する（POSIX では Transparent Huge Pages）
+        void*  AllocateLargePages(uint64 size, void* address = nullptr) override;
+        uint64 GetLargePageSize()                                       override;
+        bool   EnableLargePages(bool enable);
+
+        // ファイル
+        std::string OpenFile(const char* filter = "All\0*.*\0")                                  override { return {}; }
+        std::string SaveFile(const char* filter = "All\0*.*\0", const char* extention = nullptr) override { return {}; }
+
+        // コンソール
+        void SetConsoleAttribute(uint16 color)                      override {}
+        void OutputConsole(uint8 color, const std::string& message) override;
+        void OutputDebugConsole(const std::string& message)         override;
+
+        // メッセージ
+        int32 Message(OSMessageType type, const std::wstring& message) override { return 0; }
+
+    private:
+
+        uint64 startTickNanoseconds = 0;
+        uint64 largePageSize        = 0;
+    };
+}
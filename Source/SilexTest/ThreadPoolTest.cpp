@@ -0,0 +1,277 @@
+
+#include "PCH.h"
+
+#include "Test.h"
+#include "Core/ThreadPool.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+
+namespace Silex
+{
+    //==================================================================
+    // 比較用 単一ミューテックスのスレッドプール
+    //------------------------------------------------------------------
+    // ワークスティーリング以前の ThreadPool と同じ構成
+    // （std::function のキューを 1つのミューテックスと条件変数で共有する）
+    //==================================================================
+    class MutexThreadPool
+    {
+    public:
+
+        explicit MutexThreadPool(uint32 numThreads)
+        {
+            for (uint32 i = 0; i < numThreads; i++)
+            {
+                threads.emplace_back([this]() { ThreadLoop(); });
+            }
+        }
+
+        ~MutexThreadPool()
+        {
+            {
+                std::scoped_lock lock(mutex);
+                running = false;
+            }
+
+            condition.notify_all();
+
+            for (std::thread& thread : threads)
+            {
+                thread.join();
+            }
+        }
+
+        void AddTask(std::function<void()>&& task)
+        {
+            {
+                std::scoped_lock lock(mutex);
+                tasks.push_back(std::move(task));
+                pending++;
+            }
+
+            condition.notify_one();
+        }
+
+        void WaitAll()
+        {
+            std::unique_lock lock(mutex);
+            finished.wait(lock, [this]() { return pending == 0; });
+        }
+
+    private:
+
+        void ThreadLoop()
+        {
+            while (true)
+            {
+                std::function<void()> task;
+                {
+                    std::unique_lock lock(mutex);
+                    condition.wait(lock, [this]() { return !tasks.empty() || !running; });
+
+                    if (!running && tasks.empty())
+                        return;
+
+                    task = std::move(tasks.front());
+                    tasks.pop_front();
+                }
+
+                task();
+
+                std::scoped_lock lock(mutex);
+                if (--pending == 0)
+                {
+                    finished.notify_all();
+                }
+            }
+        }
+
+        std::mutex                        mutex;
+        std::condition_variable           condition;
+        std::condition_variable           finished;
+        std::deque<std::function<void()>> tasks;
+        std::vector<std::thread>          threads;
+        uint64                            pending = 0;
+        bool                              running = true;
+    };
+
+
+    //==================================================================
+    // テスト
+    //==================================================================
+    SL_TEST(ThreadPool_TinyTasks)
+    {
+        static constexpr uint32 numTasks = 100'000;
+
+        std::atomic<uint64> sum = 0;
+        TaskCounter         counter;
+
+        for (uint32 i = 0; i < numTasks; i++)
+        {
+            ThreadPool::AddTask([&sum, i]() { sum.fetch_add(i, std::memory_order_relaxed); }, counter);
+        }
+
+        ThreadPool::Wait(counter);
+
+        SL_EXPECT(counter.IsDone());
+        SL_EXPECT(sum == (uint64)numTasks * (numTasks - 1) / 2);
+    }
+
+    SL_TEST(ThreadPool_NestedTasks)
+    {
+        // ワーカー内から追加したタスク（自身のキューに積まれ、他のワーカーに盗まれる）も全て実行されること
+        static constexpr uint32 numOuter = 64;
+        static constexpr uint32 numInner = 256;
+
+        std::atomic<uint32> executed = 0;
+        TaskCounter         counter;
+
+        for (uint32 i = 0; i < numOuter; i++)
+        {
+            ThreadPool::AddTask([&executed, &counter]()
+            {
+                for (uint32 j = 0; j < numInner; j++)
+                {
+                    ThreadPool::AddTask([&executed]() { executed.fetch_add(1, std::memory_order_relaxed); }, counter);
+                }
+
+                executed.fetch_add(1, std::memory_order_relaxed);
+            }, counter);
+        }
+
+        ThreadPool::Wait(counter);
+
+        SL_EXPECT(executed == numOuter * (numInner + 1));
+    }
+
+    SL_TEST(ThreadPool_WaitAll)
+    {
+        std::atomic<uint32> executed = 0;
+        for (uint32 i = 0; i < 1000; i++)
+        {
+            ThreadPool::AddTask([&executed]() { executed.fetch_add(1, std::memory_order_relaxed); });
+        }
+
+        ThreadPool::WaitAll();
+
+        SL_EXPECT(executed == 1000);
+        SL_EXPECT(ThreadPool::GetPendingTaskCount() == 0);
+    }
+
+
+    //==================================================================
+    // ベンチマーク: 10万個の小さなタスク（単一ミューテックスのプールとの比較）
+    //==================================================================
+    SL_BENCHMARK(ThreadPool_TinyTasks)
+    {
+        static constexpr uint32 numTasks = 100'000;
+
+        std::atomic<uint64> sum = 0;
+
+        double mutexTime = 0.0;
+        {
+            MutexThreadPool pool(ThreadPool::GetThreadCount());
+            mutexTime = Test::MeasureBest(3, [&]()
+            {
+                for (uint32 i = 0; i < numTasks; i++)
+                {
+                    pool.AddTask([&sum, i]() { sum.fetch_add(i, std::memory_order_relaxed); });
+                }
+
+                pool.WaitAll();
+            });
+        }
+
+        double poolTime = Test::MeasureBest(3, [&]()
+        {
+            TaskCounter counter;
+            for (uint32 i = 0; i < numTasks; i++)
+            {
+                ThreadPool::AddTask([&sum, i]() { sum.fetch_add(i, std::memory_order_relaxed); }, counter);
+            }
+
+            ThreadPool::Wait(counter);
+        });
+
+        // ワーカー内から追加する場合（自身のキューに積むので共有キューを経由しない）
+        double nestedTime = Test::MeasureBest(3, [&]()
+        {
+            TaskCounter counter;
+            for (uint32 i = 0; i < 100; i++)
+            {
+                ThreadPool::AddTask([&sum, &counter]()
+                {
+                    for (uint32 j = 0; j < numTasks / 100; j++)
+                    {
+                        ThreadPool::AddTask([&sum, j]() { sum.fetch_add(j, std::memory_order_relaxed); }, counter);
+                    }
+                }, counter);
+            }
+
+            ThreadPool::Wait(counter);
+        });
+
+        Test::ReportBenchmark("100k tasks mutex + deque + std::function", mutexTime,  numTasks);
+        Test::ReportBenchmark("100k tasks ThreadPool",                    poolTime,   numTasks, mutexTime);
+        Test::ReportBenchmark("100k tasks ThreadPool (from workers)",     nestedTime, numTasks, mutexTime);
+    }
+
+
+    //==================================================================
+    // ベンチマーク: タスク 1つあたりの追加・実行コスト（キャプチャのサイズ別）
+    //------------------------------------------------------------------
+    // std::function は小さなキャプチャ以外でヒープ確保が発生するが、
+    // ThreadPool はスロットにそのまま格納するので確保が発生しない
+    //==================================================================
+    template<uint64 CaptureSize>
+    static void MeasureTaskOverhead(MutexThreadPool& mutexPool)
+    {
+        static constexpr uint32 numTasks = 100'000;
+
+        struct Payload
+        {
+            uint64 values[CaptureSize / sizeof(uint64)] = {};
+        };
+
+        std::atomic<uint64> sum = 0;
+        Payload             payload;
+        payload.values[0] = 1;
+
+        double mutexTime = Test::MeasureBest(3, [&]()
+        {
+            for (uint32 i = 0; i < numTasks; i++)
+            {
+                mutexPool.AddTask([&sum, payload]() { sum.fetch_add(payload.values[0], std::memory_order_relaxed); });
+            }
+
+            mutexPool.WaitAll();
+        });
+
+        double poolTime = Test::MeasureBest(3, [&]()
+        {
+            TaskCounter counter;
+            for (uint32 i = 0; i < numTasks; i++)
+            {
+                ThreadPool::AddTask([&sum, payload]() { sum.fetch_add(payload.values[0], std::memory_order_relaxed); }, counter);
+            }
+
+            ThreadPool::Wait(counter);
+        });
+
+        std::string label = std::to_string(CaptureSize + sizeof(void*)) + " byte capture ";
+        Test::ReportBenchmark((label + "std::function").c_str(), mutexTime, numTasks);
+        Test::ReportBenchmark((label + "ThreadPool").c_str(),    poolTime,  numTasks, mutexTime);
+    }
+
+    SL_BENCHMARK(ThreadPool_TaskOverhead)
+    {
+        MutexThreadPool mutexPool(ThreadPool::GetThreadCount());
+
+        MeasureTaskOverhead<8>(mutexPool);
+        MeasureTaskOverhead<24>(mutexPool);
+        MeasureTaskOverhead<40>(mutexPool);
+    }
+}
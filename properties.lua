@@ -238,3 +238,130 @@ project "Silex"
             "/DELAYLOAD:assimp-vc143-mt.dll",
             "/DELAYLOAD:shaderc_shared.dll",
         }
+
+
+--==================================================
+-- テスト・ベンチマーク
+--==================================================
+-- Core（メモリ・スレッドプール・キューなど）の単体テストとベンチマーク
+-- SilexTest.exe [-bench] [名前の一部 ...]
+--
+-- ThreadSanitizer は MSVC が対応していないので、Windows 以外で gmake2 から生成してビルドする
+-- （エンジンが std::format を使用するので、GCC 13 / Clang 17 以降が必要）
+-- premake5 gmake2 --file=properties.lua --sanitize=thread && make SilexTest config=debug
+--==================================================
+newoption
+{
+    trigger     = "sanitize",
+    value       = "TYPE",
+    description = "SilexTest をサニタイザー付きでビルドする",
+    allowed     =
+    {
+        { "address", "AddressSanitizer" },
+        { "thread",  "ThreadSanitizer（Windows 以外）" },
+    },
+}
+
+project "SilexTest"
+
+    location      "Source"
+    kind          "ConsoleApp"
+    language      "C++"
+    cppdialect    "C++20"
+    staticruntime "on"
+    characterset  "Unicode"
+
+    debugdir   "%{wks.location}"
+    targetdir  "Binary/%{cfg.buildcfg}/"
+    objdir     "Binary/%{cfg.buildcfg}/Intermediate/%{prj.name}"
+
+    pchheader "PCH.h"
+    pchsource "Source/Silex/Core/PCH/PCH.cpp"
+
+    files
+    {
+        "Source/%{prj.name}/**.h",
+        "Source/%{prj.name}/**.cpp",
+
+        -- テスト対象（エディター・描画に依存しないもののみ。OS とロガーはテスト用の実装を使う）
+        "Source/Silex/Core/PCH/PCH.cpp",
+        "Source/Silex/Core/Memory.cpp",
+        "Source/Silex/Core/MemoryPool.cpp",
+        "Source/Silex/Core/MemoryTracker.cpp",
+        "Source/Silex/Core/ObjectPool.cpp",
+        "Source/Silex/Core/TLSFHeap.cpp",
+        "Source/Silex/Core/Profiler.cpp",
+        "Source/Silex/Core/Metrics.cpp",
+        "Source/Silex/Core/ThreadPool.cpp",
+        "Source/Silex/Core/TaskQueue.cpp",
+        "Source/Silex/Core/MainThreadQueue.cpp",
+        "Source/Silex/Rendering/RenderThread.cpp",
+    }
+
+    includedirs
+    {
+        "Source/%{prj.name}/",
+        "Source/Silex/",
+        "Source/Silex/Core/PCH",
+        "Source/External",
+        "Source/External/glm",
+    }
+
+    -- Windows
+    ----------------------------------------------------
+    filter "system:windows"
+
+        systemversion "latest"
+
+        defines
+        {
+            "SL_PLATFORM_WINDOWS",
+            "NOMINMAX",
+            "_CRT_SECURE_NO_WARNINGS",
+        }
+
+        buildoptions
+        {
+            "/wd4244",
+            "/wd4267",
+            "/wd4291",
+            "/utf-8",
+            "/Zc:preprocessor",
+        }
+
+    filter { "system:windows", "options:sanitize=address" }
+
+        buildoptions { "/fsanitize=address" }
+        editandcontinue "Off"
+
+    -- Windows 以外
+    ----------------------------------------------------
+    filter "system:not windows"
+
+        links { "pthread" }
+
+    filter { "system:not windows", "options:sanitize=address" }
+
+        buildoptions { "-fsanitize=address", "-fno-omit-frame-pointer" }
+        linkoptions  { "-fsanitize=address" }
+
+    filter { "system:not windows", "options:sanitize=thread" }
+
+        buildoptions { "-fsanitize=thread" }
+        linkoptions  { "-fsanitize=thread" }
+
+    -- デバッグ
+    ----------------------------------------------------
+    filter "configurations:Debug"
+
+        defines    "SL_DEBUG"
+        symbols    "On"
+        targetname "%{prj.name}d"
+
+    -- リリース
+    ----------------------------------------------------
+    filter "configurations:Release"
+
+        defines    "SL_RELEASE"
+        optimize   "On"
+        targetname "%{prj.name}"